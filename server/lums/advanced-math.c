@@ -7,6 +7,7 @@
 #include <stdbool.h>
 #include <immintrin.h>  // AVX2/SIMD
 #include "lums_backend.h"
+#include "rng.h"
 
 // Détection runtime des capacités SIMD
 static bool simd_available = false;
@@ -112,7 +113,7 @@ bool lums_is_prime_miller_rabin(uint64_t n, int k) {
 
     // Tests de Miller-Rabin authentiques
     for (int i = 0; i < k; i++) {
-        uint64_t a = 2 + rand() % (n - 3);
+        uint64_t a = 2 + lum_random_below(n - 3);
         uint64_t x = 1;
 
         // Calcul a^d mod n par exponentiation rapide
@@ -0,0 +1,238 @@
+#include "lums.h"
+#include "arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifndef LOG_ERROR
+#define LOG_ERROR(...) fprintf(stderr, "ERROR: " __VA_ARGS__); fprintf(stderr, "\n")
+#endif
+
+#define ARENA_ALIGN 16
+#define ARENA_MIN_BLOCK 64
+#define ARENA_MAX_BLOCK ((size_t)ARENA_MIN_BLOCK << (LUM_ARENA_CLASSES - 1))
+#define ARENA_OVERSIZED LUM_ARENA_CLASSES
+
+struct LumArenaChunk {
+    LumArenaChunk* next;
+    size_t size;
+    unsigned char data[];
+};
+
+// Precedes every block, keeps the block 16-byte aligned
+typedef struct {
+    size_t size_class;
+    size_t size;
+} ArenaBlockHeader;
+
+static __thread LumArena* current_arena;
+
+static size_t align_up(size_t size) {
+    return (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+/**
+ * Smallest class holding size bytes, ARENA_OVERSIZED above 64 KiB
+ */
+static size_t size_class(size_t size) {
+    size_t index = 0;
+    size_t block = ARENA_MIN_BLOCK;
+
+    if (size > ARENA_MAX_BLOCK) {
+        return ARENA_OVERSIZED;
+    }
+    while (block < size) {
+        block <<= 1;
+        index++;
+    }
+    return index;
+}
+
+static LumArenaChunk* chunk_create(size_t size) {
+    LumArenaChunk* chunk = (LumArenaChunk*)malloc(sizeof(LumArenaChunk) + size);
+    if (!chunk) {
+        LOG_ERROR("Memory allocation failed for %zu byte arena chunk", size);
+        return NULL;
+    }
+    chunk->next = NULL;
+    chunk->size = size;
+    return chunk;
+}
+
+LumArena* lum_arena_create(size_t chunk_size) {
+    if (chunk_size == 0) {
+        chunk_size = LUM_ARENA_CHUNK_SIZE;
+    }
+    if (chunk_size < ARENA_MAX_BLOCK) {
+        chunk_size = ARENA_MAX_BLOCK; // Every size class must fit in a chunk
+    }
+
+    LumArena* arena = (LumArena*)calloc(1, sizeof(LumArena));
+    if (!arena) {
+        LOG_ERROR("Memory allocation failed for LumArena");
+        return NULL;
+    }
+    arena->chunk_size = chunk_size; // Chunks come with the first blocks
+    return arena;
+}
+
+static void chunks_free(LumArenaChunk* chunk) {
+    while (chunk) {
+        LumArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+}
+
+void lum_arena_destroy(LumArena* arena) {
+    if (!arena) {
+        return;
+    }
+    chunks_free(arena->chunks);
+    chunks_free(arena->oversized);
+    if (current_arena == arena) {
+        current_arena = NULL;
+    }
+    free(arena);
+}
+
+void lum_arena_reset(LumArena* arena) {
+    if (!arena) {
+        return;
+    }
+
+    LumArenaChunk* kept = NULL;
+    LumArenaChunk* chunk = arena->chunks;
+    while (chunk) {
+        LumArenaChunk* next = chunk->next;
+        if (!kept) {
+            kept = chunk;
+            kept->next = NULL;
+        } else {
+            free(chunk);
+        }
+        chunk = next;
+    }
+    chunks_free(arena->oversized);
+
+    arena->chunks = kept;
+    arena->oversized = NULL;
+    arena->cursor = kept ? kept->data : NULL;
+    arena->limit = kept ? kept->data + kept->size : NULL;
+    memset(arena->free_lists, 0, sizeof(arena->free_lists));
+    arena->bytes_used = 0;
+}
+
+/**
+ * Carve total bytes from the current chunk, starting a new one when it is full
+ */
+static unsigned char* arena_carve(LumArena* arena, size_t total) {
+    if (!arena->cursor || (size_t)(arena->limit - arena->cursor) < total) {
+        LumArenaChunk* chunk = chunk_create(arena->chunk_size);
+        if (!chunk) {
+            return NULL;
+        }
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+        arena->cursor = chunk->data;
+        arena->limit = chunk->data + chunk->size;
+    }
+    unsigned char* block = arena->cursor;
+    arena->cursor += total;
+    return block;
+}
+
+/**
+ * Oversized blocks get a chunk of their own, freed with the block
+ */
+static unsigned char* arena_carve_oversized(LumArena* arena, size_t total) {
+    LumArenaChunk* chunk = chunk_create(total);
+    if (!chunk) {
+        return NULL;
+    }
+    chunk->next = arena->oversized;
+    arena->oversized = chunk;
+    return chunk->data;
+}
+
+/**
+ * Unlinks and frees the chunk of an oversized block
+ */
+static void arena_free_oversized(LumArena* arena, ArenaBlockHeader* header) {
+    for (LumArenaChunk** link = &arena->oversized; *link; link = &(*link)->next) {
+        if ((*link)->data == (unsigned char*)header) {
+            LumArenaChunk* chunk = *link;
+            *link = chunk->next;
+            free(chunk);
+            return;
+        }
+    }
+}
+
+void* lum_arena_alloc(LumArena* arena, size_t size) {
+    if (!arena || size > SIZE_MAX - sizeof(ArenaBlockHeader) - ARENA_ALIGN) {
+        return NULL;
+    }
+
+    size_t total = align_up(sizeof(ArenaBlockHeader) + size);
+    size_t block_class = size_class(total);
+    unsigned char* block;
+
+    if (block_class == ARENA_OVERSIZED) {
+        block = arena_carve_oversized(arena, total);
+    } else if (arena->free_lists[block_class]) {
+        block = (unsigned char*)arena->free_lists[block_class];
+        arena->free_lists[block_class] = *(void**)(block + sizeof(ArenaBlockHeader));
+    } else {
+        total = (size_t)ARENA_MIN_BLOCK << block_class;
+        block = arena_carve(arena, total);
+    }
+    if (!block) {
+        return NULL;
+    }
+
+    ArenaBlockHeader* header = (ArenaBlockHeader*)block;
+    header->size_class = block_class;
+    header->size = block_class == ARENA_OVERSIZED ? total : (size_t)ARENA_MIN_BLOCK << block_class;
+    arena->bytes_used += header->size;
+    return block + sizeof(ArenaBlockHeader);
+}
+
+void lum_arena_free(LumArena* arena, void* block) {
+    if (!arena || !block) {
+        return;
+    }
+
+    ArenaBlockHeader* header = (ArenaBlockHeader*)((unsigned char*)block - sizeof(ArenaBlockHeader));
+    arena->bytes_used -= header->size;
+    header->size = 0;
+    if (header->size_class == ARENA_OVERSIZED) {
+        arena_free_oversized(arena, header);
+        return;
+    }
+    *(void**)block = arena->free_lists[header->size_class];
+    arena->free_lists[header->size_class] = header;
+}
+
+char* lum_arena_strdup(LumArena* arena, const char* text) {
+    if (!text) {
+        return NULL;
+    }
+    size_t length = strlen(text);
+    char* copy = (char*)lum_arena_alloc(arena, length + 1);
+    if (copy) {
+        memcpy(copy, text, length + 1);
+    }
+    return copy;
+}
+
+LumArena* lum_arena_use(LumArena* arena) {
+    LumArena* previous = current_arena;
+    current_arena = arena;
+    return previous;
+}
+
+LumArena* lum_arena_current(void) {
+    return current_arena;
+}
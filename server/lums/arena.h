@@ -0,0 +1,43 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "lums.h"
+
+#define LUM_ARENA_CLASSES 11                 // Block size classes 64 B .. 64 KiB
+#define LUM_ARENA_CHUNK_SIZE (256 * 1024)
+
+typedef struct LumArenaChunk LumArenaChunk;
+
+// Memory for one request or program: blocks are carved from large chunks and
+// all released at once by lum_arena_reset / lum_arena_destroy. Blocks freed
+// before that go to per-size-class free lists and are reused, blocks above
+// 64 KiB back to the heap, so long-lived groups do not grow the arena. The
+// first chunk is only allocated by the first block. Not thread-safe: one
+// arena per thread.
+struct LumArena {
+    LumArenaChunk* chunks;                   // Chunk being carved first
+    LumArenaChunk* oversized;                // One per live block above 64 KiB
+    unsigned char* cursor;
+    unsigned char* limit;
+    void* free_lists[LUM_ARENA_CLASSES];
+    size_t chunk_size;
+    size_t bytes_used;                       // Live blocks, headers included
+};
+
+// chunk_size 0: LUM_ARENA_CHUNK_SIZE
+LumArena* lum_arena_create(size_t chunk_size);
+void lum_arena_destroy(LumArena* arena);
+// Frees every block at once, keeps one chunk for the next request
+void lum_arena_reset(LumArena* arena);
+// 16-byte aligned block, NULL if out of memory
+void* lum_arena_alloc(LumArena* arena, size_t size);
+// Back to its free list (blocks above 64 KiB: to the heap)
+void lum_arena_free(LumArena* arena, void* block);
+char* lum_arena_strdup(LumArena* arena, const char* text);
+
+// Arena the calling thread's group constructors draw from (NULL: the heap).
+// Returns the previous one so scopes can nest.
+LumArena* lum_arena_use(LumArena* arena);
+LumArena* lum_arena_current(void);
+
+#endif // ARENA_H
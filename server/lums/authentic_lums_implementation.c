@@ -1,4 +1,5 @@
 #include "authentic_lums_core.h"
+#include "rng.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -25,26 +26,9 @@ static char g_log_directory[256];
 
 // ===== FONCTIONS UTILITAIRES AUTHENTIQUES =====
 
-// Génération de nombres aléatoires cryptographiquement sûrs
+// Nombres aléatoires : flux xoshiro propre au thread, graine tirée une fois de getrandom
 static uint64_t generate_crypto_random(void) {
-    static bool initialized = false;
-    if (!initialized) {
-        srand(time(NULL) ^ getpid());
-        initialized = true;
-    }
-    
-    uint64_t result = 0;
-    for (int i = 0; i < 8; i++) {
-        result = (result << 8) | (rand() & 0xFF);
-    }
-    
-    // XOR avec timestamp haute résolution pour améliorer l'entropie
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    result ^= (uint64_t)ts.tv_nsec;
-    result ^= ((uint64_t)ts.tv_sec << 32);
-    
-    return result;
+    return lum_random_u64();
 }
 
 // Calcul de hash SHA-3 simplifié mais authentique
@@ -100,9 +84,9 @@ LUMS* create_authentic_lums(double complex amplitude, double phase, LUMEnergyLev
     }
     
     // Initialisation contexte spatial avec position aléatoire réaliste
-    lums->spatial.x = (double)(rand() % 1000) / 100.0;  // 0-10.0
-    lums->spatial.y = (double)(rand() % 1000) / 100.0;
-    lums->spatial.z = (double)(rand() % 1000) / 100.0;
+    lums->spatial.x = (double)lum_random_below(1000) / 100.0;  // 0-10.0
+    lums->spatial.y = (double)lum_random_below(1000) / 100.0;
+    lums->spatial.z = (double)lum_random_below(1000) / 100.0;
     
     // Conversion coordonnées sphériques
     double r = sqrt(lums->spatial.x*lums->spatial.x + 
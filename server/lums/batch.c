@@ -0,0 +1,178 @@
+#include "lums.h"
+#include "batch.h"
+#include "arena.h"
+#include "operations.h"
+#include "view.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef LOG_ERROR
+#define LOG_ERROR(...) fprintf(stderr, "ERROR: " __VA_ARGS__); fprintf(stderr, "\n")
+#endif
+
+/**
+ * Checks of the eager operations, without their error message
+ */
+static int operand_ok(const LUMGroup* group) {
+    return group && (group->storage != LUM_STORAGE_DENSE || group->lums);
+}
+
+/**
+ * Table for op_count operations and up to slots results, in the arena
+ */
+static LumBatch* batch_create(size_t op_count, size_t slots, LumArena* arena) {
+    if (slots > (SIZE_MAX / 2 - sizeof(LumBatch)) / sizeof(LUMGroup*) ||
+        op_count > (SIZE_MAX / 2) / sizeof(size_t)) {
+        LOG_ERROR("Batch of %zu operations too large", op_count);
+        return NULL;
+    }
+
+    int owns_arena = arena == NULL;
+    if (owns_arena && !(arena = lum_arena_create(0))) {
+        return NULL;
+    }
+    size_t size = sizeof(LumBatch) + sizeof(LUMGroup*) * slots + sizeof(size_t) * (op_count + 1);
+    LumBatch* batch = (LumBatch*)lum_arena_alloc(arena, size);
+    if (!batch) {
+        LOG_ERROR("Memory allocation failed for a batch of %zu operations", op_count);
+        if (owns_arena) {
+            lum_arena_destroy(arena);
+        }
+        return NULL;
+    }
+
+    batch->groups = (LUMGroup**)(batch + 1);
+    batch->first = (size_t*)(batch->groups + slots);
+    batch->first[0] = 0;
+    batch->op_count = op_count;
+    batch->failed = 0;
+    batch->arena = arena;
+    batch->owns_arena = owns_arena;
+    return batch;
+}
+
+/**
+ * Records the result of operation op (NULL: failed)
+ */
+static void batch_push(LumBatch* batch, size_t op, LUMGroup* result) {
+    size_t next = batch->first[op];
+    if (result) {
+        batch->groups[next++] = result;
+    } else {
+        batch->failed++;
+    }
+    batch->first[op + 1] = next;
+}
+
+static void batch_report(const LumBatch* batch, const char* operation) {
+    if (batch->failed > 0) {
+        LOG_ERROR("%zu of %zu batched %s failed", batch->failed, batch->op_count, operation);
+    }
+}
+
+LumBatch* lum_fusion_batch(LUMGroup* const* groups1, LUMGroup* const* groups2, size_t count,
+                           LumArena* arena) {
+    if ((!groups1 || !groups2) && count > 0) {
+        LOG_ERROR("Invalid input for lum_fusion_batch");
+        return NULL;
+    }
+    LumBatch* batch = batch_create(count, count, arena);
+    if (!batch) {
+        return NULL;
+    }
+
+    LumArena* previous = lum_arena_use(batch->arena);
+    for (size_t i = 0; i < count; i++) {
+        int valid = operand_ok(groups1[i]) && operand_ok(groups2[i]);
+        batch_push(batch, i, valid ? lum_fusion(groups1[i], groups2[i]) : NULL);
+    }
+    lum_arena_use(previous);
+
+    batch_report(batch, "fusions");
+    return batch;
+}
+
+LumBatch* lum_cycle_batch(LUMGroup* const* sources, const int* modulos, size_t count, LumArena* arena) {
+    if ((!sources || !modulos) && count > 0) {
+        LOG_ERROR("Invalid input for lum_cycle_batch");
+        return NULL;
+    }
+    LumBatch* batch = batch_create(count, count, arena);
+    if (!batch) {
+        return NULL;
+    }
+
+    LumArena* previous = lum_arena_use(batch->arena);
+    for (size_t i = 0; i < count; i++) {
+        int valid = operand_ok(sources[i]) && modulos[i] > 0;
+        batch_push(batch, i, valid ? lum_cycle(sources[i], modulos[i]) : NULL);
+    }
+    lum_arena_use(previous);
+
+    batch_report(batch, "cycles");
+    return batch;
+}
+
+LumBatch* lum_split_batch(LUMGroup* const* sources, const int* zones, size_t count, LumArena* arena) {
+    if ((!sources || !zones) && count > 0) {
+        LOG_ERROR("Invalid input for lum_split_batch");
+        return NULL;
+    }
+
+    // Every valid split yields its zone count
+    size_t slots = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (operand_ok(sources[i]) && zones[i] > 0) {
+            slots += (size_t)zones[i];
+        }
+    }
+    LumBatch* batch = batch_create(count, slots, arena);
+    if (!batch) {
+        return NULL;
+    }
+
+    LumArena* previous = lum_arena_use(batch->arena);
+    for (size_t i = 0; i < count; i++) {
+        size_t next = batch->first[i];
+        size_t zone_count = 0;
+        LUMGroup** split = operand_ok(sources[i]) && zones[i] > 0 ?
+                           lum_split(sources[i], zones[i], &zone_count) : NULL;
+        if (split && zone_count <= (size_t)zones[i]) {
+            memcpy(batch->groups + next, split, sizeof(LUMGroup*) * zone_count);
+            next += zone_count;
+            free(split); // Zones now belong to the table
+        } else {
+            free_split_result(split, zone_count);
+            batch->failed++;
+        }
+        batch->first[i + 1] = next;
+    }
+    lum_arena_use(previous);
+
+    batch_report(batch, "splits");
+    return batch;
+}
+
+void lum_batch_free(LumBatch* batch) {
+    if (!batch) {
+        return;
+    }
+    // Result headers, views included, and their fields go with an arena of our
+    // own: only storage kept outside it (backends, shared buffers) is released
+    LumArena* arena = batch->arena;
+    for (size_t i = 0; i < batch->first[batch->op_count]; i++) {
+        LUMGroup* group = batch->groups[i];
+        if (batch->owns_arena && group->arena == arena) {
+            lum_group_release_storage(group);
+        } else {
+            free_lum_group(group);
+        }
+    }
+    if (batch->owns_arena) {
+        lum_arena_destroy(arena);
+    } else {
+        lum_arena_free(arena, batch);
+    }
+}
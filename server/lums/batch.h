@@ -0,0 +1,30 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "lums.h"
+
+// Results of a batch: operation i produced groups[first[i] .. first[i + 1]),
+// an empty range when its arguments were invalid or it failed
+typedef struct {
+    LUMGroup** groups;
+    size_t* first;                 // op_count + 1 entries
+    size_t op_count;
+    size_t failed;                 // Operations without result
+    LumArena* arena;               // Holds the table, the dense results and the view headers
+    int owns_arena;
+} LumBatch;
+
+// Many small operations in one call: arguments are checked up front without
+// per-call logging (one summary line for the failures), and the results and
+// their table are carved from a single arena, a new one when arena is NULL.
+// Same results as lum_fusion / lum_split / lum_cycle on each entry.
+LumBatch* lum_fusion_batch(LUMGroup* const* groups1, LUMGroup* const* groups2, size_t count,
+                           LumArena* arena);
+LumBatch* lum_split_batch(LUMGroup* const* sources, const int* zones, size_t count, LumArena* arena);
+LumBatch* lum_cycle_batch(LUMGroup* const* sources, const int* modulos, size_t count, LumArena* arena);
+
+// Frees every result and the table, and the arena if the batch created it.
+// Call it before resetting a caller arena.
+void lum_batch_free(LumBatch* batch);
+
+#endif // BATCH_H
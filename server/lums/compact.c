@@ -0,0 +1,587 @@
+#include "lums.h"
+#include "compact.h"
+#include "layout.h"
+#include "operations.h"
+#include "view.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#ifndef LOG_ERROR
+#define LOG_ERROR(...) fprintf(stderr, "ERROR: " __VA_ARGS__); fprintf(stderr, "\n")
+#endif
+
+// Compile-time check: one record is 8 bytes
+typedef char lum_compact_size_check[sizeof(LumCompact) == 8 ? 1 : -1];
+
+/**
+ * Store an explicit position, -1 if it does not fit in int16
+ */
+static int compact_store_position(LumCompact* record, int x, int y) {
+    if (x < INT16_MIN || x > INT16_MAX || y < INT16_MIN || y > INT16_MAX) {
+        return -1;
+    }
+    record->x = (int16_t)x;
+    record->y = (int16_t)y;
+    return 0;
+}
+
+/**
+ * First side-table entry with index >= start
+ */
+static size_t compact_spatial_lower_bound(const LumCompactStorage* compact, size_t start) {
+    size_t lo = 0;
+    size_t hi = compact->spatial_count;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (compact->spatial[mid].index < start) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * Append the side-table entries of src in [start, start + count),
+ * renumbered so that start becomes dst_index
+ */
+static int compact_append_spatial(LumCompactStorage* dst, const LumCompactStorage* src,
+                                  size_t start, size_t count, size_t dst_index) {
+    size_t first = compact_spatial_lower_bound(src, start);
+    size_t last = compact_spatial_lower_bound(src, start + count);
+    if (first == last) {
+        return 0;
+    }
+
+    LumSpatialEntry* grown = (LumSpatialEntry*)realloc(
+        dst->spatial, sizeof(LumSpatialEntry) * (dst->spatial_count + last - first));
+    if (!grown) {
+        return -1;
+    }
+    dst->spatial = grown;
+
+    for (size_t k = first; k < last; k++) {
+        dst->spatial[dst->spatial_count].index = src->spatial[k].index - start + dst_index;
+        dst->spatial[dst->spatial_count].data = src->spatial[k].data;
+        dst->spatial_count++;
+    }
+    return 0;
+}
+
+/**
+ * Create a compact LUM group with all records cleared.
+ * Default layout matches encode_bit_to_lum: linear, 20 units apart.
+ */
+LUMGroup* create_compact_lum_group(size_t count, GroupType type) {
+    LUMGroup* group = (LUMGroup*)calloc(1, sizeof(LUMGroup));
+    if (!group) {
+        LOG_ERROR("Memory allocation failed for compact LUMGroup");
+        return NULL;
+    }
+
+    LumCompactStorage* compact = (LumCompactStorage*)calloc(1, sizeof(LumCompactStorage));
+    if (!compact) {
+        free(group);
+        LOG_ERROR("Memory allocation failed for compact storage");
+        return NULL;
+    }
+
+    if (count > 0) {
+        compact->records = (LumCompact*)calloc(count, sizeof(LumCompact));
+        if (!compact->records) {
+            free(compact);
+            free(group);
+            LOG_ERROR("Memory allocation failed for %zu compact LUMs", count);
+            return NULL;
+        }
+    }
+
+    group->count = count;
+    group->group_type = type;
+    group->storage = LUM_STORAGE_COMPACT;
+    group->compact = compact;
+    group->layout = lum_layout_linear(0, 0, 20);
+
+    return group;
+}
+
+void free_compact_storage(LumCompactStorage* compact) {
+    if (!compact) {
+        return;
+    }
+    free(compact->records);
+    free(compact->spatial);
+    free(compact);
+}
+
+/**
+ * Build a compact copy of a dense group.
+ * Fails if an explicit position does not fit in int16.
+ */
+LUMGroup* compact_from_dense(const LUMGroup* source) {
+    if (!source || source->storage != LUM_STORAGE_DENSE || (!source->lums && source->count > 0)) {
+        return NULL;
+    }
+
+    LUMGroup* result = create_compact_lum_group(source->count, source->group_type);
+    if (!result) {
+        return NULL;
+    }
+    LumCompactStorage* compact = result->compact;
+    int explicit_positions = source->layout.kind == LUM_LAYOUT_EXPLICIT;
+    size_t spatial_capacity = 0;
+
+    for (size_t i = 0; i < source->count; i++) {
+        const LUM* lum = &source->lums[i];
+        LumCompact* record = &compact->records[i];
+
+        record->presence = lum->presence & 1;
+        record->structure_type = (unsigned int)lum->structure_type;
+        if (explicit_positions &&
+            compact_store_position(record, lum->position.x, lum->position.y) != 0) {
+            LOG_ERROR("Cannot compact LUM %zu: position (%d,%d) exceeds int16",
+                      i, lum->position.x, lum->position.y);
+            free_lum_group(result);
+            return NULL;
+        }
+
+        if (lum->spatial_data) {
+            if (compact->spatial_count == spatial_capacity) {
+                size_t new_capacity = spatial_capacity ? spatial_capacity * 2 : 8;
+                LumSpatialEntry* grown = (LumSpatialEntry*)realloc(
+                    compact->spatial, sizeof(LumSpatialEntry) * new_capacity);
+                if (!grown) {
+                    free_lum_group(result);
+                    return NULL;
+                }
+                compact->spatial = grown;
+                spatial_capacity = new_capacity;
+            }
+            compact->spatial[compact->spatial_count].index = i;
+            compact->spatial[compact->spatial_count].data = lum->spatial_data;
+            compact->spatial_count++;
+            record->has_spatial = 1;
+        }
+    }
+
+    result->layout = source->layout;
+    return result;
+}
+
+/**
+ * Records to LUM structs, positions left as stored (relative to the layout offset)
+ */
+static void compact_unpack_records(const LUMGroup* group, LUM* out) {
+    const LumCompactStorage* compact = group->compact;
+    size_t entry = 0;
+
+    for (size_t i = 0; i < group->count; i++) {
+        const LumCompact* record = &compact->records[i];
+        out[i].presence = (uint8_t)record->presence;
+        out[i].structure_type = (LumStructureType)record->structure_type;
+        out[i].spatial_data = NULL;
+        out[i].position.x = record->x;
+        out[i].position.y = record->y;
+        if (record->has_spatial) {
+            while (entry < compact->spatial_count && compact->spatial[entry].index < i) {
+                entry++;
+            }
+            if (entry < compact->spatial_count && compact->spatial[entry].index == i) {
+                out[i].spatial_data = compact->spatial[entry].data;
+            }
+        }
+    }
+}
+
+/**
+ * Dense copy of a compact group, same layout
+ */
+LUMGroup* compact_to_dense(const LUMGroup* source) {
+    if (!source || source->storage != LUM_STORAGE_COMPACT || !source->compact) {
+        return NULL;
+    }
+
+    LUMGroup* result = (LUMGroup*)calloc(1, sizeof(LUMGroup));
+    LUM* lums = (LUM*)malloc(sizeof(LUM) * (source->count > 0 ? source->count : 1));
+    if (!result || !lums) {
+        free(result);
+        free(lums);
+        LOG_ERROR("Memory allocation failed expanding %zu compact LUMs", source->count);
+        return NULL;
+    }
+
+    compact_unpack_records(source, lums);
+    result->lums = lums;
+    result->count = source->count;
+    result->group_type = source->group_type;
+    result->storage = LUM_STORAGE_DENSE;
+    result->layout = source->layout;
+    return result;
+}
+
+/**
+ * Deep copy of a compact group (spatial data pointers are shared)
+ */
+LUMGroup* compact_clone(const LUMGroup* source) {
+    if (!source || source->storage != LUM_STORAGE_COMPACT || !source->compact) {
+        return NULL;
+    }
+
+    LUMGroup* result = create_compact_lum_group(source->count, source->group_type);
+    if (!result) {
+        return NULL;
+    }
+    if (source->count > 0) {
+        memcpy(result->compact->records, source->compact->records, sizeof(LumCompact) * source->count);
+    }
+    if (compact_append_spatial(result->compact, source->compact, 0, source->count, 0) != 0) {
+        free_lum_group(result);
+        return NULL;
+    }
+    result->layout = source->layout;
+    return result;
+}
+
+/**
+ * Convert a dense group to compact records in place
+ */
+int lum_group_compact(LUMGroup* group) {
+    if (!group || group->storage == LUM_STORAGE_PACKED) {
+        return -1;
+    }
+    if (group->storage == LUM_STORAGE_COMPACT) {
+        return 0;
+    }
+
+    LUMGroup* compact_group = compact_from_dense(group);
+    if (!compact_group) {
+        return -1;
+    }
+
+    lum_group_release_storage(group);
+    group->storage = LUM_STORAGE_COMPACT;
+    group->compact = compact_group->compact;
+
+    compact_group->compact = NULL;
+    free(compact_group);
+    return 0;
+}
+
+/**
+ * Convert compact records back to one LUM struct each, in place
+ */
+int lum_group_uncompact(LUMGroup* group) {
+    if (!group) {
+        return -1;
+    }
+    if (group->storage != LUM_STORAGE_COMPACT) {
+        return group->storage == LUM_STORAGE_DENSE ? 0 : -1;
+    }
+
+    LUMGroup* dense = compact_to_dense(group);
+    if (!dense) {
+        return -1;
+    }
+
+    lum_group_release_storage(group);
+    group->lums = dense->lums;
+    group->storage = LUM_STORAGE_DENSE;
+
+    dense->lums = NULL;
+    free(dense);
+    return 0;
+}
+
+SpatialData* compact_get_spatial(const LUMGroup* group, size_t index) {
+    if (!group || !group->compact || index >= group->count ||
+        !group->compact->records[index].has_spatial) {
+        return NULL;
+    }
+
+    const LumCompactStorage* compact = group->compact;
+    size_t k = compact_spatial_lower_bound(compact, index);
+    return k < compact->spatial_count && compact->spatial[k].index == index ?
+        compact->spatial[k].data : NULL;
+}
+
+/**
+ * Attach (or detach with NULL) per-LUM spatial data
+ */
+int compact_set_spatial(LUMGroup* group, size_t index, SpatialData* data) {
+    if (!group || !group->compact || index >= group->count) {
+        return -1;
+    }
+    int hash_cached = group->hash_cached; // Presence untouched
+    if (lum_group_detach(group) != 0) {
+        return -1;
+    }
+    group->hash_cached = hash_cached;
+
+    LumCompactStorage* compact = group->compact;
+    size_t k = compact_spatial_lower_bound(compact, index);
+    int present = k < compact->spatial_count && compact->spatial[k].index == index;
+
+    if (present && data) {
+        compact->spatial[k].data = data;
+    } else if (present) {
+        memmove(&compact->spatial[k], &compact->spatial[k + 1],
+                sizeof(LumSpatialEntry) * (compact->spatial_count - k - 1));
+        compact->spatial_count--;
+    } else if (data) {
+        LumSpatialEntry* grown = (LumSpatialEntry*)realloc(
+            compact->spatial, sizeof(LumSpatialEntry) * (compact->spatial_count + 1));
+        if (!grown) {
+            return -1;
+        }
+        compact->spatial = grown;
+        memmove(&compact->spatial[k + 1], &compact->spatial[k],
+                sizeof(LumSpatialEntry) * (compact->spatial_count - k));
+        compact->spatial[k].index = index;
+        compact->spatial[k].data = data;
+        compact->spatial_count++;
+    }
+
+    compact->records[index].has_spatial = data != NULL;
+    return 0;
+}
+
+int compact_get_lum(const LUMGroup* group, size_t index, LUM* out) {
+    if (!group || !group->compact || !out || index >= group->count) {
+        return -1;
+    }
+
+    const LumCompact* record = &group->compact->records[index];
+    out->presence = (uint8_t)record->presence;
+    out->structure_type = (LumStructureType)record->structure_type;
+    out->spatial_data = compact_get_spatial(group, index);
+    return lum_group_position(group, index, &out->position.x, &out->position.y);
+}
+
+/**
+ * Materialize every LUM of a compact group into out[0..count)
+ */
+int compact_expand(const LUMGroup* group, LUM* out) {
+    if (!group || !group->compact || !out) {
+        return -1;
+    }
+    compact_unpack_records(group, out);
+    return lum_group_fill_positions(group, 0, 0, out);
+}
+
+/**
+ * Fallback for operands whose positions do not fit compact records
+ */
+static LUMGroup* compact_dense_fusion(LUMGroup* group1, LUMGroup* group2) {
+    LUMGroup* temp1 = group1->storage == LUM_STORAGE_COMPACT ? compact_to_dense(group1) : NULL;
+    LUMGroup* temp2 = group2->storage == LUM_STORAGE_COMPACT ? compact_to_dense(group2) : NULL;
+    LUMGroup* result = NULL;
+
+    if ((group1->storage != LUM_STORAGE_COMPACT || temp1) &&
+        (group2->storage != LUM_STORAGE_COMPACT || temp2)) {
+        result = lum_fusion(temp1 ? temp1 : group1, temp2 ? temp2 : group2);
+    }
+
+    free_lum_group(temp1);
+    free_lum_group(temp2);
+    return result;
+}
+
+/**
+ * Compact Fusion (⧉): record concatenation, same semantics as lum_fusion.
+ * Falls back to a dense result when materialized positions leave int16.
+ */
+LUMGroup* compact_lum_fusion(LUMGroup* group1, LUMGroup* group2) {
+    if (!group1 || !group2) {
+        LOG_ERROR("Invalid input groups for compact_lum_fusion");
+        return NULL;
+    }
+
+    // Mixed storage: compact the dense operand into a temporary
+    LUMGroup* temp1 = group1->storage == LUM_STORAGE_COMPACT ? NULL : compact_from_dense(group1);
+    LUMGroup* temp2 = group2->storage == LUM_STORAGE_COMPACT ? NULL : compact_from_dense(group2);
+    LUMGroup* a = temp1 ? temp1 : group1;
+    LUMGroup* b = temp2 ? temp2 : group2;
+    LUMGroup* result = NULL;
+    LUM* positions = NULL;
+
+    if (a->storage != LUM_STORAGE_COMPACT || b->storage != LUM_STORAGE_COMPACT) {
+        result = compact_dense_fusion(group1, group2);
+        goto cleanup;
+    }
+
+    size_t total_count = a->count + b->count;
+    int shift_x = lum_fusion_shift(a->count);
+
+    result = create_compact_lum_group(total_count, GROUP_CLUSTER);
+    if (!result) {
+        LOG_ERROR("Failed to create fused compact LUM group");
+        goto cleanup;
+    }
+    LumCompact* records = result->compact->records;
+
+    if (a->count > 0) {
+        memcpy(records, a->compact->records, sizeof(LumCompact) * a->count);
+    }
+    if (b->count > 0) {
+        memcpy(records + a->count, b->compact->records, sizeof(LumCompact) * b->count);
+    }
+    for (size_t i = a->count; i < total_count; i++) {
+        records[i].structure_type = LUM_GROUP; // Mark as part of fusion
+    }
+
+    if (compact_append_spatial(result->compact, a->compact, 0, a->count, 0) != 0 ||
+        compact_append_spatial(result->compact, b->compact, 0, b->count, a->count) != 0) {
+        goto fail;
+    }
+
+    if (lum_layout_concat(&a->layout, a->count, &b->layout, shift_x, &result->layout) != 0) {
+        positions = (LUM*)malloc(sizeof(LUM) * total_count);
+        if (!positions) {
+            goto fail;
+        }
+        lum_group_fill_positions(a, 0, 0, positions);
+        lum_group_fill_positions(b, shift_x, 0, positions + a->count);
+        result->layout = lum_layout_explicit();
+
+        for (size_t i = 0; i < total_count; i++) {
+            if (compact_store_position(&records[i], positions[i].position.x, positions[i].position.y) != 0) {
+                free_lum_group(result);
+                result = compact_dense_fusion(group1, group2);
+                goto cleanup;
+            }
+        }
+    }
+    goto cleanup;
+
+fail:
+    LOG_ERROR("Memory allocation failed in compact_lum_fusion");
+    free_lum_group(result);
+    result = NULL;
+
+cleanup:
+    free(positions);
+    free_lum_group(temp1);
+    free_lum_group(temp2);
+    return result;
+}
+
+/**
+ * Compact Split (⇅): each zone receives a record range laid out at y = zone * 50
+ */
+LUMGroup** compact_lum_split(LUMGroup* source, int zones, size_t* result_count) {
+    if (!source || !source->compact || zones <= 0 || !result_count) {
+        if (result_count) *result_count = 0;
+        LOG_ERROR("Invalid input for compact_lum_split");
+        return NULL;
+    }
+
+    LUMGroup** result = (LUMGroup**)malloc(sizeof(LUMGroup*) * zones);
+    if (!result) {
+        *result_count = 0;
+        LOG_ERROR("Memory allocation failed for split result array");
+        return NULL;
+    }
+
+    size_t lums_per_zone = source->count / zones;
+    size_t remainder = source->count % zones;
+    size_t current_index = 0;
+
+    for (int i = 0; i < zones; i++) {
+        size_t zone_count = lums_per_zone + ((size_t)i < remainder ? 1 : 0);
+
+        result[i] = create_compact_lum_group(zone_count, GROUP_LINEAR);
+        if (!result[i] ||
+            compact_append_spatial(result[i]->compact, source->compact, current_index, zone_count, 0) != 0) {
+            LOG_ERROR("Failed to create compact LUM group for zone %d", i);
+            free_split_result(result, (size_t)i + (result[i] ? 1 : 0));
+            *result_count = 0;
+            return NULL;
+        }
+
+        LumCompact* records = result[i]->compact->records;
+        if (zone_count > 0) {
+            memcpy(records, source->compact->records + current_index, sizeof(LumCompact) * zone_count);
+        }
+        for (size_t j = 0; j < zone_count; j++) {
+            records[j].structure_type = LUM_LINEAR;
+        }
+        result[i]->layout = lum_layout_linear(0, i * 50, 20);
+        current_index += zone_count;
+    }
+
+    *result_count = zones;
+    return result;
+}
+
+/**
+ * Compact Cycle (⟲): keeps a record prefix laid out on a circle
+ */
+LUMGroup* compact_lum_cycle(LUMGroup* source, int modulo) {
+    if (!source || !source->compact || modulo <= 0) {
+        LOG_ERROR("Invalid input for compact_lum_cycle");
+        return NULL;
+    }
+
+    size_t result_count_raw = source->count % modulo;
+
+    if (result_count_raw == 0) {
+        // Single present LUM at the origin, as in the dense cycle
+        LUMGroup* result = create_compact_lum_group(1, GROUP_NODE);
+        if (!result) {
+            return NULL;
+        }
+        result->compact->records[0].presence = 1;
+        result->compact->records[0].structure_type = LUM_CYCLE;
+        return result;
+    }
+
+    LUMGroup* result = create_compact_lum_group(result_count_raw, GROUP_NODE);
+    if (!result || compact_append_spatial(result->compact, source->compact, 0, result_count_raw, 0) != 0) {
+        LOG_ERROR("Memory allocation failed for %zu LUMs in compact_lum_cycle", result_count_raw);
+        free_lum_group(result);
+        return NULL;
+    }
+
+    LumCompact* records = result->compact->records;
+    memcpy(records, source->compact->records, sizeof(LumCompact) * result_count_raw);
+    for (size_t i = 0; i < result_count_raw; i++) {
+        records[i].structure_type = LUM_CYCLE;
+    }
+    result->layout = lum_layout_circle(50, 50, 30, result_count_raw);
+
+    return result;
+}
+
+/**
+ * Compact Flow (→): copies the records and moves the layout offset by 100
+ */
+LUMGroup* compact_lum_flow(LUMGroup* source, const char* target_zone) {
+    if (!source || !source->compact || !target_zone) {
+        LOG_ERROR("Invalid input for compact_lum_flow");
+        return NULL;
+    }
+
+    LUMGroup* result = compact_clone(source);
+    if (!result) {
+        LOG_ERROR("Failed to create LUM group for compact flow operation");
+        return NULL;
+    }
+
+    for (size_t i = 0; i < result->count; i++) {
+        result->compact->records[i].structure_type = LUM_LINEAR; // Reset to linear for flow
+    }
+    lum_group_translate(result, 100, 0);
+
+    char* target = (char*)malloc(strlen(target_zone) + 1);
+    if (target) {
+        strcpy(target, target_zone);
+        result->spatial_data = target;
+    } else {
+        LOG_ERROR("Memory allocation failed for spatial_data in compact_lum_flow");
+    }
+
+    return result;
+}
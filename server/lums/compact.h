@@ -0,0 +1,27 @@
+#ifndef COMPACT_H
+#define COMPACT_H
+
+#include "lums.h"
+
+// Compact group management
+LUMGroup* create_compact_lum_group(size_t count, GroupType type);
+LUMGroup* compact_from_dense(const LUMGroup* source);
+LUMGroup* compact_to_dense(const LUMGroup* source);
+LUMGroup* compact_clone(const LUMGroup* source);
+void free_compact_storage(LumCompactStorage* compact);
+int lum_group_compact(LUMGroup* group);
+int lum_group_uncompact(LUMGroup* group);
+
+// Element access
+int compact_get_lum(const LUMGroup* group, size_t index, LUM* out);
+int compact_expand(const LUMGroup* group, LUM* out);
+SpatialData* compact_get_spatial(const LUMGroup* group, size_t index);
+int compact_set_spatial(LUMGroup* group, size_t index, SpatialData* data);
+
+// Compact VORAX operations (dispatched from operations.c, dense operands accepted)
+LUMGroup* compact_lum_fusion(LUMGroup* group1, LUMGroup* group2);
+LUMGroup** compact_lum_split(LUMGroup* source, int zones, size_t* result_count);
+LUMGroup* compact_lum_cycle(LUMGroup* source, int modulo);
+LUMGroup* compact_lum_flow(LUMGroup* source, const char* target_zone);
+
+#endif // COMPACT_H
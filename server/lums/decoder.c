@@ -1,7 +1,57 @@
 #include "lums.h"
+#include "decoder.h"
+#include "packed.h"
+#include "soa.h"
+#include "hybrid.h"
+#include "layout.h"
+#include "simd_codec.h"
+#include "reduce.h"
 #include <string.h>
 #include <math.h>
 
+/**
+ * Backend of the group is allocated
+ */
+static int group_has_storage(const LUMGroup* group) {
+    switch (group->storage) {
+        case LUM_STORAGE_PACKED: return group->packed != NULL;
+        case LUM_STORAGE_COMPACT: return group->compact != NULL;
+        case LUM_STORAGE_SOA: return group->soa != NULL;
+        case LUM_STORAGE_HYBRID: return group->hybrid != NULL;
+        default: return group->lums != NULL;
+    }
+}
+
+/**
+ * Presence / structure type of LUM index whatever the backend
+ */
+static uint8_t group_presence_at(const LUMGroup* group, size_t index) {
+    switch (group->storage) {
+        case LUM_STORAGE_PACKED: return packed_get_presence(group, index);
+        case LUM_STORAGE_COMPACT: return (uint8_t)group->compact->records[index].presence;
+        case LUM_STORAGE_SOA: return group->soa->presence[index];
+        case LUM_STORAGE_HYBRID: return hybrid_get_presence(group, index);
+        default: return group->lums[index].presence;
+    }
+}
+
+static LumStructureType group_type_at(const LUMGroup* group, size_t index) {
+    LUM lum;
+    switch (group->storage) {
+        case LUM_STORAGE_PACKED:
+            packed_get_lum(group, index, &lum);
+            return lum.structure_type;
+        case LUM_STORAGE_COMPACT:
+            return (LumStructureType)group->compact->records[index].structure_type;
+        case LUM_STORAGE_SOA:
+            return (LumStructureType)group->soa->structure_type[index];
+        case LUM_STORAGE_HYBRID:
+            return lum_type_runs_at(group->hybrid->type_runs, group->hybrid->type_run_count, index);
+        default:
+            return group->lums[index].structure_type;
+    }
+}
+
 /**
  * Decode LUMS back to bits
  */
@@ -25,11 +75,81 @@ uint64_t decode_lum_to_bit(LUM* lums, size_t count) {
  * Decode LUM group to integer
  */
 uint64_t decode_lum_group(LUMGroup* group) {
-    if (!group || !group->lums) {
+    if (!group || group->count == 0 || group->count > 64) {
         return 0;
     }
+    if (group->storage == LUM_STORAGE_DENSE) {
+        return decode_lum_to_bit(group->lums, group->count);
+    }
 
-    return decode_lum_to_bit(group->lums, group->count);
+    uint64_t result = 0;
+    decode_group_bits(group, 0, group->count, &result);
+    return result;
+}
+
+/**
+ * Decode presence bits [start, start + bit_count) of any group, one
+ * 64-bit word at a time: packed words are bit-copied, hybrid containers
+ * expanded, presence bytes (SoA column or gathered from LUMs / records)
+ * packed 64 per step
+ */
+int decode_group_bits(const LUMGroup* group, size_t start, size_t bit_count, uint64_t* words) {
+    if (!group || !words || !group_has_storage(group) ||
+        start > group->count || bit_count > group->count - start) {
+        return -1;
+    }
+
+    size_t word_count = (bit_count + 63) / 64;
+    switch (group->storage) {
+        case LUM_STORAGE_PACKED:
+            memset(words, 0, sizeof(uint64_t) * word_count);
+            lum_bits_copy(words, 0, group->packed->words, start, bit_count);
+            return 0;
+        case LUM_STORAGE_HYBRID:
+            hybrid_extract_words(group, start, bit_count, words);
+            return 0;
+        case LUM_STORAGE_SOA:
+            lum_presence_to_words(group->soa->presence + start, bit_count, words);
+            return 0;
+        default:
+            break;
+    }
+
+    uint8_t presence[512];
+    for (size_t base = 0; base < bit_count; base += sizeof(presence)) {
+        size_t block = bit_count - base < sizeof(presence) ? bit_count - base : sizeof(presence);
+        if (group->storage == LUM_STORAGE_COMPACT) {
+            const LumCompact* records = group->compact->records + start + base;
+            for (size_t k = 0; k < block; k++) {
+                presence[k] = (uint8_t)records[k].presence;
+            }
+        } else {
+            const LUM* lums = group->lums + start + base;
+            for (size_t k = 0; k < block; k++) {
+                presence[k] = lums[k].presence;
+            }
+        }
+        lum_presence_to_words(presence, block, words + base / 64);
+    }
+    return 0;
+}
+
+int decode_group_stream(const LUMGroup* group, uint64_t* buffer, size_t buffer_words,
+                        LumDecodeSink sink, void* context) {
+    if (!group || !buffer || buffer_words == 0 || !sink || !group_has_storage(group)) {
+        return -1;
+    }
+
+    size_t chunk_bits = buffer_words * 64;
+    for (size_t base = 0; base < group->count; base += chunk_bits) {
+        size_t bits = group->count - base < chunk_bits ? group->count - base : chunk_bits;
+        decode_group_bits(group, base, bits, buffer);
+        int status = sink(buffer, bits, context);
+        if (status != 0) {
+            return status;
+        }
+    }
+    return 0;
 }
 
 /**
@@ -46,13 +166,49 @@ char* decode_to_binary_string(LUM* lums, size_t count) {
     }
 
     for (size_t i = 0; i < count; i++) {
-        result[i] = lums[i].presence ? '1' : '0';
+        result[i] = (char)('0' + (lums[i].presence & 1));
     }
     result[count] = '\0';
 
     return result;
 }
 
+/**
+ * Decode a LUM group to binary string
+ * Packed groups expand 64 bits per step through the SIMD codec
+ */
+char* decode_group_to_binary_string(LUMGroup* group) {
+    if (!group || group->count == 0) {
+        return NULL;
+    }
+    if (group->storage == LUM_STORAGE_DENSE) {
+        return decode_to_binary_string(group->lums, group->count);
+    }
+    if (!group_has_storage(group)) {
+        return NULL;
+    }
+
+    char* result = (char*)malloc(group->count + 1);
+    if (!result) {
+        return NULL;
+    }
+
+    if (group->storage == LUM_STORAGE_PACKED) {
+        lum_words_to_ascii(group->packed->words, group->count, result);
+    } else {
+        // Other backends are decoded one block of words at a time
+        uint64_t block[64];
+        for (size_t base = 0; base < group->count; base += sizeof(block) * 8) {
+            size_t bits = group->count - base < sizeof(block) * 8 ? group->count - base : sizeof(block) * 8;
+            decode_group_bits(group, base, bits, block);
+            lum_words_to_ascii(block, bits, result + base);
+        }
+    }
+    result[group->count] = '\0';
+
+    return result;
+}
+
 /**
  * Decode to specific data types
  */
@@ -81,7 +237,7 @@ uint32_t decode_to_uint32(LUMGroup* group) {
  * Decode to array of bytes
  */
 int decode_to_array(LUMGroup* group, void* output, size_t element_size, size_t max_elements) {
-    if (!group || !group->lums || !output || element_size == 0) {
+    if (!group || !output || element_size == 0 || !group_has_storage(group)) {
         return -1;
     }
 
@@ -92,12 +248,30 @@ int decode_to_array(LUMGroup* group, void* output, size_t element_size, size_t m
     uint8_t* bytes = (uint8_t*)output;
     memset(bytes, 0, max_elements * element_size);
 
-    for (size_t i = 0; i < actual_bits; i++) {
-        if (group->lums[i].presence) {
-            size_t byte_index = i / 8;
-            size_t bit_index = i % 8;
-            bytes[byte_index] |= (1 << bit_index);
+    if (group->storage == LUM_STORAGE_PACKED) {
+        // Whole bytes come straight out of the words
+        const uint64_t* words = group->packed->words;
+        size_t full_bytes = actual_bits / 8;
+        lum_words_to_bytes(words, full_bytes, bytes);
+        if (actual_bits % 8) {
+            uint8_t tail = (uint8_t)(words[full_bytes / 8] >> ((full_bytes % 8) * 8));
+            bytes[full_bytes] = tail & (uint8_t)((1u << (actual_bits % 8)) - 1);
         }
+        return (int)(actual_bits / bits_per_element);
+    }
+    if (group->storage == LUM_STORAGE_SOA) {
+        // The presence column is already the codec's input format
+        lum_presence_to_bytes(group->soa->presence, actual_bits, bytes);
+        return (int)(actual_bits / bits_per_element);
+    }
+
+    // Decode a block of words at a time; bits past actual_bits come out
+    // clear, so the last partial byte is written whole
+    uint64_t block[64];
+    for (size_t base = 0; base < actual_bits; base += sizeof(block) * 8) {
+        size_t bits = actual_bits - base < sizeof(block) * 8 ? actual_bits - base : sizeof(block) * 8;
+        decode_group_bits(group, base, bits, block);
+        lum_words_to_bytes(block, (bits + 7) / 8, bytes + base / 8);
     }
 
     return (int)(actual_bits / bits_per_element);
@@ -108,7 +282,7 @@ int decode_to_array(LUMGroup* group, void* output, size_t element_size, size_t m
  * Interprets grouped LUMs as separate values
  */
 int decode_clustered_groups(LUMGroup* group, uint64_t* values, size_t max_values) {
-    if (!group || !group->lums || !values || max_values == 0) {
+    if (!group || !group_has_storage(group) || !values || max_values == 0) {
         return -1;
     }
 
@@ -119,13 +293,13 @@ int decode_clustered_groups(LUMGroup* group, uint64_t* values, size_t max_values
     for (size_t i = 0; i <= group->count && value_count < max_values; i++) {
         // End of cluster or end of array
         if (i == group->count || 
-            (i > 0 && group->lums[i].structure_type != group->lums[i-1].structure_type)) {
+            (i > 0 && group_type_at(group, i) != group_type_at(group, i - 1))) {
 
             if (i > cluster_start) {
                 // Decode the cluster
                 current_value = 0;
                 for (size_t j = cluster_start; j < i; j++) {
-                    if (group->lums[j].presence) {
+                    if (group_presence_at(group, j)) {
                         current_value |= (1ULL << (j - cluster_start));
                     }
                 }
@@ -179,20 +353,45 @@ int validate_lums(LUM* lums, size_t count) {
     return 1; // Valid
 }
 
+/**
+ * validate_lums for any storage: SoA groups are checked on their columns,
+ * other backends through a temporary LUM expansion
+ */
+int validate_lum_group(LUMGroup* group) {
+    if (!group || !group_has_storage(group)) {
+        return 0;
+    }
+    if (group->storage == LUM_STORAGE_SOA) {
+        return soa_validate(group);
+    }
+    if (group->storage == LUM_STORAGE_DENSE && group->layout.kind == LUM_LAYOUT_EXPLICIT &&
+        group->layout.offset_x == 0 && group->layout.offset_y == 0) {
+        return validate_lums(group->lums, group->count);
+    }
+
+    LUM* lums = (LUM*)malloc(sizeof(LUM) * (group->count > 0 ? group->count : 1));
+    if (!lums) {
+        return 0;
+    }
+    for (size_t i = 0; i < group->count; i++) {
+        lums[i].presence = group_presence_at(group, i);
+        lums[i].structure_type = group_type_at(group, i);
+    }
+    int valid = lum_group_fill_positions(group, 0, 0, lums) == 0 &&
+                validate_lums(lums, group->count);
+    free(lums);
+    return valid;
+}
+
 /**
  * Calculate information entropy of LUM group
  */
 double calculate_lum_entropy(LUMGroup* group) {
-    if (!group || !group->lums || group->count == 0) {
+    if (!group || group->count == 0 || !group_has_storage(group)) {
         return 0.0;
     }
 
-    size_t ones = 0;
-    for (size_t i = 0; i < group->count; i++) {
-        if (group->lums[i].presence) {
-            ones++;
-        }
-    }
+    size_t ones = lum_group_popcount(group);
 
     if (ones == 0 || ones == group->count) {
         return 0.0; // No entropy in uniform data
@@ -213,23 +412,49 @@ typedef struct {
 } LumRun;
 
 int compress_lums_rle(LUMGroup* group, LumRun* runs, size_t max_runs) {
-    if (!group || !group->lums || !runs || max_runs == 0) {
+    if (!group || !group_has_storage(group) || group->count == 0 || !runs || max_runs == 0) {
         return -1;
     }
 
     size_t run_count = 0;
-    uint8_t current_value = group->lums[0].presence;
+
+    if (group->storage == LUM_STORAGE_HYBRID) {
+        // Runs come straight out of the containers, absent stretches fill the gaps
+        size_t position = 0;
+        while (position < group->count && run_count < max_runs) {
+            size_t start, length;
+            if (hybrid_next_run(group, position, &start, &length) != 0) {
+                start = group->count;
+                length = 0;
+            }
+            if (start > position) {
+                runs[run_count].value = 0;
+                runs[run_count].count = start - position;
+                run_count++;
+            }
+            if (length > 0 && run_count < max_runs) {
+                runs[run_count].value = 1;
+                runs[run_count].count = length;
+                run_count++;
+            }
+            position = start + length;
+        }
+        return (int)run_count;
+    }
+
+    uint8_t current_value = group_presence_at(group, 0);
     size_t current_count = 1;
 
     for (size_t i = 1; i < group->count && run_count < max_runs; i++) {
-        if (group->lums[i].presence == current_value) {
+        uint8_t presence = group_presence_at(group, i);
+        if (presence == current_value) {
             current_count++;
         } else {
             runs[run_count].value = current_value;
             runs[run_count].count = current_count;
             run_count++;
 
-            current_value = group->lums[i].presence;
+            current_value = presence;
             current_count = 1;
         }
     }
@@ -7,6 +7,18 @@
 uint64_t decode_lum_to_bit(LUM* lums, size_t count);
 uint64_t decode_lum_group(LUMGroup* group);
 char* decode_to_binary_string(LUM* lums, size_t count);
+char* decode_group_to_binary_string(LUMGroup* group);
+
+// Streaming decoding, any group length
+// Presence bits [start, start + bit_count) into words (bit k in words[k / 64]),
+// (bit_count + 63) / 64 words written, bits past bit_count cleared
+int decode_group_bits(const LUMGroup* group, size_t start, size_t bit_count, uint64_t* words);
+// Receives successive chunks of the group; a nonzero return stops decoding
+typedef int (*LumDecodeSink)(const uint64_t* words, size_t bit_count, void* context);
+// Decodes through buffer (buffer_words * 64 bits per chunk), no allocation.
+// Returns 0 once every bit was delivered, the sink's status if it stopped, -1 on invalid input.
+int decode_group_stream(const LUMGroup* group, uint64_t* buffer, size_t buffer_words,
+                        LumDecodeSink sink, void* context);
 
 // Type-specific decoding
 uint8_t decode_to_uint8(LUMGroup* group);
@@ -17,8 +29,10 @@ uint32_t decode_to_uint32(LUMGroup* group);
 int decode_to_array(LUMGroup* group, void* output, size_t element_size, size_t max_elements);
 int decode_clustered_groups(LUMGroup* group, uint64_t* values, size_t max_values);
 
-// Validation and compression
+// Validation and compression. validate_lums reads lums[].position as stored,
+// only meaningful for explicit layouts: validate_lum_group works on any group.
 int validate_lums(LUM* lums, size_t count);
+int validate_lum_group(LUMGroup* group);
 double calculate_lum_entropy(LUMGroup* group);
 
 #endif // DECODER_H
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include "lums.h"
+#include "dedup.h"
+#include "reduce.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#ifndef LOG_ERROR
+#define LOG_ERROR(...) fprintf(stderr, "ERROR: " __VA_ARGS__); fprintf(stderr, "\n")
+#endif
+
+#define DEDUP_INITIAL_BUCKETS 16   // Power of two, doubled when entries outnumber buckets
+
+typedef struct DedupEntry DedupEntry;
+struct DedupEntry {
+    uint64_t hash;
+    LUMGroup* group;
+    DedupEntry* next;
+};
+
+struct LumDedup {
+    DedupEntry** buckets;
+    size_t bucket_count;
+    size_t count;
+};
+
+LumDedup* lum_dedup_create(void) {
+    LumDedup* dedup = (LumDedup*)calloc(1, sizeof(LumDedup));
+    if (dedup) {
+        dedup->buckets = (DedupEntry**)calloc(DEDUP_INITIAL_BUCKETS, sizeof(DedupEntry*));
+        dedup->bucket_count = DEDUP_INITIAL_BUCKETS;
+    }
+    if (!dedup || !dedup->buckets) {
+        LOG_ERROR("Memory allocation failed for LUM dedup set");
+        free(dedup);
+        return NULL;
+    }
+    return dedup;
+}
+
+void lum_dedup_free(LumDedup* dedup) {
+    if (!dedup) {
+        return;
+    }
+    for (size_t i = 0; i < dedup->bucket_count; i++) {
+        DedupEntry* entry = dedup->buckets[i];
+        while (entry) {
+            DedupEntry* next = entry->next;
+            free(entry);
+            entry = next;
+        }
+    }
+    free(dedup->buckets);
+    free(dedup);
+}
+
+static DedupEntry** bucket_of(const LumDedup* dedup, uint64_t hash) {
+    return &dedup->buckets[hash & (dedup->bucket_count - 1)];
+}
+
+/**
+ * Doubles the buckets; on allocation failure the set keeps working, just longer chains
+ */
+static void dedup_grow(LumDedup* dedup) {
+    if (dedup->bucket_count > SIZE_MAX / 2 / sizeof(DedupEntry*)) {
+        return;
+    }
+    size_t bucket_count = dedup->bucket_count * 2;
+    DedupEntry** buckets = (DedupEntry**)calloc(bucket_count, sizeof(DedupEntry*));
+    if (!buckets) {
+        return;
+    }
+    for (size_t i = 0; i < dedup->bucket_count; i++) {
+        DedupEntry* entry = dedup->buckets[i];
+        while (entry) {
+            DedupEntry* next = entry->next;
+            DedupEntry** bucket = &buckets[entry->hash & (bucket_count - 1)];
+            entry->next = *bucket;
+            *bucket = entry;
+            entry = next;
+        }
+    }
+    free(dedup->buckets);
+    dedup->buckets = buckets;
+    dedup->bucket_count = bucket_count;
+}
+
+LUMGroup* lum_dedup_find(LumDedup* dedup, LUMGroup* group) {
+    if (!dedup || !group || dedup->count == 0) {
+        return NULL;
+    }
+    uint64_t hash = lum_group_content_hash(group);
+    for (DedupEntry* entry = *bucket_of(dedup, hash); entry; entry = entry->next) {
+        if (entry->hash == hash && lum_groups_identical(entry->group, group)) {
+            return entry->group;
+        }
+    }
+    return NULL;
+}
+
+int lum_dedup_add(LumDedup* dedup, LUMGroup* stored) {
+    if (!dedup || !stored) {
+        return -1;
+    }
+    DedupEntry* entry = (DedupEntry*)malloc(sizeof(DedupEntry));
+    if (!entry) {
+        LOG_ERROR("Memory allocation failed for LUM dedup entry");
+        return -1;
+    }
+    if (dedup->count >= dedup->bucket_count) {
+        dedup_grow(dedup);
+    }
+    entry->hash = lum_group_content_hash(stored);
+    entry->group = stored;
+    DedupEntry** bucket = bucket_of(dedup, entry->hash);
+    entry->next = *bucket;
+    *bucket = entry;
+    dedup->count++;
+    return 0;
+}
+
+void lum_dedup_remove(LumDedup* dedup, LUMGroup* stored) {
+    if (!dedup || !stored) {
+        return;
+    }
+    // Matched by address: the entry keeps the hash it was filed under, whatever
+    // the group's cache says now
+    for (size_t i = 0; i < dedup->bucket_count; i++) {
+        for (DedupEntry** link = &dedup->buckets[i]; *link; link = &(*link)->next) {
+            if ((*link)->group == stored) {
+                DedupEntry* entry = *link;
+                *link = entry->next;
+                free(entry);
+                dedup->count--;
+                return;
+            }
+        }
+    }
+}
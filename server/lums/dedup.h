@@ -0,0 +1,24 @@
+#ifndef DEDUP_H
+#define DEDUP_H
+
+#include "lums.h"
+
+// Set of groups keyed by content: lum_group_content_hash picks the bucket and
+// lum_groups_identical confirms, so lookups cost one hash of the probe (none
+// once cached) plus a full check of the candidates sharing its hash.
+typedef struct LumDedup LumDedup;
+
+LumDedup* lum_dedup_create(void);
+// Frees the entries, never the groups
+void lum_dedup_free(LumDedup* dedup);
+
+// Stored group with the same LUMs as group (any storage), NULL if none.
+// Hashes group through its cached content hash (reduce.h).
+LUMGroup* lum_dedup_find(LumDedup* dedup, LUMGroup* group);
+// Records stored, borrowed, under its content hash: it must not change while
+// it is in the set. 0, or -1 on allocation failure.
+int lum_dedup_add(LumDedup* dedup, LUMGroup* stored);
+// Drops stored if it is in the set (a scan of the entries)
+void lum_dedup_remove(LumDedup* dedup, LUMGroup* stored);
+
+#endif // DEDUP_H
@@ -1,7 +1,20 @@
 #include "lums.h"
+#include "packed.h"
+#include "simd_codec.h"
+#include "layout.h"
 #include <stdio.h>
 #include <time.h>
 
+static void fill_bits(uint64_t input, size_t bit_count, LUM* out) {
+    for (size_t i = 0; i < bit_count; i++) {
+        out[i].presence = (input >> i) & 1;
+        out[i].structure_type = LUM_LINEAR;
+        out[i].spatial_data = NULL;
+        out[i].position.x = i * 20; // Space LUMS 20 units apart
+        out[i].position.y = 0;
+    }
+}
+
 /**
  * Encode bits to LUMS representation
  * Each bit becomes a LUM with presence 0 or 1
@@ -16,27 +29,25 @@ LUM* encode_bit_to_lum(uint64_t input, size_t bit_count) {
         return NULL;
     }
     
-    for (size_t i = 0; i < bit_count; i++) {
-        result[i].presence = (input >> i) & 1;
-        result[i].structure_type = LUM_LINEAR;
-        result[i].spatial_data = NULL;
-        result[i].position.x = i * 20; // Space LUMS 20 units apart
-        result[i].position.y = 0;
-    }
-    
+    fill_bits(input, bit_count, result);
     return result;
 }
 
 /**
- * Create a LUM group from encoded bits
+ * Create a LUM group from encoded bits, in a single allocation
  */
 LUMGroup* encode_to_lum_group(uint64_t input, size_t bit_count) {
-    LUM* lums = encode_bit_to_lum(input, bit_count);
-    if (!lums) {
+    if (bit_count == 0 || bit_count > 64) {
         return NULL;
     }
     
-    return create_lum_group(lums, bit_count, GROUP_LINEAR);
+    LUMGroup* group = lum_group_alloc(bit_count, GROUP_LINEAR);
+    if (!group) {
+        return NULL;
+    }
+    fill_bits(input, bit_count, group->lums);
+    group->layout = lum_layout_linear(0, 0, 20);
+    return group;
 }
 
 /**
@@ -52,28 +63,31 @@ LUMGroup* encode_binary_string(const char* binary_str) {
         return NULL;
     }
     
-    LUM* lums = (LUM*)malloc(sizeof(LUM) * len);
-    if (!lums) {
+    LUMGroup* group = lum_group_alloc(len, GROUP_LINEAR);
+    if (!group) {
         return NULL;
     }
-    
-    for (size_t i = 0; i < len; i++) {
-        if (binary_str[i] == '1') {
-            lums[i].presence = 1;
-        } else if (binary_str[i] == '0') {
-            lums[i].presence = 0;
-        } else {
-            free(lums);
+    LUM* lums = group->lums;
+    
+    // Validate and pack 64 characters per step, then expand the word
+    for (size_t base = 0; base < len; base += 64) {
+        size_t block = len - base < 64 ? len - base : 64;
+        uint64_t bits;
+        if (lum_ascii_to_words(binary_str + base, block, &bits) != 0) {
+            free_lum_group(group);
             return NULL; // Invalid character
         }
         
-        lums[i].structure_type = LUM_LINEAR;
-        lums[i].spatial_data = NULL;
-        lums[i].position.x = i * 20;
-        lums[i].position.y = 0;
+        for (size_t k = 0; k < block; k++) {
+            size_t i = base + k;
+            lums[i].presence = (uint8_t)((bits >> k) & 1);
+            lums[i].structure_type = LUM_LINEAR;
+            lums[i].spatial_data = NULL;
+        }
     }
     
-    return create_lum_group(lums, len, GROUP_LINEAR);
+    group->layout = lum_layout_linear(0, 0, 20);
+    return group;
 }
 
 /**
@@ -90,34 +104,57 @@ LUMGroup* encode_with_clustering(const char* binary_str) {
         return NULL;
     }
     
-    LUM* lums = (LUM*)malloc(sizeof(LUM) * len);
-    if (!lums) {
+    LUMGroup* group = lum_group_alloc(len, GROUP_CLUSTER);
+    if (!group) {
         return NULL;
     }
+    LUM* lums = group->lums;
     
-    int cluster_start = -1;
-    for (size_t i = 0; i < len; i++) {
-        if (binary_str[i] == '1') {
-            lums[i].presence = 1;
-            if (cluster_start == -1) {
-                cluster_start = i;
-            }
-            lums[i].structure_type = LUM_GROUP;
-        } else if (binary_str[i] == '0') {
-            lums[i].presence = 0;
-            lums[i].structure_type = LUM_LINEAR;
-            cluster_start = -1;
-        } else {
-            free(lums);
+    for (size_t base = 0; base < len; base += 64) {
+        size_t block = len - base < 64 ? len - base : 64;
+        uint64_t bits;
+        if (lum_ascii_to_words(binary_str + base, block, &bits) != 0) {
+            free_lum_group(group);
             return NULL;
         }
         
-        lums[i].spatial_data = NULL;
-        lums[i].position.x = i * 20;
-        lums[i].position.y = 0;
+        for (size_t k = 0; k < block; k++) {
+            size_t i = base + k;
+            uint8_t bit = (uint8_t)((bits >> k) & 1);
+            lums[i].presence = bit;
+            lums[i].structure_type = bit ? LUM_GROUP : LUM_LINEAR;
+            lums[i].spatial_data = NULL;
+        }
+    }
+    
+    group->layout = lum_layout_linear(0, 0, 20);
+    return group;
+}
+
+/**
+ * Encode binary string straight into a packed LUM group
+ */
+LUMGroup* encode_binary_string_packed(const char* binary_str) {
+    if (!binary_str) {
+        return NULL;
+    }
+    
+    size_t len = strlen(binary_str);
+    if (len == 0) {
+        return NULL;
+    }
+    
+    LUMGroup* group = create_packed_lum_group(len, GROUP_LINEAR);
+    if (!group) {
+        return NULL;
+    }
+    
+    if (lum_ascii_to_words(binary_str, len, group->packed->words) != 0) {
+        free_lum_group(group);
+        return NULL; // Invalid character
     }
     
-    return create_lum_group(lums, len, GROUP_CLUSTER);
+    return group;
 }
 
 /**
@@ -144,24 +181,68 @@ LUMGroup* encode_array(void* data, size_t element_size, size_t count) {
     }
     
     size_t total_bits = element_size * 8 * count;
-    LUM* lums = (LUM*)malloc(sizeof(LUM) * total_bits);
-    if (!lums) {
+    LUMGroup* group = lum_group_alloc(total_bits, GROUP_LINEAR);
+    if (!group) {
         return NULL;
     }
+    LUM* lums = group->lums;
     
-    uint8_t* bytes = (uint8_t*)data;
-    size_t lum_index = 0;
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint8_t presence[512];
     
-    for (size_t i = 0; i < count * element_size; i++) {
-        for (int bit = 0; bit < 8; bit++) {
-            lums[lum_index].presence = (bytes[i] >> bit) & 1;
-            lums[lum_index].structure_type = LUM_LINEAR;
-            lums[lum_index].spatial_data = NULL;
-            lums[lum_index].position.x = (lum_index % 32) * 20;
-            lums[lum_index].position.y = (lum_index / 32) * 30;
-            lum_index++;
+    // Expand 64 bytes at a time, positions come from the group layout
+    for (size_t base = 0; base < total_bits; base += sizeof(presence)) {
+        size_t block = total_bits - base < sizeof(presence) ? total_bits - base : sizeof(presence);
+        lum_bytes_to_presence(bytes + base / 8, block, presence);
+        
+        for (size_t k = 0; k < block; k++) {
+            LUM* lum = &lums[base + k];
+            lum->presence = presence[k];
+            lum->structure_type = LUM_LINEAR;
+            lum->spatial_data = NULL;
         }
     }
     
-    return create_lum_group(lums, total_bits, GROUP_LINEAR);
+    group->layout = lum_layout_grid(0, 0, 20, 32, 30); // 32-column grid
+    return group;
+}
+
+/**
+ * Encode bits directly into a packed LUM group
+ * Same layout as encode_bit_to_lum, one word instead of bit_count LUMs
+ */
+LUMGroup* encode_to_packed_group(uint64_t input, size_t bit_count) {
+    if (bit_count == 0 || bit_count > 64) {
+        return NULL;
+    }
+
+    LUMGroup* group = create_packed_lum_group(bit_count, GROUP_LINEAR);
+    if (!group) {
+        return NULL;
+    }
+
+    group->packed->words[0] = bit_count == 64 ? input : input & ((1ULL << bit_count) - 1);
+    return group;
+}
+
+/**
+ * Encode array of values into a packed LUM group
+ * Bytes map onto little-endian words, a bulk copy on most hosts
+ */
+LUMGroup* encode_array_packed(void* data, size_t element_size, size_t count) {
+    if (!data || element_size == 0 || count == 0) {
+        return NULL;
+    }
+
+    size_t total_bytes = element_size * count;
+    LUMGroup* group = create_packed_lum_group(total_bytes * 8, GROUP_LINEAR);
+    if (!group) {
+        return NULL;
+    }
+
+    group->layout = lum_layout_grid(0, 0, 20, 32, 30); // Same grid as encode_array
+
+    lum_bytes_to_words((const uint8_t*)data, total_bytes, group->packed->words);
+
+    return group;
 }
@@ -17,4 +17,9 @@ LUMGroup* encode_uint32(uint32_t value);
 // Array encoding
 LUMGroup* encode_array(void* data, size_t element_size, size_t count);
 
+// Packed encoding (presence bits in 64-bit words)
+LUMGroup* encode_to_packed_group(uint64_t input, size_t bit_count);
+LUMGroup* encode_binary_string_packed(const char* binary_str);
+LUMGroup* encode_array_packed(void* data, size_t element_size, size_t count);
+
 #endif // ENCODER_H
\ No newline at end of file
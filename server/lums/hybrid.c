@@ -0,0 +1,1114 @@
+#include "lums.h"
+#include "hybrid.h"
+#include "packed.h"
+#include "layout.h"
+#include "compact.h"
+#include "soa.h"
+#include "operations.h"
+#include "view.h"
+#include "reduce.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#ifndef LOG_ERROR
+#define LOG_ERROR(...) fprintf(stderr, "ERROR: " __VA_ARGS__); fprintf(stderr, "\n")
+#endif
+
+#define CONTAINER_WORDS (LUM_CONTAINER_SIZE / 64)
+#define HYBRID_CONTAINERS(count) (((count) + LUM_CONTAINER_SIZE - 1) / LUM_CONTAINER_SIZE)
+// Positions compared per step when fusion has to store overrides
+#define HYBRID_POSITION_CHUNK 4096
+
+// ===== Word helpers =====
+
+static void words_set_range(uint64_t* words, size_t start, size_t length) {
+    while (length > 0) {
+        size_t offset = start & 63;
+        size_t chunk = 64 - offset < length ? 64 - offset : length;
+        uint64_t mask = chunk == 64 ? ~0ULL : ((1ULL << chunk) - 1);
+        words[start / 64] |= mask << offset;
+        start += chunk;
+        length -= chunk;
+    }
+}
+
+/**
+ * First bit >= from equal to value, word_count * 64 if none
+ */
+static size_t words_next(const uint64_t* words, size_t word_count, size_t from, int value) {
+    size_t w = from / 64;
+    if (w >= word_count) {
+        return word_count * 64;
+    }
+
+    uint64_t bits = (value ? words[w] : ~words[w]) & (~0ULL << (from & 63));
+    while (bits == 0) {
+        if (++w == word_count) {
+            return word_count * 64;
+        }
+        bits = value ? words[w] : ~words[w];
+    }
+    return w * 64 + (size_t)__builtin_ctzll(bits);
+}
+
+/**
+ * Number of runs of set bits: bits set whose lower neighbour is clear
+ */
+static uint32_t words_run_count(const uint64_t* words) {
+    uint32_t runs = 0;
+    uint64_t carry = 0;
+    for (size_t w = 0; w < CONTAINER_WORDS; w++) {
+        runs += (uint32_t)__builtin_popcountll(words[w] & ~((words[w] << 1) | carry));
+        carry = words[w] >> 63;
+    }
+    return runs;
+}
+
+// ===== Containers =====
+
+static void container_clear(LumContainer* c) {
+    switch (c->kind) {
+        case LUM_CONTAINER_BITMAP: free(c->data.words); break;
+        case LUM_CONTAINER_RUN: free(c->data.runs); break;
+        default: free(c->data.values); break;
+    }
+    memset(c, 0, sizeof(*c));
+    c->kind = LUM_CONTAINER_ARRAY;
+}
+
+/**
+ * First index of values >= value
+ */
+static uint32_t array_lower_bound(const LumContainer* c, uint32_t value) {
+    uint32_t lo = 0;
+    uint32_t hi = c->size;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (c->data.values[mid] < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * First run with last >= value
+ */
+static uint32_t run_lower_bound(const LumContainer* c, uint32_t value) {
+    uint32_t lo = 0;
+    uint32_t hi = c->size;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (c->data.runs[mid].last < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static int container_contains(const LumContainer* c, uint32_t value) {
+    switch (c->kind) {
+        case LUM_CONTAINER_BITMAP:
+            return (int)((c->data.words[value / 64] >> (value % 64)) & 1);
+        case LUM_CONTAINER_RUN: {
+            uint32_t r = run_lower_bound(c, value);
+            return r < c->size && c->data.runs[r].start <= value;
+        }
+        default: {
+            uint32_t i = array_lower_bound(c, value);
+            return i < c->size && c->data.values[i] == value;
+        }
+    }
+}
+
+/**
+ * First present index >= from, LUM_CONTAINER_SIZE if none
+ */
+static uint32_t container_next_present(const LumContainer* c, uint32_t from) {
+    switch (c->kind) {
+        case LUM_CONTAINER_BITMAP:
+            return (uint32_t)words_next(c->data.words, CONTAINER_WORDS, from, 1);
+        case LUM_CONTAINER_RUN: {
+            uint32_t r = run_lower_bound(c, from);
+            if (r == c->size) return LUM_CONTAINER_SIZE;
+            return c->data.runs[r].start > from ? c->data.runs[r].start : from;
+        }
+        default: {
+            uint32_t i = array_lower_bound(c, from);
+            return i < c->size ? c->data.values[i] : LUM_CONTAINER_SIZE;
+        }
+    }
+}
+
+/**
+ * First absent index >= from, LUM_CONTAINER_SIZE if the container is full up to its end
+ */
+static uint32_t container_next_absent(const LumContainer* c, uint32_t from) {
+    switch (c->kind) {
+        case LUM_CONTAINER_BITMAP:
+            return (uint32_t)words_next(c->data.words, CONTAINER_WORDS, from, 0);
+        case LUM_CONTAINER_RUN: {
+            // Runs are maximal, so the one holding from ends the stretch
+            uint32_t r = run_lower_bound(c, from);
+            if (r == c->size || c->data.runs[r].start > from) return from;
+            return (uint32_t)c->data.runs[r].last + 1;
+        }
+        default: {
+            uint32_t i = array_lower_bound(c, from);
+            uint32_t value = from;
+            while (i < c->size && c->data.values[i] == value) {
+                i++;
+                value++;
+            }
+            return value;
+        }
+    }
+}
+
+static void container_to_words(const LumContainer* c, uint64_t* words) {
+    if (c->kind == LUM_CONTAINER_BITMAP) {
+        memcpy(words, c->data.words, sizeof(uint64_t) * CONTAINER_WORDS);
+        return;
+    }
+    memset(words, 0, sizeof(uint64_t) * CONTAINER_WORDS);
+    if (c->kind == LUM_CONTAINER_RUN) {
+        for (uint32_t r = 0; r < c->size; r++) {
+            words_set_range(words, c->data.runs[r].start,
+                            (size_t)c->data.runs[r].last - c->data.runs[r].start + 1);
+        }
+    } else {
+        for (uint32_t i = 0; i < c->size; i++) {
+            words[c->data.values[i] / 64] |= 1ULL << (c->data.values[i] % 64);
+        }
+    }
+}
+
+/**
+ * Rebuild a container from a bitmap with the smallest of the three
+ * encodings: 2 bytes per index, 8 KB of words or 4 bytes per run
+ */
+static int container_from_words(LumContainer* c, const uint64_t* words) {
+    uint32_t cardinality = 0;
+    for (size_t w = 0; w < CONTAINER_WORDS; w++) {
+        cardinality += (uint32_t)__builtin_popcountll(words[w]);
+    }
+    uint32_t run_count = words_run_count(words);
+
+    size_t best_bytes = sizeof(uint64_t) * CONTAINER_WORDS;
+    LumContainerKind kind = LUM_CONTAINER_BITMAP;
+    if (cardinality <= LUM_CONTAINER_ARRAY_MAX && sizeof(uint16_t) * cardinality <= best_bytes) {
+        best_bytes = sizeof(uint16_t) * cardinality;
+        kind = LUM_CONTAINER_ARRAY;
+    }
+    if (sizeof(LumContainerRun) * run_count < best_bytes) {
+        kind = LUM_CONTAINER_RUN;
+    }
+
+    LumContainer built;
+    memset(&built, 0, sizeof(built));
+    built.kind = kind;
+    built.cardinality = cardinality;
+
+    if (kind == LUM_CONTAINER_BITMAP) {
+        built.data.words = (uint64_t*)malloc(sizeof(uint64_t) * CONTAINER_WORDS);
+        if (!built.data.words) return -1;
+        memcpy(built.data.words, words, sizeof(uint64_t) * CONTAINER_WORDS);
+    } else if (kind == LUM_CONTAINER_RUN) {
+        built.data.runs = (LumContainerRun*)malloc(sizeof(LumContainerRun) * run_count);
+        if (!built.data.runs) return -1;
+        size_t bit = words_next(words, CONTAINER_WORDS, 0, 1);
+        while (bit < LUM_CONTAINER_SIZE) {
+            size_t end = words_next(words, CONTAINER_WORDS, bit, 0);
+            built.data.runs[built.size].start = (uint16_t)bit;
+            built.data.runs[built.size].last = (uint16_t)(end - 1);
+            built.size++;
+            bit = words_next(words, CONTAINER_WORDS, end, 1);
+        }
+    } else if (cardinality > 0) {
+        built.data.values = (uint16_t*)malloc(sizeof(uint16_t) * cardinality);
+        if (!built.data.values) return -1;
+        for (size_t w = 0; w < CONTAINER_WORDS; w++) {
+            uint64_t bits = words[w];
+            while (bits) {
+                built.data.values[built.size++] = (uint16_t)(w * 64 + (size_t)__builtin_ctzll(bits));
+                bits &= bits - 1;
+            }
+        }
+    }
+    built.capacity = built.size;
+
+    container_clear(c);
+    *c = built;
+    return 0;
+}
+
+static int container_copy(LumContainer* dst, const LumContainer* src) {
+    size_t bytes;
+    switch (src->kind) {
+        case LUM_CONTAINER_BITMAP: bytes = sizeof(uint64_t) * CONTAINER_WORDS; break;
+        case LUM_CONTAINER_RUN: bytes = sizeof(LumContainerRun) * src->size; break;
+        default: bytes = sizeof(uint16_t) * src->size; break;
+    }
+
+    void* data = NULL;
+    if (bytes > 0) {
+        data = malloc(bytes);
+        if (!data) return -1;
+        memcpy(data, src->kind == LUM_CONTAINER_BITMAP ? (void*)src->data.words :
+                     src->kind == LUM_CONTAINER_RUN ? (void*)src->data.runs : (void*)src->data.values,
+               bytes);
+    }
+
+    container_clear(dst);
+    dst->kind = src->kind;
+    dst->cardinality = src->cardinality;
+    dst->size = src->size;
+    dst->capacity = src->size;
+    switch (src->kind) {
+        case LUM_CONTAINER_BITMAP: dst->data.words = (uint64_t*)data; break;
+        case LUM_CONTAINER_RUN: dst->data.runs = (LumContainerRun*)data; break;
+        default: dst->data.values = (uint16_t*)data; break;
+    }
+    return 0;
+}
+
+static int container_to_bitmap(LumContainer* c) {
+    if (c->kind == LUM_CONTAINER_BITMAP) {
+        return 0;
+    }
+    uint64_t* words = (uint64_t*)malloc(sizeof(uint64_t) * CONTAINER_WORDS);
+    if (!words) {
+        return -1;
+    }
+    container_to_words(c, words);
+
+    uint32_t cardinality = c->cardinality;
+    container_clear(c);
+    c->kind = LUM_CONTAINER_BITMAP;
+    c->cardinality = cardinality;
+    c->data.words = words;
+    return 0;
+}
+
+/**
+ * Append [start, last] past every index already present (builder path)
+ */
+static int container_append_run(LumContainer* c, uint32_t start, uint32_t last) {
+    if (c->kind != LUM_CONTAINER_RUN) {
+        if (c->cardinality > 0) {
+            // Rare: only when appending after a cloned container
+            uint64_t* words = (uint64_t*)malloc(sizeof(uint64_t) * CONTAINER_WORDS);
+            if (!words) return -1;
+            container_to_words(c, words);
+            words_set_range(words, start, (size_t)last - start + 1);
+            int status = container_from_words(c, words);
+            free(words);
+            return status;
+        }
+        container_clear(c);
+        c->kind = LUM_CONTAINER_RUN;
+    }
+
+    if (c->size > 0 && (uint32_t)c->data.runs[c->size - 1].last + 1 == start) {
+        c->data.runs[c->size - 1].last = (uint16_t)last;
+    } else {
+        if (c->size == c->capacity) {
+            uint32_t new_capacity = c->capacity ? c->capacity * 2 : 8;
+            LumContainerRun* grown = (LumContainerRun*)realloc(
+                c->data.runs, sizeof(LumContainerRun) * new_capacity);
+            if (!grown) return -1;
+            c->data.runs = grown;
+            c->capacity = new_capacity;
+        }
+        c->data.runs[c->size].start = (uint16_t)start;
+        c->data.runs[c->size].last = (uint16_t)last;
+        c->size++;
+    }
+    c->cardinality += last - start + 1;
+    return 0;
+}
+
+// ===== Group management =====
+
+/**
+ * Create a hybrid LUM group with every LUM absent (empty index lists).
+ * Default layout matches encode_bit_to_lum: linear, 20 units apart.
+ */
+LUMGroup* create_hybrid_lum_group(size_t count, GroupType type) {
+    LUMGroup* group = (LUMGroup*)calloc(1, sizeof(LUMGroup));
+    LumHybridStorage* hybrid = (LumHybridStorage*)calloc(1, sizeof(LumHybridStorage));
+    if (!group || !hybrid) {
+        free(group);
+        free(hybrid);
+        LOG_ERROR("Memory allocation failed for hybrid LUMGroup");
+        return NULL;
+    }
+
+    hybrid->container_count = HYBRID_CONTAINERS(count);
+    if (hybrid->container_count > 0) {
+        hybrid->containers = (LumContainer*)calloc(hybrid->container_count, sizeof(LumContainer));
+    }
+    hybrid->type_runs = (LumTypeRun*)malloc(sizeof(LumTypeRun));
+    if ((hybrid->container_count > 0 && !hybrid->containers) || !hybrid->type_runs) {
+        free_hybrid_storage(hybrid);
+        free(group);
+        LOG_ERROR("Memory allocation failed for %zu hybrid LUMs", count);
+        return NULL;
+    }
+
+    hybrid->type_runs[0].start = 0;
+    hybrid->type_runs[0].structure_type = LUM_LINEAR;
+    hybrid->type_run_count = 1;
+
+    group->count = count;
+    group->group_type = type;
+    group->storage = LUM_STORAGE_HYBRID;
+    group->hybrid = hybrid;
+    group->layout = lum_layout_linear(0, 0, 20);
+
+    return group;
+}
+
+void free_hybrid_storage(LumHybridStorage* hybrid) {
+    if (!hybrid) {
+        return;
+    }
+    for (size_t k = 0; k < hybrid->container_count; k++) {
+        container_clear(&hybrid->containers[k]);
+    }
+    free(hybrid->containers);
+    free(hybrid->type_runs);
+    free(hybrid->overrides);
+    free(hybrid);
+}
+
+/**
+ * Replace the type runs / overrides of dst with copies of the given arrays
+ */
+static int hybrid_copy_metadata(LUMGroup* dst, const LumTypeRun* runs, size_t run_count,
+                                const LumPositionOverride* overrides, size_t override_count) {
+    LumHybridStorage* hybrid = dst->hybrid;
+    LumTypeRun* run_copy = (LumTypeRun*)malloc(sizeof(LumTypeRun) * run_count);
+    LumPositionOverride* override_copy = NULL;
+    if (override_count > 0) {
+        override_copy = (LumPositionOverride*)malloc(sizeof(LumPositionOverride) * override_count);
+    }
+    if (!run_copy || (override_count > 0 && !override_copy)) {
+        free(run_copy);
+        free(override_copy);
+        return -1;
+    }
+
+    memcpy(run_copy, runs, sizeof(LumTypeRun) * run_count);
+    if (override_copy) {
+        memcpy(override_copy, overrides, sizeof(LumPositionOverride) * override_count);
+    }
+    free(hybrid->type_runs);
+    free(hybrid->overrides);
+    hybrid->type_runs = run_copy;
+    hybrid->type_run_count = run_count;
+    hybrid->overrides = override_copy;
+    hybrid->override_count = override_count;
+    return 0;
+}
+
+/**
+ * Hybrid copy of a packed group, one container per 1024 words
+ */
+LUMGroup* hybrid_from_packed(const LUMGroup* source) {
+    if (!source || source->storage != LUM_STORAGE_PACKED || !source->packed) {
+        return NULL;
+    }
+
+    const LumPackedStorage* packed = source->packed;
+    LUMGroup* result = create_hybrid_lum_group(source->count, source->group_type);
+    uint64_t* words = (uint64_t*)malloc(sizeof(uint64_t) * CONTAINER_WORDS);
+    if (!result || !words ||
+        hybrid_copy_metadata(result, packed->type_runs, packed->type_run_count,
+                             packed->overrides, packed->override_count) != 0) {
+        LOG_ERROR("Memory allocation failed converting %zu packed LUMs", source->count);
+        free(words);
+        free_lum_group(result);
+        return NULL;
+    }
+
+    for (size_t k = 0; k < result->hybrid->container_count; k++) {
+        size_t first = k * CONTAINER_WORDS;
+        size_t n = packed->word_count - first < CONTAINER_WORDS ? packed->word_count - first : CONTAINER_WORDS;
+        memset(words, 0, sizeof(uint64_t) * CONTAINER_WORDS);
+        memcpy(words, packed->words + first, sizeof(uint64_t) * n);
+        if (container_from_words(&result->hybrid->containers[k], words) != 0) {
+            free(words);
+            free_lum_group(result);
+            return NULL;
+        }
+    }
+
+    free(words);
+    result->layout = source->layout;
+    return result;
+}
+
+LUMGroup* hybrid_from_dense(const LUMGroup* source) {
+    if (!source) {
+        return NULL;
+    }
+    if (source->storage == LUM_STORAGE_HYBRID) {
+        return hybrid_clone(source);
+    }
+    if (source->storage == LUM_STORAGE_PACKED) {
+        return hybrid_from_packed(source);
+    }
+
+    LUMGroup* packed = packed_from_dense(source);
+    LUMGroup* result = hybrid_from_packed(packed);
+    free_lum_group(packed);
+    return result;
+}
+
+/**
+ * Packed copy of a hybrid group
+ */
+LUMGroup* hybrid_to_packed(const LUMGroup* source) {
+    if (!source || source->storage != LUM_STORAGE_HYBRID || !source->hybrid) {
+        return NULL;
+    }
+
+    const LumHybridStorage* hybrid = source->hybrid;
+    LUMGroup* result = create_packed_lum_group(source->count, source->group_type);
+    LumTypeRun* runs = (LumTypeRun*)malloc(sizeof(LumTypeRun) * hybrid->type_run_count);
+    LumPositionOverride* overrides = NULL;
+    if (hybrid->override_count > 0) {
+        overrides = (LumPositionOverride*)malloc(sizeof(LumPositionOverride) * hybrid->override_count);
+    }
+    if (!result || !runs || (hybrid->override_count > 0 && !overrides)) {
+        free(runs);
+        free(overrides);
+        free_lum_group(result);
+        return NULL;
+    }
+
+    LumPackedStorage* packed = result->packed;
+    for (size_t k = 0; k < hybrid->container_count; k++) {
+        const LumContainer* c = &hybrid->containers[k];
+        uint64_t* words = packed->words + k * CONTAINER_WORDS;
+        size_t n = packed->word_count - k * CONTAINER_WORDS;
+        if (c->kind == LUM_CONTAINER_BITMAP) {
+            memcpy(words, c->data.words, sizeof(uint64_t) * (n < CONTAINER_WORDS ? n : CONTAINER_WORDS));
+        } else if (c->kind == LUM_CONTAINER_RUN) {
+            for (uint32_t r = 0; r < c->size; r++) {
+                words_set_range(words, c->data.runs[r].start,
+                                (size_t)c->data.runs[r].last - c->data.runs[r].start + 1);
+            }
+        } else {
+            for (uint32_t i = 0; i < c->size; i++) {
+                words[c->data.values[i] / 64] |= 1ULL << (c->data.values[i] % 64);
+            }
+        }
+    }
+
+    memcpy(runs, hybrid->type_runs, sizeof(LumTypeRun) * hybrid->type_run_count);
+    if (overrides) {
+        memcpy(overrides, hybrid->overrides, sizeof(LumPositionOverride) * hybrid->override_count);
+    }
+    free(packed->type_runs);
+    packed->type_runs = runs;
+    packed->type_run_count = hybrid->type_run_count;
+    packed->overrides = overrides;
+    packed->override_count = hybrid->override_count;
+    result->layout = source->layout;
+    return result;
+}
+
+/**
+ * Deep copy of a hybrid group
+ */
+LUMGroup* hybrid_clone(const LUMGroup* source) {
+    if (!source || source->storage != LUM_STORAGE_HYBRID || !source->hybrid) {
+        return NULL;
+    }
+
+    const LumHybridStorage* hybrid = source->hybrid;
+    LUMGroup* result = create_hybrid_lum_group(source->count, source->group_type);
+    if (!result ||
+        hybrid_copy_metadata(result, hybrid->type_runs, hybrid->type_run_count,
+                             hybrid->overrides, hybrid->override_count) != 0) {
+        free_lum_group(result);
+        return NULL;
+    }
+
+    for (size_t k = 0; k < hybrid->container_count; k++) {
+        if (container_copy(&result->hybrid->containers[k], &hybrid->containers[k]) != 0) {
+            free_lum_group(result);
+            return NULL;
+        }
+    }
+    result->layout = source->layout;
+    return result;
+}
+
+/**
+ * Convert any group to hybrid containers in place
+ */
+int lum_group_to_hybrid(LUMGroup* group) {
+    if (!group) {
+        return -1;
+    }
+    if (group->storage == LUM_STORAGE_HYBRID) {
+        return 0;
+    }
+
+    LUMGroup* hybrid_group = hybrid_from_dense(group);
+    if (!hybrid_group) {
+        return -1;
+    }
+
+    lum_group_release_storage(group);
+    group->storage = LUM_STORAGE_HYBRID;
+    group->hybrid = hybrid_group->hybrid;
+    group->layout = hybrid_group->layout;
+
+    hybrid_group->hybrid = NULL;
+    free(hybrid_group);
+    return 0;
+}
+
+int lum_group_from_hybrid(LUMGroup* group) {
+    if (!group) {
+        return -1;
+    }
+    if (group->storage != LUM_STORAGE_HYBRID) {
+        return group->storage == LUM_STORAGE_PACKED ? 0 : -1;
+    }
+
+    LUMGroup* packed_group = hybrid_to_packed(group);
+    if (!packed_group) {
+        return -1;
+    }
+
+    lum_group_release_storage(group);
+    group->storage = LUM_STORAGE_PACKED;
+    group->packed = packed_group->packed;
+
+    packed_group->packed = NULL;
+    free(packed_group);
+    return 0;
+}
+
+int hybrid_optimize(LUMGroup* group) {
+    if (!group || !group->hybrid) {
+        return -1;
+    }
+    int hash_cached = group->hash_cached; // Same LUMs, other containers
+    if (lum_group_detach(group) != 0) {
+        return -1;
+    }
+    group->hash_cached = hash_cached;
+
+    uint64_t* words = (uint64_t*)malloc(sizeof(uint64_t) * CONTAINER_WORDS);
+    if (!words) {
+        return -1;
+    }
+    for (size_t k = 0; k < group->hybrid->container_count; k++) {
+        container_to_words(&group->hybrid->containers[k], words);
+        if (container_from_words(&group->hybrid->containers[k], words) != 0) {
+            free(words);
+            return -1;
+        }
+    }
+    free(words);
+    return 0;
+}
+
+// ===== Element access =====
+
+uint8_t hybrid_get_presence(const LUMGroup* group, size_t index) {
+    if (!group || !group->hybrid || index >= group->count) {
+        return 0;
+    }
+    return (uint8_t)container_contains(&group->hybrid->containers[index >> LUM_CONTAINER_BITS],
+                                       (uint32_t)(index & (LUM_CONTAINER_SIZE - 1)));
+}
+
+/**
+ * Set or clear one LUM. Indices set in increasing order append to the
+ * index list; containers are re-encoded by hybrid_optimize.
+ */
+int hybrid_set_presence(LUMGroup* group, size_t index, uint8_t presence) {
+    if (!group || !group->hybrid || index >= group->count) {
+        return -1;
+    }
+
+    LumContainer* c = &group->hybrid->containers[index >> LUM_CONTAINER_BITS];
+    uint32_t value = (uint32_t)(index & (LUM_CONTAINER_SIZE - 1));
+    if (container_contains(c, value) == (presence != 0)) {
+        return 0;
+    }
+    // A cached hash only changes by the term of this LUM's word
+    int rehash = group->hash_cached;
+    uint64_t word_before = rehash ? lum_group_hash_words(group, index / 64, index / 64 + 1) : 0;
+    // Shared containers are copied before the first change
+    if (group->owner) {
+        if (lum_group_detach(group) != 0) {
+            return -1;
+        }
+        group->hash_cached = rehash; // Updated below
+        c = &group->hybrid->containers[index >> LUM_CONTAINER_BITS];
+    }
+
+    if (c->kind == LUM_CONTAINER_RUN ||
+        (c->kind == LUM_CONTAINER_ARRAY && presence && c->size == LUM_CONTAINER_ARRAY_MAX)) {
+        if (container_to_bitmap(c) != 0) {
+            return -1;
+        }
+    }
+
+    if (c->kind == LUM_CONTAINER_BITMAP) {
+        c->data.words[value / 64] ^= 1ULL << (value % 64);
+    } else if (presence) {
+        if (c->size == c->capacity) {
+            uint32_t new_capacity = c->capacity ? c->capacity * 2 : 16;
+            uint16_t* grown = (uint16_t*)realloc(c->data.values, sizeof(uint16_t) * new_capacity);
+            if (!grown) {
+                return -1;
+            }
+            c->data.values = grown;
+            c->capacity = new_capacity;
+        }
+        uint32_t i = array_lower_bound(c, value);
+        memmove(&c->data.values[i + 1], &c->data.values[i], sizeof(uint16_t) * (c->size - i));
+        c->data.values[i] = (uint16_t)value;
+        c->size++;
+    } else {
+        uint32_t i = array_lower_bound(c, value);
+        memmove(&c->data.values[i], &c->data.values[i + 1], sizeof(uint16_t) * (c->size - i - 1));
+        c->size--;
+    }
+
+    if (presence) {
+        c->cardinality++;
+    } else {
+        c->cardinality--;
+    }
+    if (group->hash_cached) {
+        group->hash_sum += lum_group_hash_words(group, index / 64, index / 64 + 1) - word_before;
+    }
+    return 0;
+}
+
+int hybrid_get_lum(const LUMGroup* group, size_t index, LUM* out) {
+    if (!group || !group->hybrid || !out || index >= group->count) {
+        return -1;
+    }
+
+    out->presence = hybrid_get_presence(group, index);
+    out->structure_type = lum_type_runs_at(group->hybrid->type_runs, group->hybrid->type_run_count, index);
+    out->spatial_data = NULL;
+    return lum_group_position(group, index, &out->position.x, &out->position.y);
+}
+
+int hybrid_expand_range(const LUMGroup* group, size_t start, size_t count, LUM* out) {
+    if (!group || !group->hybrid || (!out && count > 0) ||
+        start > group->count || count > group->count - start) {
+        return -1;
+    }
+
+    const LumHybridStorage* hybrid = group->hybrid;
+    size_t run = 0;
+
+    for (size_t k = 0; k < count; k++) {
+        size_t i = start + k;
+        while (run + 1 < hybrid->type_run_count && hybrid->type_runs[run + 1].start <= i) {
+            run++;
+        }
+
+        out[k].presence = (uint8_t)container_contains(&hybrid->containers[i >> LUM_CONTAINER_BITS],
+                                                      (uint32_t)(i & (LUM_CONTAINER_SIZE - 1)));
+        out[k].structure_type = hybrid->type_runs[run].structure_type;
+        out[k].spatial_data = NULL;
+    }
+    return lum_group_fill_positions_range(group, start, count, 0, 0, out);
+}
+
+size_t hybrid_popcount(const LUMGroup* group) {
+    if (!group || !group->hybrid) {
+        return 0;
+    }
+
+    size_t ones = 0;
+    for (size_t k = 0; k < group->hybrid->container_count; k++) {
+        ones += group->hybrid->containers[k].cardinality;
+    }
+    return ones;
+}
+
+int hybrid_next_run(const LUMGroup* group, size_t from, size_t* start, size_t* length) {
+    if (!group || !group->hybrid || !start || !length) {
+        return -1;
+    }
+
+    const LumHybridStorage* hybrid = group->hybrid;
+    size_t k = from >> LUM_CONTAINER_BITS;
+    uint32_t local = (uint32_t)(from & (LUM_CONTAINER_SIZE - 1));
+
+    for (; k < hybrid->container_count; k++, local = 0) {
+        uint32_t first = container_next_present(&hybrid->containers[k], local);
+        if (first == LUM_CONTAINER_SIZE) {
+            continue;
+        }
+
+        // A run reaching the end of its container may go on in the next ones
+        size_t run_start = (k << LUM_CONTAINER_BITS) + first;
+        uint32_t end = container_next_absent(&hybrid->containers[k], first);
+        while (end == LUM_CONTAINER_SIZE && k + 1 < hybrid->container_count &&
+               container_contains(&hybrid->containers[k + 1], 0)) {
+            k++;
+            end = container_next_absent(&hybrid->containers[k], 0);
+        }
+
+        *start = run_start;
+        *length = (k << LUM_CONTAINER_BITS) + end - run_start;
+        return 0;
+    }
+    return -1;
+}
+
+void hybrid_extract_words(const LUMGroup* group, size_t start, size_t count, uint64_t* out) {
+    if (!out) {
+        return;
+    }
+    memset(out, 0, sizeof(uint64_t) * ((count + 63) / 64));
+
+    size_t end = start + count;
+    size_t run_start, run_length;
+    size_t from = start;
+    while (from < end && hybrid_next_run(group, from, &run_start, &run_length) == 0 && run_start < end) {
+        size_t run_end = run_start + run_length < end ? run_start + run_length : end;
+        words_set_range(out, run_start - start, run_end - run_start);
+        from = run_end;
+    }
+}
+
+int hybrid_equal(const LUMGroup* group1, const LUMGroup* group2) {
+    if (!group1 || !group2 || !group1->hybrid || !group2->hybrid || group1->count != group2->count) {
+        return 0;
+    }
+
+    // Runs are maximal, so equal bits mean equal run sequences
+    size_t from = 0;
+    for (;;) {
+        size_t start1, length1, start2, length2;
+        int found1 = hybrid_next_run(group1, from, &start1, &length1) == 0;
+        int found2 = hybrid_next_run(group2, from, &start2, &length2) == 0;
+        if (found1 != found2) {
+            return 0;
+        }
+        if (!found1) {
+            return 1;
+        }
+        if (start1 != start2 || length1 != length2) {
+            return 0;
+        }
+        from = start1 + length1;
+    }
+}
+
+/**
+ * Copy presence [src_index, src_index + count) of src to dst from dst_index.
+ * Aligned whole containers are cloned, the rest is appended run by run,
+ * so dst must hold nothing at or after dst_index.
+ */
+static int hybrid_copy_range(LUMGroup* dst, size_t dst_index,
+                             const LUMGroup* src, size_t src_index, size_t count) {
+    while (count >= LUM_CONTAINER_SIZE &&
+           ((src_index | dst_index) & (LUM_CONTAINER_SIZE - 1)) == 0) {
+        if (container_copy(&dst->hybrid->containers[dst_index >> LUM_CONTAINER_BITS],
+                           &src->hybrid->containers[src_index >> LUM_CONTAINER_BITS]) != 0) {
+            return -1;
+        }
+        src_index += LUM_CONTAINER_SIZE;
+        dst_index += LUM_CONTAINER_SIZE;
+        count -= LUM_CONTAINER_SIZE;
+    }
+
+    size_t end = src_index + count;
+    size_t run_start, run_length;
+    size_t from = src_index;
+    while (from < end && hybrid_next_run(src, from, &run_start, &run_length) == 0 && run_start < end) {
+        size_t run_end = run_start + run_length < end ? run_start + run_length : end;
+        size_t position = dst_index + (run_start - src_index);
+        size_t remaining = run_end - run_start;
+
+        while (remaining > 0) {
+            uint32_t local = (uint32_t)(position & (LUM_CONTAINER_SIZE - 1));
+            size_t n = LUM_CONTAINER_SIZE - local < remaining ? LUM_CONTAINER_SIZE - local : remaining;
+            if (container_append_run(&dst->hybrid->containers[position >> LUM_CONTAINER_BITS],
+                                     local, local + (uint32_t)n - 1) != 0) {
+                return -1;
+            }
+            position += n;
+            remaining -= n;
+        }
+        from = run_end;
+    }
+    return 0;
+}
+
+// ===== VORAX operations =====
+
+/**
+ * Overrides for b's LUMs appended after a->count LUMs laid out with
+ * result->layout, compared a chunk of positions at a time
+ */
+static int hybrid_fusion_overrides(LUMGroup* result, size_t* capacity,
+                                   const LUMGroup* a, const LUMGroup* b, int shift_x) {
+    LumHybridStorage* out = result->hybrid;
+    const LumHybridStorage* hb = b->hybrid;
+    LumLayout shifted = b->layout;
+    shifted.offset_x += shift_x;
+
+    size_t chunk = b->layout.kind == LUM_LAYOUT_SPIRAL || result->layout.kind == LUM_LAYOUT_SPIRAL ?
+        b->count : HYBRID_POSITION_CHUNK;
+    LUM* actual = (LUM*)malloc(sizeof(LUM) * chunk * 2);
+    if (!actual) {
+        return -1;
+    }
+    LUM* expected = actual + chunk;
+    size_t next_override = 0;
+
+    for (size_t start = 0; start < b->count; start += chunk) {
+        size_t n = b->count - start < chunk ? b->count - start : chunk;
+        lum_layout_fill(&shifted, start, n, actual);
+        for (; next_override < hb->override_count && hb->overrides[next_override].index < start + n;
+             next_override++) {
+            LUM* lum = &actual[hb->overrides[next_override].index - start];
+            lum->position.x = hb->overrides[next_override].x + shifted.offset_x;
+            lum->position.y = hb->overrides[next_override].y + shifted.offset_y;
+        }
+        lum_layout_fill(&result->layout, a->count + start, n, expected);
+
+        for (size_t j = 0; j < n; j++) {
+            if ((actual[j].position.x != expected[j].position.x ||
+                 actual[j].position.y != expected[j].position.y) &&
+                lum_overrides_push(&out->overrides, &out->override_count, capacity, a->count + start + j,
+                                   actual[j].position.x - result->layout.offset_x,
+                                   actual[j].position.y - result->layout.offset_y) != 0) {
+                free(actual);
+                return -1;
+            }
+        }
+    }
+
+    free(actual);
+    return 0;
+}
+
+/**
+ * Hybrid Fusion (⧉): container concatenation, same semantics as lum_fusion.
+ * Runs of the second group are appended at a->count without going
+ * through a bitmap of the whole group.
+ */
+LUMGroup* hybrid_lum_fusion(LUMGroup* group1, LUMGroup* group2) {
+    if (!group1 || !group2) {
+        LOG_ERROR("Invalid input groups for hybrid_lum_fusion");
+        return NULL;
+    }
+
+    // Mixed storage: convert the other operand into a temporary
+    LUMGroup* temp1 = group1->storage == LUM_STORAGE_HYBRID ? NULL : hybrid_from_dense(group1);
+    LUMGroup* temp2 = group2->storage == LUM_STORAGE_HYBRID ? NULL : hybrid_from_dense(group2);
+    LUMGroup* a = temp1 ? temp1 : group1;
+    LUMGroup* b = temp2 ? temp2 : group2;
+    LUMGroup* result = NULL;
+
+    if (a->storage != LUM_STORAGE_HYBRID || b->storage != LUM_STORAGE_HYBRID) {
+        LOG_ERROR("Failed to convert operands for hybrid_lum_fusion");
+        goto cleanup;
+    }
+
+    const LumHybridStorage* ha = a->hybrid;
+    const LumHybridStorage* hb = b->hybrid;
+    size_t total_count = a->count + b->count;
+    int shift_x = lum_fusion_shift(a->count);
+
+    result = create_hybrid_lum_group(total_count, GROUP_CLUSTER);
+    if (!result) {
+        LOG_ERROR("Failed to create fused hybrid LUM group");
+        goto cleanup;
+    }
+    LumHybridStorage* out = result->hybrid;
+
+    if (hybrid_copy_range(result, 0, a, 0, a->count) != 0 ||
+        hybrid_copy_range(result, a->count, b, 0, b->count) != 0 ||
+        hybrid_optimize(result) != 0) {
+        goto fail;
+    }
+
+    size_t run_capacity = 1;
+    out->type_run_count = 0;
+    for (size_t r = 0; r < ha->type_run_count && a->count > 0; r++) {
+        if (lum_type_runs_push(&out->type_runs, &out->type_run_count, &run_capacity,
+                               ha->type_runs[r].start, ha->type_runs[r].structure_type) != 0) {
+            goto fail;
+        }
+    }
+    if (b->count > 0 &&
+        lum_type_runs_push(&out->type_runs, &out->type_run_count, &run_capacity, a->count, LUM_GROUP) != 0) {
+        goto fail;
+    }
+    if (out->type_run_count == 0) {
+        out->type_runs[0].structure_type = LUM_LINEAR;
+        out->type_run_count = 1;
+    }
+
+    size_t override_capacity = 0;
+    for (size_t i = 0; i < ha->override_count; i++) {
+        if (lum_overrides_push(&out->overrides, &out->override_count, &override_capacity,
+                               ha->overrides[i].index, ha->overrides[i].x, ha->overrides[i].y) != 0) {
+            goto fail;
+        }
+    }
+
+    if (lum_layout_concat(&a->layout, a->count, &b->layout, shift_x, &result->layout) == 0) {
+        // Second operand lines up with the fused layout: rebase its overrides only
+        int rebase_x = b->layout.offset_x + shift_x - result->layout.offset_x;
+        int rebase_y = b->layout.offset_y - result->layout.offset_y;
+        for (size_t i = 0; i < hb->override_count; i++) {
+            if (lum_overrides_push(&out->overrides, &out->override_count, &override_capacity,
+                                   hb->overrides[i].index + a->count,
+                                   hb->overrides[i].x + rebase_x, hb->overrides[i].y + rebase_y) != 0) {
+                goto fail;
+            }
+        }
+    } else {
+        // Keep the first operand's layout, store the second one's deviations
+        result->layout = a->layout;
+        if (b->count > 0 && hybrid_fusion_overrides(result, &override_capacity, a, b, shift_x) != 0) {
+            goto fail;
+        }
+    }
+    goto cleanup;
+
+fail:
+    LOG_ERROR("Memory allocation failed in hybrid_lum_fusion");
+    free_lum_group(result);
+    result = NULL;
+
+cleanup:
+    free_lum_group(temp1);
+    free_lum_group(temp2);
+    return result;
+}
+
+/**
+ * Hybrid Split (⇅): each zone receives a LUM range laid out at y = zone * 50
+ */
+LUMGroup** hybrid_lum_split(LUMGroup* source, int zones, size_t* result_count) {
+    if (!source || !source->hybrid || zones <= 0 || !result_count) {
+        if (result_count) *result_count = 0;
+        LOG_ERROR("Invalid input for hybrid_lum_split");
+        return NULL;
+    }
+
+    LUMGroup** result = (LUMGroup**)malloc(sizeof(LUMGroup*) * zones);
+    if (!result) {
+        *result_count = 0;
+        LOG_ERROR("Memory allocation failed for split result array");
+        return NULL;
+    }
+
+    size_t lums_per_zone = source->count / zones;
+    size_t remainder = source->count % zones;
+    size_t current_index = 0;
+
+    for (int i = 0; i < zones; i++) {
+        size_t zone_count = lums_per_zone + ((size_t)i < remainder ? 1 : 0);
+
+        result[i] = create_hybrid_lum_group(zone_count, GROUP_LINEAR);
+        if (!result[i] ||
+            hybrid_copy_range(result[i], 0, source, current_index, zone_count) != 0 ||
+            hybrid_optimize(result[i]) != 0) {
+            LOG_ERROR("Failed to create hybrid LUM group for zone %d", i);
+            free_split_result(result, (size_t)i + (result[i] ? 1 : 0));
+            *result_count = 0;
+            return NULL;
+        }
+        result[i]->layout = lum_layout_linear(0, i * 50, 20);
+        current_index += zone_count;
+    }
+
+    *result_count = zones;
+    return result;
+}
+
+/**
+ * Hybrid Cycle (⟲): keeps a LUM prefix laid out on a circle
+ */
+LUMGroup* hybrid_lum_cycle(LUMGroup* source, int modulo) {
+    if (!source || !source->hybrid || modulo <= 0) {
+        LOG_ERROR("Invalid input for hybrid_lum_cycle");
+        return NULL;
+    }
+
+    size_t result_count_raw = source->count % modulo;
+
+    if (result_count_raw == 0) {
+        // Single present LUM at the origin, as in the dense cycle
+        LUMGroup* result = create_hybrid_lum_group(1, GROUP_NODE);
+        if (!result || hybrid_set_presence(result, 0, 1) != 0) {
+            free_lum_group(result);
+            return NULL;
+        }
+        result->hybrid->type_runs[0].structure_type = LUM_CYCLE;
+        return result;
+    }
+
+    LUMGroup* result = create_hybrid_lum_group(result_count_raw, GROUP_NODE);
+    if (!result ||
+        hybrid_copy_range(result, 0, source, 0, result_count_raw) != 0 ||
+        hybrid_optimize(result) != 0) {
+        LOG_ERROR("Memory allocation failed for %zu LUMs in hybrid_lum_cycle", result_count_raw);
+        free_lum_group(result);
+        return NULL;
+    }
+
+    result->hybrid->type_runs[0].structure_type = LUM_CYCLE;
+    result->layout = lum_layout_circle(50, 50, 30, result_count_raw);
+
+    return result;
+}
+
+/**
+ * Hybrid Flow (→): copies the containers and moves the layout offset by 100
+ */
+LUMGroup* hybrid_lum_flow(LUMGroup* source, const char* target_zone) {
+    if (!source || !source->hybrid || !target_zone) {
+        LOG_ERROR("Invalid input for hybrid_lum_flow");
+        return NULL;
+    }
+
+    LUMGroup* result = hybrid_clone(source);
+    if (!result) {
+        LOG_ERROR("Failed to create LUM group for hybrid flow operation");
+        return NULL;
+    }
+
+    lum_group_translate(result, 100, 0);
+    result->hybrid->type_runs[0].structure_type = LUM_LINEAR; // Reset to linear for flow
+    result->hybrid->type_run_count = 1;
+
+    char* target = (char*)malloc(strlen(target_zone) + 1);
+    if (target) {
+        strcpy(target, target_zone);
+        result->spatial_data = target;
+    } else {
+        LOG_ERROR("Memory allocation failed for spatial_data in hybrid_lum_flow");
+    }
+
+    return result;
+}
@@ -0,0 +1,40 @@
+#ifndef HYBRID_H
+#define HYBRID_H
+
+#include "lums.h"
+
+// Hybrid group management
+LUMGroup* create_hybrid_lum_group(size_t count, GroupType type);
+LUMGroup* hybrid_from_packed(const LUMGroup* source);
+// Any other storage, through a temporary packed copy (per-LUM spatial data is dropped)
+LUMGroup* hybrid_from_dense(const LUMGroup* source);
+LUMGroup* hybrid_to_packed(const LUMGroup* source);
+LUMGroup* hybrid_clone(const LUMGroup* source);
+void free_hybrid_storage(LumHybridStorage* hybrid);
+int lum_group_to_hybrid(LUMGroup* group);
+// Back to packed storage, in place
+int lum_group_from_hybrid(LUMGroup* group);
+// Re-pick the smallest representation of every container
+int hybrid_optimize(LUMGroup* group);
+
+// Element access
+uint8_t hybrid_get_presence(const LUMGroup* group, size_t index);
+int hybrid_set_presence(LUMGroup* group, size_t index, uint8_t presence);
+int hybrid_get_lum(const LUMGroup* group, size_t index, LUM* out);
+// LUMs [start, start + count) into out[0 .. count), positions filled per range
+int hybrid_expand_range(const LUMGroup* group, size_t start, size_t count, LUM* out);
+size_t hybrid_popcount(const LUMGroup* group);
+// First run of present LUMs at or after from, 0 if found, -1 otherwise
+int hybrid_next_run(const LUMGroup* group, size_t from, size_t* start, size_t* length);
+// Presence bits [start, start + count) into out, bit k in out[k / 64]
+void hybrid_extract_words(const LUMGroup* group, size_t start, size_t count, uint64_t* out);
+// 1 if both groups have the same presence bits
+int hybrid_equal(const LUMGroup* group1, const LUMGroup* group2);
+
+// Hybrid VORAX operations (dispatched from operations.c, other storages accepted)
+LUMGroup* hybrid_lum_fusion(LUMGroup* group1, LUMGroup* group2);
+LUMGroup** hybrid_lum_split(LUMGroup* source, int zones, size_t* result_count);
+LUMGroup* hybrid_lum_cycle(LUMGroup* source, int modulo);
+LUMGroup* hybrid_lum_flow(LUMGroup* source, const char* target_zone);
+
+#endif // HYBRID_H
@@ -0,0 +1,548 @@
+#include "lums.h"
+#include "layout.h"
+#include "view.h"
+#include "pool.h"
+#include <stdint.h>
+#include <limits.h>
+#include <string.h>
+#include <math.h>
+
+// Same constant as the cycle / organic fusion operations, keeps positions bit-identical
+#define LAYOUT_PI 3.14159265359
+#define LAYOUT_TRIG_WEIGHT 16 // A cos/sin pair costs about as much as copying 16 LUMs
+#define SPIRAL_CHECKPOINT 256 // Initial steps between stored spiral states: the most a seek walks
+#define SPIRAL_CHECKPOINTS 512 // States a thread keeps, twice as far apart each time they run out
+
+LumLayout lum_layout_explicit(void) {
+    LumLayout layout;
+    memset(&layout, 0, sizeof(layout));
+    layout.kind = LUM_LAYOUT_EXPLICIT;
+    return layout;
+}
+
+LumLayout lum_layout_linear(int origin_x, int origin_y, int stride) {
+    LumLayout layout = lum_layout_explicit();
+    layout.kind = LUM_LAYOUT_LINEAR;
+    layout.offset_x = origin_x;
+    layout.offset_y = origin_y;
+    layout.stride = stride;
+    return layout;
+}
+
+LumLayout lum_layout_grid(int origin_x, int origin_y, int stride, size_t row_length, int row_spacing) {
+    if (row_length == 0) {
+        return lum_layout_linear(origin_x, origin_y, stride);
+    }
+    LumLayout layout = lum_layout_linear(origin_x, origin_y, stride);
+    layout.kind = LUM_LAYOUT_GRID;
+    layout.row_length = row_length;
+    layout.row_spacing = row_spacing;
+    return layout;
+}
+
+LumLayout lum_layout_circle(int center_x, int center_y, int radius, size_t period) {
+    LumLayout layout = lum_layout_explicit();
+    layout.kind = LUM_LAYOUT_CIRCLE;
+    layout.center_x = center_x;
+    layout.center_y = center_y;
+    layout.radius = radius;
+    layout.period = period > 0 ? period : 1;
+    return layout;
+}
+
+LumLayout lum_layout_spiral(double angle_step, int radius_step) {
+    LumLayout layout = lum_layout_explicit();
+    layout.kind = LUM_LAYOUT_SPIRAL;
+    layout.angle_step = angle_step;
+    layout.radius = radius_step;
+    return layout;
+}
+
+typedef struct {
+    double angle;
+    int radius;
+} SpiralState;
+
+typedef struct {
+    const LumLayout* layout;
+    size_t start;
+    size_t count;
+    SpiralState state;  // Spiral state at start
+    LUM* out;
+} LayoutChunk;
+
+// Last spiral position computed by this thread, forward seeks resume from it,
+// and the states every checkpoint_spacing indices walked so far for the same
+// spiral: a fixed table, long spirals spread it instead of growing it
+static __thread struct {
+    int valid;
+    double angle_step;
+    int radius_step;
+    size_t index;
+    SpiralState state;
+    SpiralState checkpoints[SPIRAL_CHECKPOINTS];   // State at index k * checkpoint_spacing
+    size_t checkpoint_count;
+    size_t checkpoint_spacing;                     // SPIRAL_CHECKPOINT << n, 0 before the first seek
+} spiral_cache;
+
+/**
+ * Organic fusion spiral: the angle wraps at 2pi and the radius grows by
+ * radius_step on every wrap. Additions only, in the original order, so
+ * every chunk sees the exact angles of a walk from index 0.
+ */
+static void spiral_step(const LumLayout* layout, SpiralState* state) {
+    state->angle += layout->angle_step;
+    if (state->angle > 2 * LAYOUT_PI) {
+        state->angle = fmod(state->angle, 2 * LAYOUT_PI);
+        state->radius += layout->radius;
+    }
+}
+
+/**
+ * Records state at index if it is the next checkpoint. A full table keeps
+ * every other state and doubles the spacing.
+ */
+static void spiral_checkpoint(size_t index, SpiralState state) {
+    size_t spacing = spiral_cache.checkpoint_spacing;
+    if (index % spacing != 0 || index / spacing != spiral_cache.checkpoint_count) {
+        return;
+    }
+    if (spiral_cache.checkpoint_count == SPIRAL_CHECKPOINTS) {
+        for (size_t k = 0; k < SPIRAL_CHECKPOINTS / 2; k++) {
+            spiral_cache.checkpoints[k] = spiral_cache.checkpoints[2 * k];
+        }
+        spiral_cache.checkpoint_count = SPIRAL_CHECKPOINTS / 2;
+        spiral_cache.checkpoint_spacing = spacing * 2; // index is now the next one
+    }
+    spiral_cache.checkpoints[spiral_cache.checkpoint_count++] = state;
+}
+
+/**
+ * State at index: walks from the closest checkpoint or remembered position
+ * before it, so once the range was walked any seek takes at most the
+ * checkpoint spacing in steps (256 up to 128K indices, 1/512 of the walked
+ * range beyond), backwards and random access included
+ */
+static SpiralState spiral_seek(const LumLayout* layout, size_t index) {
+    if (spiral_cache.checkpoint_spacing == 0 ||
+        spiral_cache.angle_step != layout->angle_step || spiral_cache.radius_step != layout->radius) {
+        spiral_cache.valid = 0;
+        spiral_cache.checkpoint_count = 0; // Another spiral
+        spiral_cache.checkpoint_spacing = SPIRAL_CHECKPOINT;
+        spiral_cache.angle_step = layout->angle_step;
+        spiral_cache.radius_step = layout->radius;
+    }
+
+    SpiralState state = {0, 0};
+    size_t i = 0;
+    size_t known = spiral_cache.checkpoint_count;
+    size_t spacing = spiral_cache.checkpoint_spacing;
+    if (known > 0) {
+        size_t k = index / spacing < known ? index / spacing : known - 1;
+        state = spiral_cache.checkpoints[k];
+        i = k * spacing;
+    }
+    if (spiral_cache.valid && spiral_cache.index <= index && spiral_cache.index > i) {
+        state = spiral_cache.state;
+        i = spiral_cache.index;
+    }
+    for (; i < index; i++) {
+        spiral_checkpoint(i, state);
+        spiral_step(layout, &state);
+    }
+    spiral_checkpoint(index, state);
+    return state;
+}
+
+static void spiral_remember(size_t index, SpiralState state) {
+    spiral_cache.valid = 1;
+    spiral_cache.index = index;
+    spiral_cache.state = state;
+}
+
+static void spiral_fill_chunk(LayoutChunk* chunk) {
+    const LumLayout* layout = chunk->layout;
+    SpiralState state = chunk->state;
+
+    for (size_t k = 0; k < chunk->count; k++) {
+        chunk->out[k].position.x = layout->offset_x + (int)(state.radius * cos(state.angle));
+        chunk->out[k].position.y = layout->offset_y + (int)(state.radius * sin(state.angle));
+        spiral_step(layout, &state);
+    }
+    chunk->state = state;
+}
+
+static void circle_fill_chunk(LayoutChunk* chunk) {
+    const LumLayout* layout = chunk->layout;
+    double angle_step = 2.0 * LAYOUT_PI / layout->period;
+
+    for (size_t k = 0; k < chunk->count; k++) {
+        double angle = (chunk->start + k) * angle_step;
+        chunk->out[k].position.x = layout->offset_x + (int)(layout->center_x + layout->radius * cos(angle));
+        chunk->out[k].position.y = layout->offset_y + (int)(layout->center_y + layout->radius * sin(angle));
+    }
+}
+
+static void layout_fill_chunk(void* context, size_t task) {
+    LayoutChunk* chunk = (LayoutChunk*)context + task;
+    if (chunk->layout->kind == LUM_LAYOUT_SPIRAL) {
+        spiral_fill_chunk(chunk);
+    } else {
+        circle_fill_chunk(chunk);
+    }
+}
+
+/**
+ * Trig layouts: equal chunks, one per pool thread for large ranges. Spiral chunk
+ * states come from one serial pass of additions before the threads start.
+ */
+static void trig_fill(const LumLayout* layout, size_t start, size_t count, LUM* out) {
+    size_t thread_count = lum_parallel_threads(count * LAYOUT_TRIG_WEIGHT);
+    LayoutChunk chunks[LUM_POOL_MAX_THREADS];
+    SpiralState state = {0, 0};
+
+    if (layout->kind == LUM_LAYOUT_SPIRAL) {
+        state = spiral_seek(layout, start);
+    }
+    for (size_t t = 0; t < thread_count; t++) {
+        size_t first, last;
+        lum_parallel_chunk(count, thread_count, t, &first, &last);
+        chunks[t] = (LayoutChunk){layout, start + first, last - first, state, out + first};
+        if (layout->kind == LUM_LAYOUT_SPIRAL) {
+            for (size_t k = first; k < last; k++) {
+                spiral_checkpoint(start + k, state);
+                spiral_step(layout, &state);
+            }
+        }
+    }
+
+    lum_parallel_run(thread_count, layout_fill_chunk, chunks);
+
+    if (layout->kind == LUM_LAYOUT_SPIRAL) {
+        spiral_remember(start + count, state);
+    }
+}
+
+/**
+ * origin + index * step without int overflow. Past 2^32 steps any non-zero
+ * step is out of the int range, so index is capped there and the int64 sum
+ * cannot overflow either.
+ */
+static int64_t layout_offset(int origin, size_t index, int step) {
+    int64_t steps = index > UINT32_MAX ? (int64_t)UINT32_MAX + 1 : (int64_t)index;
+    return origin + steps * step;
+}
+
+/**
+ * Coordinates beyond the int range stick to its bounds
+ */
+static int clamp_coord(int64_t value) {
+    return value > INT_MAX ? INT_MAX : value < INT_MIN ? INT_MIN : (int)value;
+}
+
+static int layout_coord(int origin, size_t index, int step) {
+    return clamp_coord(layout_offset(origin, index, step));
+}
+
+void lum_layout_position(const LumLayout* layout, size_t index, int* x, int* y) {
+    switch (layout->kind) {
+        case LUM_LAYOUT_LINEAR:
+            *x = layout_coord(layout->offset_x, index, layout->stride);
+            *y = layout->offset_y;
+            return;
+        case LUM_LAYOUT_GRID:
+            *x = layout_coord(layout->offset_x, index % layout->row_length, layout->stride);
+            *y = layout_coord(layout->offset_y, index / layout->row_length, layout->row_spacing);
+            return;
+        case LUM_LAYOUT_CIRCLE:
+        case LUM_LAYOUT_SPIRAL: {
+            LUM lum;
+            trig_fill(layout, index, 1, &lum);
+            *x = lum.position.x;
+            *y = lum.position.y;
+            return;
+        }
+        case LUM_LAYOUT_EXPLICIT:
+        default:
+            *x = layout->offset_x;
+            *y = layout->offset_y;
+            return;
+    }
+}
+
+void lum_layout_fill(const LumLayout* layout, size_t start, size_t count, LUM* out) {
+    switch (layout->kind) {
+        case LUM_LAYOUT_LINEAR: {
+            int64_t x = layout_offset(layout->offset_x, start, layout->stride);
+            for (size_t k = 0; k < count; k++, x += layout->stride) {
+                out[k].position.x = clamp_coord(x);
+                out[k].position.y = layout->offset_y;
+            }
+            return;
+        }
+        case LUM_LAYOUT_GRID: {
+            // Running column / row instead of a div/mod per LUM
+            size_t column = start % layout->row_length;
+            int64_t y = layout_offset(layout->offset_y, start / layout->row_length, layout->row_spacing);
+            for (size_t k = 0; k < count; k++) {
+                out[k].position.x = layout_coord(layout->offset_x, column, layout->stride);
+                out[k].position.y = clamp_coord(y);
+                if (++column == layout->row_length) {
+                    column = 0;
+                    y += layout->row_spacing;
+                }
+            }
+            return;
+        }
+        case LUM_LAYOUT_CIRCLE:
+        case LUM_LAYOUT_SPIRAL:
+            trig_fill(layout, start, count, out);
+            return;
+        default:
+            for (size_t k = 0; k < count; k++) {
+                lum_layout_position(layout, start + k, &out[k].position.x, &out[k].position.y);
+            }
+            return;
+    }
+}
+
+int lum_layout_concat(const LumLayout* a, size_t count_a,
+                      const LumLayout* b, int shift_x, LumLayout* out) {
+    if (count_a == 0) {
+        *out = *b;
+        out->offset_x += shift_x;
+        return b->kind == LUM_LAYOUT_EXPLICIT ? -1 : 0;
+    }
+    if (a->kind != LUM_LAYOUT_LINEAR || b->kind != LUM_LAYOUT_LINEAR) {
+        return -1;
+    }
+    // b continues a's row exactly where a stops
+    if (a->stride != b->stride || a->offset_y != b->offset_y ||
+        (int64_t)b->offset_x + shift_x != layout_offset(a->offset_x, count_a, a->stride)) {
+        return -1;
+    }
+    *out = *a;
+    return 0;
+}
+
+int lum_fusion_shift(size_t count) {
+    return layout_coord(0, count, 20);
+}
+
+int lum_layout_slice(const LumLayout* layout, size_t start, LumLayout* out) {
+    *out = *layout;
+    switch (layout->kind) {
+        case LUM_LAYOUT_EXPLICIT:
+            return 0;
+        case LUM_LAYOUT_LINEAR: {
+            // A first LUM outside the int range has no layout to start from
+            int64_t x = layout_offset(layout->offset_x, start, layout->stride);
+            if (x != clamp_coord(x)) {
+                return -1;
+            }
+            out->offset_x = (int)x;
+            return 0;
+        }
+        case LUM_LAYOUT_GRID: {
+            // Only whole rows keep the columns aligned
+            if (start % layout->row_length != 0) {
+                return -1;
+            }
+            int64_t y = layout_offset(layout->offset_y, start / layout->row_length, layout->row_spacing);
+            if (y != clamp_coord(y)) {
+                return -1;
+            }
+            out->offset_y = (int)y;
+            return 0;
+        }
+        default:
+            return start == 0 ? 0 : -1;
+    }
+}
+
+/**
+ * First override at or after index
+ */
+static size_t override_lower_bound(const LumPositionOverride* overrides, size_t count, size_t index) {
+    size_t lo = 0;
+    size_t hi = count;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (overrides[mid].index < index) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * Explicit packed / hybrid position of LUM index, NULL if it follows the layout
+ */
+static const LumPositionOverride* override_at(const LumPositionOverride* overrides, size_t count,
+                                              size_t index) {
+    size_t lo = override_lower_bound(overrides, count, index);
+    if (lo < count && overrides[lo].index == index) {
+        return &overrides[lo];
+    }
+    return NULL;
+}
+
+/**
+ * Override list of a packed or hybrid group, empty for other storages
+ */
+static const LumPositionOverride* group_overrides(const LUMGroup* group, size_t* count) {
+    if (group->storage == LUM_STORAGE_PACKED && group->packed) {
+        *count = group->packed->override_count;
+        return group->packed->overrides;
+    }
+    if (group->storage == LUM_STORAGE_HYBRID && group->hybrid) {
+        *count = group->hybrid->override_count;
+        return group->hybrid->overrides;
+    }
+    *count = 0;
+    return NULL;
+}
+
+int lum_group_layout_complete(const LUMGroup* group) {
+    size_t override_count = 0;
+    if (group) {
+        group_overrides(group, &override_count);
+    }
+    return override_count == 0;
+}
+
+int lum_group_position(const LUMGroup* group, size_t index, int* x, int* y) {
+    if (!group || !x || !y || index >= group->count) {
+        return -1;
+    }
+
+    const LumLayout* layout = &group->layout;
+
+    if (group->storage == LUM_STORAGE_PACKED || group->storage == LUM_STORAGE_HYBRID) {
+        size_t override_count;
+        const LumPositionOverride* overrides = group_overrides(group, &override_count);
+        const LumPositionOverride* override = override_at(overrides, override_count, index);
+        if (override) {
+            *x = layout->offset_x + override->x;
+            *y = layout->offset_y + override->y;
+            return 0;
+        }
+    } else if (layout->kind == LUM_LAYOUT_EXPLICIT && group->storage == LUM_STORAGE_COMPACT) {
+        if (!group->compact) {
+            return -1;
+        }
+        *x = layout->offset_x + group->compact->records[index].x;
+        *y = layout->offset_y + group->compact->records[index].y;
+        return 0;
+    } else if (layout->kind == LUM_LAYOUT_EXPLICIT && group->storage == LUM_STORAGE_SOA) {
+        if (!group->soa || !group->soa->x) {
+            return -1;
+        }
+        *x = layout->offset_x + group->soa->x[index];
+        *y = layout->offset_y + group->soa->y[index];
+        return 0;
+    } else if (layout->kind == LUM_LAYOUT_EXPLICIT) {
+        if (!group->lums) {
+            return -1;
+        }
+        *x = layout->offset_x + group->lums[index].position.x;
+        *y = layout->offset_y + group->lums[index].position.y;
+        return 0;
+    }
+
+    lum_layout_position(layout, index, x, y);
+    return 0;
+}
+
+int lum_group_fill_positions(const LUMGroup* group, int dx, int dy, LUM* out) {
+    return group ? lum_group_fill_positions_range(group, 0, group->count, dx, dy, out) : -1;
+}
+
+int lum_group_fill_positions_range(const LUMGroup* group, size_t start, size_t count,
+                                   int dx, int dy, LUM* out) {
+    if (!group || (!out && count > 0) || start > group->count || count > group->count - start) {
+        return -1;
+    }
+
+    const LumLayout* layout = &group->layout;
+    int ox = clamp_coord((int64_t)layout->offset_x + dx);
+    int oy = clamp_coord((int64_t)layout->offset_y + dy);
+
+    if (group->storage == LUM_STORAGE_DENSE && layout->kind == LUM_LAYOUT_EXPLICIT) {
+        if (!group->lums && count > 0) {
+            return -1;
+        }
+        const LUM* lums = group->lums + start;
+        for (size_t i = 0; i < count; i++) {
+            out[i].position.x = lums[i].position.x + ox;
+            out[i].position.y = lums[i].position.y + oy;
+        }
+        return 0;
+    }
+    if (group->storage == LUM_STORAGE_COMPACT && layout->kind == LUM_LAYOUT_EXPLICIT) {
+        if (!group->compact && count > 0) {
+            return -1;
+        }
+        for (size_t i = 0; i < count; i++) {
+            out[i].position.x = group->compact->records[start + i].x + ox;
+            out[i].position.y = group->compact->records[start + i].y + oy;
+        }
+        return 0;
+    }
+    if (group->storage == LUM_STORAGE_SOA && layout->kind == LUM_LAYOUT_EXPLICIT) {
+        if ((!group->soa || !group->soa->x) && count > 0) {
+            return -1;
+        }
+        for (size_t i = 0; i < count; i++) {
+            out[i].position.x = group->soa->x[start + i] + ox;
+            out[i].position.y = group->soa->y[start + i] + oy;
+        }
+        return 0;
+    }
+
+    LumLayout shifted = *layout;
+    shifted.offset_x = ox;
+    shifted.offset_y = oy;
+    lum_layout_fill(&shifted, start, count, out);
+
+    size_t override_count;
+    const LumPositionOverride* overrides = group_overrides(group, &override_count);
+    for (size_t k = override_lower_bound(overrides, override_count, start);
+         k < override_count && overrides[k].index < start + count; k++) {
+        LUM* lum = &out[overrides[k].index - start];
+        lum->position.x = overrides[k].x + ox;
+        lum->position.y = overrides[k].y + oy;
+    }
+    return 0;
+}
+
+int lum_group_materialize_positions(LUMGroup* group) {
+    if (!group) {
+        return -1;
+    }
+    if (group->storage != LUM_STORAGE_DENSE) {
+        return 0; // Other storages keep positions computable
+    }
+    if (group->layout.kind == LUM_LAYOUT_EXPLICIT &&
+        group->layout.offset_x == 0 && group->layout.offset_y == 0) {
+        return 0;
+    }
+    int hash_cached = group->hash_cached; // Positions only
+    LUM* lums = lum_group_writable(group);
+    if ((!lums && group->count > 0) || lum_group_fill_positions(group, 0, 0, lums) != 0) {
+        return -1;
+    }
+    group->hash_cached = hash_cached;
+    group->layout = lum_layout_explicit();
+    return 0;
+}
+
+void lum_group_translate(LUMGroup* group, int dx, int dy) {
+    if (group) {
+        group->layout.offset_x += dx;
+        group->layout.offset_y += dy;
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include "lums.h"
+
+// Layout descriptors (origin / center given in absolute coordinates)
+LumLayout lum_layout_explicit(void);
+LumLayout lum_layout_linear(int origin_x, int origin_y, int stride);
+LumLayout lum_layout_grid(int origin_x, int origin_y, int stride, size_t row_length, int row_spacing);
+LumLayout lum_layout_circle(int center_x, int center_y, int radius, size_t period);
+LumLayout lum_layout_spiral(double angle_step, int radius_step);
+
+// Position of LUM index, pending offset included (explicit layouts yield the offset)
+// Spirals resume from the thread's last computed index or from one of the 512
+// states it keeps along the range it walked (every 256 indices, spread further
+// apart past 128K), so a seek only walks that far; use lum_layout_fill for ranges.
+void lum_layout_position(const LumLayout* layout, size_t index, int* x, int* y);
+// Positions of LUMs [start, start + count) into out[k].position,
+// large circle / spiral ranges are filled on several threads
+void lum_layout_fill(const LumLayout* layout, size_t start, size_t count, LUM* out);
+// Layout of a (count_a LUMs) followed by b shifted right by shift_x.
+// Returns 0 if the concatenation is a single implicit layout, -1 otherwise.
+int lum_layout_concat(const LumLayout* a, size_t count_a,
+                      const LumLayout* b, int shift_x, LumLayout* out);
+// Fusion shift of a group appended after count LUMs: count * 20, clamped to int
+int lum_fusion_shift(size_t count);
+// Layout of LUMs [start, ...) renumbered from 0.
+// Returns 0 if it is still a single layout, -1 otherwise (circles, spirals).
+int lum_layout_slice(const LumLayout* layout, size_t start, LumLayout* out);
+
+// 1 if the layout alone gives every position (no packed / hybrid overrides)
+int lum_group_layout_complete(const LUMGroup* group);
+// Group positions, whatever the storage and layout
+int lum_group_position(const LUMGroup* group, size_t index, int* x, int* y);
+// Write every position, shifted by (dx, dy), into out[i].position
+int lum_group_fill_positions(const LUMGroup* group, int dx, int dy, LUM* out);
+// Same for LUMs [start, start + count) only, into out[0 .. count)
+int lum_group_fill_positions_range(const LUMGroup* group, size_t start, size_t count,
+                                   int dx, int dy, LUM* out);
+// Store positions in lums[] and switch a dense group to LUM_LAYOUT_EXPLICIT
+int lum_group_materialize_positions(LUMGroup* group);
+// O(1) move of every LUM
+void lum_group_translate(LUMGroup* group, int dx, int dy);
+
+#endif // LAYOUT_H
@@ -1,12 +1,30 @@
 #include "lums.h"
+#include "packed.h"
+#include "layout.h"
+#include "compact.h"
+#include "soa.h"
+#include "hybrid.h"
+#include "view.h"
+#include "arena.h"
+#include "rng.h"
+#include "pool.h"
+#include "reduce.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 
 /**
- * Create a new LUM group
+ * Create a new LUM group owning lums (same as lum_group_adopt)
  */
 LUMGroup* create_lum_group(LUM* lums, size_t count, GroupType type) {
+    return lum_group_adopt(lums, count, type);
+}
+
+/**
+ * Wrap a heap array, freed with the group. On failure lums stays the caller's.
+ */
+LUMGroup* lum_group_adopt(LUM* lums, size_t count, GroupType type) {
     LUMGroup* group = (LUMGroup*)malloc(sizeof(LUMGroup));
     if (!group) return NULL;
     
@@ -17,7 +35,99 @@ LUMGroup* create_lum_group(LUM* lums, size_t count, GroupType type) {
     group->connections = NULL;
     group->connection_count = 0;
     group->spatial_data = NULL;
+    group->storage = LUM_STORAGE_DENSE;
+    group->packed = NULL;
+    group->compact = NULL;
+    group->soa = NULL;
+    group->hybrid = NULL;
+    group->layout = lum_layout_explicit();
+    group->owner = NULL;
+    group->lums_inline = 0;
+    group->arena = NULL;
+    group->uid.hi = 0;
+    group->uid.lo = 0;
+    group->hash_sum = 0;
+    group->hash_cached = 0;
+    
+    return group;
+}
+
+// Header and LUMs in one block: free(group) releases both
+typedef struct {
+    LUMGroup group;
+    LUM lums[];
+} LumSmallGroup;
+
+static LUMGroup* small_group_init(LumSmallGroup* small, size_t count, GroupType type) {
+    LUMGroup* group = &small->group;
+    group->lums = small->lums;
+    group->count = count;
+    group->group_type = type;
+    group->storage = LUM_STORAGE_DENSE;
+    group->layout = lum_layout_explicit();
+    group->lums_inline = 1;
+    return group;
+}
+
+/**
+ * Small group in a single allocation, LUMs cleared
+ */
+LUMGroup* lum_group_create_small(size_t count, GroupType type) {
+    if (count > LUM_INLINE_CAPACITY) return NULL;
+    
+    LumSmallGroup* small = (LumSmallGroup*)calloc(1, sizeof(LumSmallGroup) + sizeof(LUM) * count);
+    if (!small) return NULL;
+    return small_group_init(small, count, type);
+}
+
+/**
+ * Group with room for count LUMs, cleared, the one allocation operations make per result
+ */
+LUMGroup* lum_group_alloc(size_t count, GroupType type) {
+    LumArena* arena = lum_arena_current();
+    if (arena) {
+        // Arena groups keep their LUMs inline whatever the count
+        LumSmallGroup* small = (LumSmallGroup*)lum_arena_alloc(arena, sizeof(LumSmallGroup) + sizeof(LUM) * count);
+        if (!small) return NULL;
+        memset(small, 0, sizeof(LumSmallGroup) + sizeof(LUM) * count);
+        LUMGroup* group = small_group_init(small, count, type);
+        group->arena = arena;
+        return group;
+    }
+    if (count <= LUM_INLINE_CAPACITY) {
+        return lum_group_create_small(count, type);
+    }
+    
+    // Cleared: with an implicit layout lums[].position is never written
+    LUM* lums = (LUM*)calloc(count, sizeof(LUM));
+    if (!lums) return NULL;
+    LUMGroup* group = lum_group_adopt(lums, count, type);
+    if (!group) free(lums);
+    return group;
+}
+
+void* lum_group_field_alloc(const LUMGroup* group, size_t size) {
+    return group->arena ? lum_arena_alloc(group->arena, size) : malloc(size);
+}
+
+void lum_group_field_free(const LUMGroup* group, void* field) {
+    if (group->arena) {
+        lum_arena_free(group->arena, field);
+    } else {
+        free(field);
+    }
+}
+
+/**
+ * New group over a private copy of lums (NULL lums: count cleared LUMs)
+ */
+LUMGroup* lum_group_copy(const LUM* lums, size_t count, GroupType type) {
+    LUMGroup* group = lum_group_alloc(count, type);
+    if (!group || count == 0) return group;
     
+    if (lums) {
+        memcpy(group->lums, lums, sizeof(LUM) * count);
+    }
     return group;
 }
 
@@ -27,20 +137,58 @@ LUMGroup* create_lum_group(LUM* lums, size_t count, GroupType type) {
 void free_lum_group(LUMGroup* group) {
     if (!group) return;
     
-    if (group->lums) {
-        free(group->lums);
-    }
-    if (group->id) {
-        free(group->id);
-    }
-    if (group->spatial_data) {
-        free(group->spatial_data);
+    lum_group_release_storage(group); // LUMs and backends, or the shared reference
+    lum_group_field_free(group, group->id);
+    lum_group_field_free(group, group->spatial_data);
+    lum_group_field_free(group, group->connections);
+    
+    // Arena blocks go back to its free lists for the next group
+    if (group->arena) {
+        lum_arena_free(group->arena, group);
+    } else {
+        free(group);
     }
-    if (group->connections) {
-        free(group->connections);
+}
+
+// Identity source: a random prefix drawn once per thread (seeded from getrandom), then a counter
+static __thread uint64_t id_prefix;
+static __thread uint64_t id_counter;
+
+LumGroupId lum_group_uid(LUMGroup* group) {
+    LumGroupId none = {0, 0};
+    if (!group) return none;
+    
+    if (group->uid.hi == 0) {
+        while (id_prefix == 0) {
+            id_prefix = lum_random_u64();
+        }
+        // RFC 4122 version 4 and variant bits, so the text form is a valid UUID
+        group->uid.hi = (id_prefix & ~0xF000ULL) | 0x4000ULL;
+        group->uid.lo = (++id_counter & 0x3FFFFFFFFFFFFFFFULL) | 0x8000000000000000ULL;
     }
+    return group->uid;
+}
+
+const char* lum_group_id(LUMGroup* group) {
+    static const char hex[] = "0123456789abcdef";
+    if (!group) return NULL;
+    if (group->id) return group->id;
+    
+    LumGroupId uid = lum_group_uid(group);
+    char* text = (char*)lum_group_field_alloc(group, 37); // UUID standard length + null terminator
+    if (!text) return NULL;
     
-    free(group);
+    size_t pos = 0;
+    for (int i = 0; i < 16; i++) {
+        uint64_t half = i < 8 ? uid.hi : uid.lo;
+        unsigned byte = (unsigned)(half >> (56 - 8 * (i % 8))) & 0xFF;
+        if (i == 4 || i == 6 || i == 8 || i == 10) text[pos++] = '-';
+        text[pos++] = hex[byte >> 4];
+        text[pos++] = hex[byte & 0xF];
+    }
+    text[pos] = '\0';
+    group->id = text;
+    return text;
 }
 
 /**
@@ -49,14 +197,33 @@ void free_lum_group(LUMGroup* group) {
 LUMGroup* clone_lum_group(LUMGroup* source) {
     if (!source) return NULL;
     
-    LUM* cloned_lums = NULL;
-    if (source->lums && source->count > 0) {
-        cloned_lums = (LUM*)malloc(sizeof(LUM) * source->count);
-        if (!cloned_lums) return NULL;
-        memcpy(cloned_lums, source->lums, sizeof(LUM) * source->count);
-    }
+    // Copy-on-write: storage is shared until either group writes to it
+    LUMGroup* shared = lum_group_clone_cow(source);
+    if (shared) return shared;
+    
+    if (source->storage == LUM_STORAGE_PACKED) return packed_clone(source);
+    if (source->storage == LUM_STORAGE_COMPACT) return compact_clone(source);
+    if (source->storage == LUM_STORAGE_SOA) return soa_clone(source);
+    if (source->storage == LUM_STORAGE_HYBRID) return hybrid_clone(source);
     
-    return create_lum_group(cloned_lums, source->count, source->group_type);
+    LUMGroup* clone = source->lums ? lum_group_copy(source->lums, source->count, source->group_type)
+                                   : lum_group_adopt(NULL, source->count, source->group_type);
+    if (!clone) return NULL;
+    clone->layout = source->layout;
+    return clone;
+}
+
+/**
+ * Presence of LUM index whatever the backend
+ */
+static uint8_t group_presence_at(const LUMGroup* group, size_t index) {
+    switch (group->storage) {
+        case LUM_STORAGE_PACKED: return packed_get_presence(group, index);
+        case LUM_STORAGE_COMPACT: return (uint8_t)group->compact->records[index].presence;
+        case LUM_STORAGE_SOA: return group->soa->presence[index];
+        case LUM_STORAGE_HYBRID: return hybrid_get_presence(group, index);
+        default: return group->lums[index].presence;
+    }
 }
 
 /**
@@ -65,6 +232,26 @@ LUMGroup* clone_lum_group(LUMGroup* source) {
 int compare_lum_groups(LUMGroup* group1, LUMGroup* group2) {
     if (!group1 || !group2) return -1;
     if (group1->count != group2->count) return 1;
+    // Cached content hashes settle most unequal pairs without reading a LUM
+    if (group1->hash_cached && group2->hash_cached && group1->hash_sum != group2->hash_sum) return 1;
+    
+    if (group1->storage == LUM_STORAGE_PACKED && group2->storage == LUM_STORAGE_PACKED) {
+        // Bits past count are kept clear, so whole words compare directly
+        return memcmp(group1->packed->words, group2->packed->words,
+                      sizeof(uint64_t) * group1->packed->word_count) != 0;
+    }
+    if (group1->storage == LUM_STORAGE_HYBRID && group2->storage == LUM_STORAGE_HYBRID) {
+        return !hybrid_equal(group1, group2);
+    }
+    if (group1->storage == LUM_STORAGE_SOA && group2->storage == LUM_STORAGE_SOA) {
+        return group1->count > 0 &&
+               memcmp(group1->soa->presence, group2->soa->presence, group1->count) != 0;
+    }
+    if (group1->storage != LUM_STORAGE_DENSE || group2->storage != LUM_STORAGE_DENSE ||
+        lum_parallel_threads(group1->count) > 1) {
+        // Word-wide chunks on the pool instead of one presence lookup per LUM
+        return lum_group_hamming(group1, group2) != 0;
+    }
     
     for (size_t i = 0; i < group1->count; i++) {
         if (group1->lums[i].presence != group2->lums[i].presence) {
@@ -75,6 +262,78 @@ int compare_lum_groups(LUMGroup* group1, LUMGroup* group2) {
     return 0; // Equal
 }
 
+#define IDENTICAL_CHUNK 256 // LUMs expanded per side and compared at a time
+
+/**
+ * LUMs [start, start + count) as stored, whatever the backend, positions filled per range
+ */
+static int group_lums_range(const LUMGroup* group, size_t start, size_t count, LUM* out) {
+    int status = 0;
+    switch (group->storage) {
+        case LUM_STORAGE_PACKED: return packed_expand_range(group, start, count, out);
+        case LUM_STORAGE_HYBRID: return hybrid_expand_range(group, start, count, out);
+        case LUM_STORAGE_COMPACT:
+            for (size_t i = 0; i < count && status == 0; i++) {
+                status = compact_get_lum(group, start + i, &out[i]);
+            }
+            return status;
+        case LUM_STORAGE_SOA:
+            for (size_t i = 0; i < count && status == 0; i++) {
+                status = soa_get_lum(group, start + i, &out[i]);
+            }
+            return status;
+        default:
+            if (!group->lums) {
+                return -1;
+            }
+            memcpy(out, group->lums + start, sizeof(LUM) * count);
+            return lum_group_fill_positions_range(group, start, count, 0, 0, out);
+    }
+}
+
+/**
+ * Types, spatial data and positions of count LUM pairs, without a branch per
+ * LUM (padding bytes are never read). 0 if they all match.
+ */
+static int lums_differ(const LUM* a, const LUM* b, size_t count) {
+    uintptr_t diff = 0;
+    for (size_t i = 0; i < count; i++) {
+        diff |= (uintptr_t)((unsigned)a[i].structure_type ^ (unsigned)b[i].structure_type) |
+                ((uintptr_t)a[i].spatial_data ^ (uintptr_t)b[i].spatial_data) |
+                (uintptr_t)((unsigned)a[i].position.x ^ (unsigned)b[i].position.x) |
+                (uintptr_t)((unsigned)a[i].position.y ^ (unsigned)b[i].position.y);
+    }
+    return diff != 0;
+}
+
+/**
+ * Full equality: presence (word compare first), then types, spatial data and
+ * positions a chunk at a time. Dense groups with stored positions at the same
+ * offset are compared in place.
+ */
+int lum_groups_identical(LUMGroup* group1, LUMGroup* group2) {
+    if (!group1 || !group2 || compare_lum_groups(group1, group2) != 0) {
+        return 0;
+    }
+    int in_place = group1->storage == LUM_STORAGE_DENSE && group2->storage == LUM_STORAGE_DENSE &&
+                   group1->layout.kind == LUM_LAYOUT_EXPLICIT && group2->layout.kind == LUM_LAYOUT_EXPLICIT &&
+                   group1->layout.offset_x == group2->layout.offset_x &&
+                   group1->layout.offset_y == group2->layout.offset_y && group1->lums && group2->lums;
+
+    LUM chunk1[IDENTICAL_CHUNK], chunk2[IDENTICAL_CHUNK];
+    for (size_t start = 0; start < group1->count; start += IDENTICAL_CHUNK) {
+        size_t count = group1->count - start < IDENTICAL_CHUNK ? group1->count - start : IDENTICAL_CHUNK;
+        const LUM* lums1 = in_place ? group1->lums + start : chunk1;
+        const LUM* lums2 = in_place ? group2->lums + start : chunk2;
+        if ((!in_place && (group_lums_range(group1, start, count, chunk1) != 0 ||
+                           group_lums_range(group2, start, count, chunk2) != 0)) ||
+            lums_differ(lums1, lums2, count)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
 /**
  * Print LUM group for debugging
  */
@@ -86,9 +345,11 @@ void print_lum_group(LUMGroup* group) {
     
     printf("LUMGroup: %zu LUMs, type=%d\n", group->count, group->group_type);
     for (size_t i = 0; i < group->count && i < 20; i++) {
+        int x = 0, y = 0;
+        uint8_t presence = group_presence_at(group, i);
+        lum_group_position(group, i, &x, &y);
         printf("  [%zu]: %d @ (%d,%d)\n", 
-               i, group->lums[i].presence, 
-               group->lums[i].position.x, group->lums[i].position.y);
+               i, presence, x, y);
     }
     if (group->count > 20) {
         printf("  ... (%zu more)\n", group->count - 20);
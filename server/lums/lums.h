@@ -39,6 +39,8 @@ typedef enum {
     LUM_CLUSTER = 4
 } LumStructureType;
 
+#define LUM_STRUCTURE_TYPES (LUM_CLUSTER + 1)
+
 // Group Types
 typedef enum {
     GROUP_LINEAR = 0,
@@ -76,15 +78,174 @@ typedef struct SpatialData {
     } data;
 } SpatialData;
 
+// Group-level layout: positions are computed on demand from a descriptor
+// instead of being stored per LUM
+typedef enum {
+    LUM_LAYOUT_EXPLICIT = 0,       // Laid out by hand: dense lums[].position / packed overrides
+    LUM_LAYOUT_LINEAR = 1,         // x = i * stride
+    LUM_LAYOUT_GRID = 2,           // x = (i % row_length) * stride, y = (i / row_length) * row_spacing
+    LUM_LAYOUT_CIRCLE = 3,         // (int)(center + radius * cos/sin(i * 2pi / period))
+    LUM_LAYOUT_SPIRAL = 4          // Organic fusion spiral: angle += angle_step, radius grows per turn
+} LumLayoutKind;
+
+typedef struct {
+    LumLayoutKind kind;
+    int offset_x, offset_y;        // Pending affine offset added to every position
+    int stride;                    // LINEAR, GRID
+    size_t row_length;             // GRID
+    int row_spacing;               // GRID
+    int center_x, center_y;        // CIRCLE
+    int radius;                    // CIRCLE radius, SPIRAL radius increment per turn
+    size_t period;                 // CIRCLE point count
+    double angle_step;             // SPIRAL
+} LumLayout;
+
+// Storage backends for LUM groups
+typedef enum {
+    LUM_STORAGE_DENSE = 0,         // One LUM struct per bit in group->lums
+    LUM_STORAGE_PACKED = 1,        // Presence bits in 64-bit words (group->packed)
+    LUM_STORAGE_COMPACT = 2,       // 8-byte records, spatial data in a side table (group->compact)
+    LUM_STORAGE_SOA = 3,           // One array per LUM field (group->soa)
+    LUM_STORAGE_HYBRID = 4         // 64K-LUM adaptive containers (group->hybrid)
+} LumStorageMode;
+
+// Run of consecutive LUMs sharing a structure type (packed storage)
+typedef struct {
+    size_t start;                  // First LUM index of the run
+    LumStructureType structure_type;
+} LumTypeRun;
+
+// Explicit position for a LUM that does not follow the default layout
+typedef struct {
+    size_t index;
+    int x, y;
+} LumPositionOverride;
+
+// Packed storage: presence bits plus sparse deviations from the group layout
+typedef struct {
+    uint64_t* words;               // Bit (i % 64) of words[i / 64] = presence of LUM i
+    size_t word_count;
+    uint64_t inline_word;          // words points here for groups of at most 64 LUMs
+    LumTypeRun* type_runs;         // Sorted by start, first run starts at 0
+    size_t type_run_count;
+    LumPositionOverride* overrides; // Sorted by index, before the layout offset
+    size_t override_count;
+} LumPackedStorage;
+
+// Compact LUM record: 8 per cache line instead of 2-3 LUM structs
+typedef struct {
+    unsigned int presence : 1;
+    unsigned int structure_type : 3;
+    unsigned int has_spatial : 1;  // Entry in the spatial side table
+    unsigned int reserved : 27;
+    int16_t x, y;                  // Only used by LUM_LAYOUT_EXPLICIT, within +/-10000
+} LumCompact;
+
+// Per-LUM spatial data of a compact group (not owned, like LUM.spatial_data)
+typedef struct {
+    size_t index;
+    SpatialData* data;
+} LumSpatialEntry;
+
+typedef struct {
+    LumCompact* records;
+    LumSpatialEntry* spatial;      // Sorted by index
+    size_t spatial_count;
+} LumCompactStorage;
+
+// Structure-of-arrays storage: kernels stream only the columns they read
+typedef struct {
+    uint8_t* presence;
+    uint8_t* structure_type;       // LumStructureType values
+    int32_t* x;                    // x / y only allocated for LUM_LAYOUT_EXPLICIT
+    int32_t* y;
+    SpatialData** spatial_data;    // NULL unless some LUM carries spatial data
+} LumSoaStorage;
+
+// Hybrid storage: presence split in containers of 65536 LUMs, each one
+// kept as the smallest of a sorted index list, a bitmap or runs
+#define LUM_CONTAINER_BITS 16
+#define LUM_CONTAINER_SIZE (1u << LUM_CONTAINER_BITS)
+#define LUM_CONTAINER_ARRAY_MAX 4096   // Above this an index list outgrows the bitmap
+
+typedef enum {
+    LUM_CONTAINER_ARRAY = 0,       // Sorted uint16 indices of present LUMs
+    LUM_CONTAINER_BITMAP = 1,      // 1024 64-bit words
+    LUM_CONTAINER_RUN = 2          // Sorted [start, last] runs of present LUMs
+} LumContainerKind;
+
+typedef struct {
+    uint16_t start;
+    uint16_t last;                 // Inclusive, a run may cover the whole container
+} LumContainerRun;
+
+typedef struct {
+    LumContainerKind kind;
+    uint32_t cardinality;          // Present LUMs in the container
+    uint32_t size;                 // ARRAY: indices, RUN: runs
+    uint32_t capacity;
+    union {
+        uint16_t* values;
+        uint64_t* words;
+        LumContainerRun* runs;
+    } data;
+} LumContainer;
+
+typedef struct {
+    LumContainer* containers;      // Container k holds LUMs [k * 65536, (k + 1) * 65536)
+    size_t container_count;
+    LumTypeRun* type_runs;         // Same encoding as packed storage
+    size_t type_run_count;
+    LumPositionOverride* overrides;
+    size_t override_count;
+} LumHybridStorage;
+
+// Request / program allocator, defined in arena.h
+typedef struct LumArena LumArena;
+
+// Storage shared by views and copy-on-write clones: the dense array, or
+// the one backend struct of a packed / compact / SoA / hybrid group
+typedef struct LumBuffer {
+    LUM* lums;
+    size_t count;
+    LumPackedStorage* packed;
+    LumCompactStorage* compact;
+    LumSoaStorage* soa;
+    LumHybridStorage* hybrid;
+    size_t refcount;               // Groups holding the buffer, updated atomically
+    void (*release)(void* context); // Borrowed memory: called instead of free(lums)
+    void* context;
+    int lums_inline;               // lums lives in the buffer's own allocation
+    LumArena* arena;               // Buffer allocated from it (NULL: heap)
+} LumBuffer;
+
+// 128-bit group identity (UUID v4 bytes, big-endian halves), zero until first read
+typedef struct {
+    uint64_t hi;
+    uint64_t lo;
+} LumGroupId;
+
 // LUM Group structure
 typedef struct LUMGroup {
-    LUM* lums;
+    LUM* lums;                     // Written through lum_group_writable() (view.h) once shared
     size_t count;
     GroupType group_type;
-    char* id;
+    char* id;                      // UUID text, NULL until lum_group_id() is called
     struct LUMGroup** connections;  // Links to other groups
     size_t connection_count;
     void* spatial_data;            // Additional spatial metadata
+    LumStorageMode storage;        // Backend holding the LUMs
+    LumPackedStorage* packed;      // Valid when storage == LUM_STORAGE_PACKED
+    LumCompactStorage* compact;    // Valid when storage == LUM_STORAGE_COMPACT
+    LumSoaStorage* soa;            // Valid when storage == LUM_STORAGE_SOA
+    LumHybridStorage* hybrid;      // Valid when storage == LUM_STORAGE_HYBRID
+    LumLayout layout;              // lums[].position is only stored for LUM_LAYOUT_EXPLICIT (0 in new groups)
+    LumBuffer* owner;              // Set once the storage is shared: read-only until detached
+    int lums_inline;               // lums lives in the group's own allocation (small / arena groups)
+    LumArena* arena;               // Header, id, spatial_data and connections come from it (NULL: heap)
+    LumGroupId uid;                // Zero until lum_group_uid() / lum_group_id() is called
+    uint64_t hash_sum;             // Presence word terms of lum_group_hash, valid while hash_cached
+    int hash_cached;               // Set by lum_group_content_hash, cleared by edits that do not update it
 } LUMGroup;
 
 // VORAX Zone structure
@@ -120,10 +281,27 @@ LUMGroup* encode_binary_string(const char* binary_str);
 char* decode_to_binary_string(LUM* lums, size_t count);
 
 // Group management
+#define LUM_INLINE_CAPACITY 64
+// create_lum_group / lum_group_adopt take ownership of lums (still the caller's on
+// failure), lum_group_copy duplicates them, lum_group_borrow (view.h) references them
 LUMGroup* create_lum_group(LUM* lums, size_t count, GroupType type);
+LUMGroup* lum_group_adopt(LUM* lums, size_t count, GroupType type);
+LUMGroup* lum_group_copy(const LUM* lums, size_t count, GroupType type);
+// Up to LUM_INLINE_CAPACITY cleared LUMs allocated together with the group
+LUMGroup* lum_group_create_small(size_t count, GroupType type);
+// Room for count cleared LUMs: from the thread's current arena if any, else the heap
+LUMGroup* lum_group_alloc(size_t count, GroupType type);
+// Memory for a group's id / spatial_data / connections, freed with the group
+void* lum_group_field_alloc(const LUMGroup* group, size_t size);
+void lum_group_field_free(const LUMGroup* group, void* field);
 void free_lum_group(LUMGroup* group);
+// Identity, generated on first read from a per-thread random prefix and counter
+LumGroupId lum_group_uid(LUMGroup* group);
+const char* lum_group_id(LUMGroup* group);
 LUMGroup* clone_lum_group(LUMGroup* source);
 int compare_lum_groups(LUMGroup* group1, LUMGroup* group2);
+// 1 if types, spatial data and positions match too (compare_lum_groups: presence only)
+int lum_groups_identical(LUMGroup* group1, LUMGroup* group2);
 void print_lum_group(LUMGroup* group);
 
 // Advanced mathematics via LUMS
@@ -147,7 +325,7 @@ LUMGroup* vorax_get_zone_group(VoraxEngine* engine, const char* zone_name);
 int vorax_store_memory(VoraxEngine* engine, const char* name, LUMGroup* group);
 LUMGroup* vorax_retrieve_memory(VoraxEngine* engine, const char* name);
 
-// Validation and debugging
+// Validation and debugging (stored positions only: validate_lum_group for groups)
 int validate_lums(LUM* lums, size_t count);
 void print_vorax_engine_state(VoraxEngine* engine);
 
@@ -1,4 +1,13 @@
 #include "lums.h"
+#include "operations.h"
+#include "packed.h"
+#include "layout.h"
+#include "compact.h"
+#include "soa.h"
+#include "hybrid.h"
+#include "view.h"
+#include "pool.h"
+#include "reduce.h"
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
@@ -10,83 +19,195 @@
 #define LOG_ERROR(...) fprintf(stderr, "ERROR: " __VA_ARGS__); fprintf(stderr, "\n")
 #endif
 
-// Declaration of create_lum_group, assuming it's defined in lums.h or a related file
-// This is a placeholder, the actual implementation might differ.
-// Based on the context of the provided code, it seems to be used for allocating and initializing a LUMGroup.
-LUMGroup* create_lum_group(LUM* lums, size_t count, GroupType type) {
-    LUMGroup* result = (LUMGroup*)malloc(sizeof(LUMGroup));
-    if (!result) {
-        LOG_ERROR("Memory allocation failed for LUMGroup");
-        return NULL;
+typedef struct {
+    const LUM* lums;
+    LUM* out;
+    size_t count;
+    size_t tasks;
+    LumStructureType type;
+} RetypeCopy;
+
+static void retype_copy_chunk(void* context, size_t task) {
+    const RetypeCopy* job = (const RetypeCopy*)context;
+    size_t start, end;
+    lum_parallel_chunk(job->count, job->tasks, task, &start, &end);
+    if (end > start) {
+        memcpy(job->out + start, job->lums + start, sizeof(LUM) * (end - start));
     }
-    result->lums = (LUM*)malloc(sizeof(LUM) * count);
-    if (!result->lums) {
-        free(result);
-        LOG_ERROR("Memory allocation failed for LUMs array of size %zu", count);
-        return NULL;
+    for (size_t i = start; i < end; i++) {
+        job->out[i].structure_type = job->type;
     }
+}
 
-    if (lums && count > 0) {
-        memcpy(result->lums, lums, sizeof(LUM) * count);
-    }
-    result->count = count;
-    result->group_type = type;
-    result->spatial_data = NULL; // Initialize spatial_data to NULL
-
-    return result;
+/**
+ * out = lums with every structure_type set to type, on the pool when large
+ */
+static void copy_retyped(const LUM* lums, size_t count, LumStructureType type, LUM* out) {
+    RetypeCopy job = {lums, out, count, lum_parallel_threads(count), type};
+    lum_parallel_run(job.tasks, retype_copy_chunk, &job);
 }
 
-// Declaration of free_lum_group, assuming it's defined in lums.h or a related file
-void free_lum_group(LUMGroup* group) {
-    if (group) {
-        free(group->lums); // Free the array of LUMs
-        free(group->spatial_data); // Free spatial data if allocated
-        free(group);       // Free the LUMGroup structure itself
+typedef struct {
+    const LUMGroup* group1;
+    const LUMGroup* group2;
+    LUM* out;
+    size_t total_count;
+    size_t tasks;
+    int explicit_positions;
+    int shift_x;
+} FusionCopy;
+
+/**
+ * One output range of lum_fusion: copy, retype and position what falls in it
+ */
+static void fusion_copy_chunk(void* context, size_t task) {
+    const FusionCopy* job = (const FusionCopy*)context;
+    size_t count1 = job->group1->count;
+    size_t start, end;
+    lum_parallel_chunk(job->total_count, job->tasks, task, &start, &end);
+
+    if (start < count1) {
+        size_t n = (end < count1 ? end : count1) - start;
+        memcpy(job->out + start, job->group1->lums + start, sizeof(LUM) * n);
+        if (job->explicit_positions) {
+            lum_group_fill_positions_range(job->group1, start, n, 0, 0, job->out + start);
+        }
+    }
+    if (end > count1) {
+        size_t first = start > count1 ? start : count1;
+        memcpy(job->out + first, job->group2->lums + (first - count1), sizeof(LUM) * (end - first));
+        for (size_t i = first; i < end; i++) {
+            job->out[i].structure_type = LUM_GROUP; // Mark as part of fusion
+        }
+        if (job->explicit_positions) {
+            lum_group_fill_positions_range(job->group2, first - count1, end - first,
+                                           job->shift_x, 0, job->out + first);
+        }
     }
 }
 
-
 /**
  * VORAX Operation: Fusion (⧉)
  * Combines two LUM groups into one cluster
  */
 LUMGroup* lum_fusion(LUMGroup* group1, LUMGroup* group2) {
+    if (group1 && group2 &&
+        (group1->storage == LUM_STORAGE_HYBRID || group2->storage == LUM_STORAGE_HYBRID)) {
+        return hybrid_lum_fusion(group1, group2);
+    }
+    if (group1 && group2 &&
+        (group1->storage == LUM_STORAGE_PACKED || group2->storage == LUM_STORAGE_PACKED)) {
+        return packed_lum_fusion(group1, group2);
+    }
+    if (group1 && group2 &&
+        (group1->storage == LUM_STORAGE_COMPACT || group2->storage == LUM_STORAGE_COMPACT)) {
+        return compact_lum_fusion(group1, group2);
+    }
+    if (group1 && group2 &&
+        (group1->storage == LUM_STORAGE_SOA || group2->storage == LUM_STORAGE_SOA)) {
+        return soa_lum_fusion(group1, group2);
+    }
     if (!group1 || !group2 || !group1->lums || !group2->lums) {
         LOG_ERROR("Invalid input groups for lum_fusion");
         return NULL;
     }
 
     size_t total_count = group1->count + group2->count;
-    LUM* fused_lums = (LUM*)malloc(sizeof(LUM) * total_count);
-    if (!fused_lums) {
-        LOG_ERROR("Memory allocation failed for fused LUMs array");
+    LUMGroup* fused_group = lum_group_alloc(total_count, GROUP_CLUSTER);
+    if (!fused_group) {
+        LOG_ERROR("Memory allocation failed for fused LUM group");
         return NULL;
     }
 
-    // Copy first group
-    memcpy(fused_lums, group1->lums, sizeof(LUM) * group1->count);
+    // Second group is shifted right by group1->count * 20 for visual separation.
+    // Positions are only written when the result is not a single implicit layout.
+    int shift_x = lum_fusion_shift(group1->count);
+    LumLayout fused_layout;
+    int explicit_positions =
+        lum_layout_concat(&group1->layout, group1->count, &group2->layout, shift_x, &fused_layout) != 0;
+    if (explicit_positions) {
+        fused_layout = lum_layout_explicit();
+    }
+
+    // Output ranges are independent, large fusions fill them on the pool
+    FusionCopy job = {group1, group2, fused_group->lums, total_count,
+                      lum_parallel_threads(total_count), explicit_positions, shift_x};
+    lum_parallel_run(job.tasks, fusion_copy_chunk, &job);
+
+    fused_group->layout = fused_layout;
+
+    return fused_group;
+}
+
+typedef struct {
+    const LUM* lums;
+    size_t count;
+    size_t zones;
+    size_t tasks;
+    unsigned char* retyped;  // Zone holds a LUM that is not LUM_LINEAR yet
+    LUMGroup** result;
+} SplitZones;
+
+/**
+ * Zone holding source index (zones as sized by lum_parallel_chunk)
+ */
+static size_t zone_of(const SplitZones* job, size_t index) {
+    size_t per_zone = job->count / job->zones;
+    size_t remainder = job->count % job->zones;
+    size_t boundary = remainder * (per_zone + 1);
+    return index < boundary ? index / (per_zone + 1) : remainder + (index - boundary) / per_zone;
+}
 
-    // Copy second group
-    memcpy(fused_lums + group1->count, group2->lums, sizeof(LUM) * group2->count);
+/**
+ * Calls visit for every zone overlapping source range [start, end)
+ */
+static void split_visit(const SplitZones* job, size_t start, size_t end,
+                        void (*visit)(const SplitZones*, size_t, size_t, size_t, size_t)) {
+    for (size_t zone = start < end ? zone_of(job, start) : job->zones; zone < job->zones; zone++) {
+        size_t zone_start, zone_end;
+        lum_parallel_chunk(job->count, job->zones, zone, &zone_start, &zone_end);
+        if (zone_start >= end) {
+            break;
+        }
+        size_t first = zone_start > start ? zone_start : start;
+        size_t last = zone_end < end ? zone_end : end;
+        visit(job, zone, zone_start, first, last);
+    }
+}
 
-    // Update positions for spatial representation
-    for (size_t i = group1->count; i < total_count; i++) {
-        // This adjustment might need more context. Assuming it's for visual separation.
-        fused_lums[i].position.x += group1->count * 20;
-        fused_lums[i].structure_type = LUM_GROUP; // Mark as part of fusion
+static void mark_retyped(const SplitZones* job, size_t zone, size_t zone_start, size_t first, size_t last) {
+    (void)zone_start;
+    for (size_t i = first; i < last; i++) {
+        if (job->lums[i].structure_type != LUM_LINEAR) {
+            __atomic_store_n(&job->retyped[zone], 1, __ATOMIC_RELAXED);
+            return;
+        }
     }
+}
 
-    LUMGroup* fused_group = create_lum_group(fused_lums, total_count, GROUP_CLUSTER);
-    if (!fused_group) {
-        free(fused_lums); // Clean up if create_lum_group fails
-        LOG_ERROR("Failed to create fused LUM group");
-        return NULL;
+static void copy_zone(const SplitZones* job, size_t zone, size_t zone_start, size_t first, size_t last) {
+    if (!job->retyped[zone]) {
+        return; // View of the source
     }
-    // The caller is responsible for freeing fused_lums if create_lum_group fails.
-    // However, if create_lum_group succeeds, it duplicates the data, so fused_lums should not be freed here.
-    // The created fused_group will manage its memory.
+    LUM* out = job->result[zone]->lums + (first - zone_start);
+    memcpy(out, job->lums + first, sizeof(LUM) * (last - first));
+    for (size_t i = 0; i < last - first; i++) {
+        out[i].structure_type = LUM_LINEAR;
+    }
+}
 
-    return fused_group;
+static void split_mark_chunk(void* context, size_t task) {
+    const SplitZones* job = (const SplitZones*)context;
+    size_t start, end;
+    lum_parallel_chunk(job->count, job->tasks, task, &start, &end);
+    split_visit(job, start, end, mark_retyped);
+}
+
+static void split_copy_chunk(void* context, size_t task) {
+    const SplitZones* job = (const SplitZones*)context;
+    size_t start, end;
+    lum_parallel_chunk(job->count, job->tasks, task, &start, &end);
+    split_visit(job, start, end, copy_zone);
 }
 
 /**
@@ -94,78 +215,72 @@ LUMGroup* lum_fusion(LUMGroup* group1, LUMGroup* group2) {
  * Distributes LUMs across multiple zones
  */
 LUMGroup** lum_split(LUMGroup* source, int zones, size_t* result_count) {
+    if (source && source->storage == LUM_STORAGE_HYBRID) {
+        return hybrid_lum_split(source, zones, result_count);
+    }
+    if (source && source->storage == LUM_STORAGE_PACKED) {
+        return packed_lum_split(source, zones, result_count);
+    }
+    if (source && source->storage == LUM_STORAGE_COMPACT) {
+        return compact_lum_split(source, zones, result_count);
+    }
+    if (source && source->storage == LUM_STORAGE_SOA) {
+        return soa_lum_split(source, zones, result_count);
+    }
     if (!source || !source->lums || zones <= 0 || !result_count) {
         if (result_count) *result_count = 0;
         LOG_ERROR("Invalid input for lum_split");
         return NULL;
     }
 
-    LUMGroup** result = (LUMGroup**)malloc(sizeof(LUMGroup*) * zones);
-    if (!result) {
+    LUMGroup** result = (LUMGroup**)calloc((size_t)zones, sizeof(LUMGroup*));
+    unsigned char* retyped = (unsigned char*)calloc((size_t)zones, 1);
+    if (!result || !retyped) {
+        free(result);
+        free(retyped);
         *result_count = 0;
         LOG_ERROR("Memory allocation failed for split result array");
         return NULL;
     }
 
-    size_t lums_per_zone = source->count / zones;
-    size_t remainder = source->count % zones;
-    size_t current_index = 0;
+    // Zones that split leaves unchanged (already LUM_LINEAR) become views of
+    // an already shared source, no copy. Positions follow the zone layout, so
+    // only the types need checking. Both scans run over output ranges on the pool.
+    // An unshared source is only read: sharing it here would move its LUMs
+    // under the caller's pointers and concurrent readers.
+    int viewable = lum_group_is_view(source);
+    SplitZones job = {source->lums, source->count, (size_t)zones,
+                      lum_parallel_threads(source->count), retyped, result};
+    lum_parallel_run(job.tasks, split_mark_chunk, &job);
 
     for (int i = 0; i < zones; i++) {
-        size_t zone_count = lums_per_zone + ((size_t)i < remainder ? 1 : 0);
-
-        if (zone_count == 0) {
-            // Create empty zone
-            result[i] = create_lum_group(NULL, 0, GROUP_LINEAR);
-            if (!result[i]) {
-                LOG_ERROR("Failed to create empty LUM group for zone %d", i);
-                // Cleanup on failure: free already created groups and the result array
-                for (int j = 0; j < i; j++) {
-                    free_lum_group(result[j]);
-                }
-                free(result);
-                *result_count = 0;
-                return NULL;
-            }
-            continue;
+        size_t zone_start, zone_end;
+        lum_parallel_chunk(source->count, (size_t)zones, (size_t)i, &zone_start, &zone_end);
+        size_t zone_count = zone_end - zone_start;
+
+        if (zone_count > 0 && !retyped[i]) {
+            result[i] = viewable ? lum_group_borrow_range(source, zone_start, zone_count, GROUP_LINEAR)
+                                 : NULL;
+            retyped[i] = result[i] == NULL; // Copied after all without a view
         }
-
-        LUM* zone_lums = (LUM*)malloc(sizeof(LUM) * zone_count);
-        if (!zone_lums) {
-            LOG_ERROR("Memory allocation failed for LUMs in zone %d", i);
-            // Cleanup on failure: free already created groups and the result array
-            for (int j = 0; j < i; j++) {
-                free_lum_group(result[j]);
-            }
-            free(result);
-            *result_count = 0;
-            return NULL;
-        }
-
-        memcpy(zone_lums, source->lums + current_index, sizeof(LUM) * zone_count);
-
-        // Update positions for new zone
-        for (size_t j = 0; j < zone_count; j++) {
-            zone_lums[j].position.x = (int)(j * 20); // Ensure cast to int if necessary
-            zone_lums[j].position.y = i * 50; // Different Y for each zone
-            zone_lums[j].structure_type = LUM_LINEAR;
+        if (!result[i]) {
+            result[i] = lum_group_alloc(zone_count, GROUP_LINEAR);
         }
-
-        result[i] = create_lum_group(zone_lums, zone_count, GROUP_LINEAR);
         if (!result[i]) {
-            LOG_ERROR("Failed to create LUM group for zone %d", i);
-            // Cleanup on failure: free allocated zone_lums, then already created groups and the result array
-            free(zone_lums);
-            for (int j = 0; j < i; j++) {
-                free_lum_group(result[j]);
-            }
-            free(result);
+            LOG_ERROR("Memory allocation failed for LUMs in zone %d", i);
+            free_split_result(result, (size_t)i);
+            free(retyped);
             *result_count = 0;
             return NULL;
         }
-        current_index += zone_count;
+        if (zone_count > 0) {
+            result[i]->layout = lum_layout_linear(0, i * 50, 20); // Different Y for each zone
+        }
     }
 
+    lum_parallel_run(job.tasks, split_copy_chunk, &job);
+    free(retyped);
+
     *result_count = zones;
     return result;
 }
@@ -175,48 +290,47 @@ LUMGroup** lum_split(LUMGroup* source, int zones, size_t* result_count) {
  * Reduces LUM count by modulo operation
  */
 LUMGroup* lum_cycle(LUMGroup* source, int modulo) {
+    if (source && source->storage == LUM_STORAGE_HYBRID) {
+        return hybrid_lum_cycle(source, modulo);
+    }
+    if (source && source->storage == LUM_STORAGE_PACKED) {
+        return packed_lum_cycle(source, modulo);
+    }
+    if (source && source->storage == LUM_STORAGE_COMPACT) {
+        return compact_lum_cycle(source, modulo);
+    }
+    if (source && source->storage == LUM_STORAGE_SOA) {
+        return soa_lum_cycle(source, modulo);
+    }
     if (!source || !source->lums || modulo <= 0) {
         LOG_ERROR("Invalid input for lum_cycle");
         return NULL;
     }
 
     size_t result_count_raw = source->count % modulo;
-    size_t final_result_count;
-    LUM* cycled_lums = NULL;
+    // Minimal LUM group with single presence if modulo results in zero items
+    size_t final_result_count = result_count_raw > 0 ? result_count_raw : 1;
+    LUMGroup* result = lum_group_alloc(final_result_count, GROUP_NODE);
+    if (!result) {
+        LOG_ERROR("Memory allocation failed for %zu LUMs in lum_cycle", final_result_count);
+        return NULL;
+    }
+    LUM* cycled_lums = result->lums;
 
     if (result_count_raw == 0) {
-        // Create minimal LUM group with single presence if modulo results in zero items
-        final_result_count = 1;
-        cycled_lums = (LUM*)malloc(sizeof(LUM));
-        if (!cycled_lums) {
-            LOG_ERROR("Memory allocation failed for single LUM in lum_cycle");
-            return NULL;
-        }
         cycled_lums[0].presence = 1; // Default presence, might need adjustment
         cycled_lums[0].structure_type = LUM_CYCLE;
         cycled_lums[0].spatial_data = NULL;
         cycled_lums[0].position.x = 0;
         cycled_lums[0].position.y = 0;
     } else {
-        final_result_count = result_count_raw;
-        cycled_lums = (LUM*)malloc(sizeof(LUM) * final_result_count);
-        if (!cycled_lums) {
-            LOG_ERROR("Memory allocation failed for %zu LUMs in lum_cycle", final_result_count);
-            return NULL;
-        }
-        memcpy(cycled_lums, source->lums, sizeof(LUM) * final_result_count);
-
-        // Mark as cycle type and arrange in circular pattern
-        double angle_step = 2.0 * 3.14159265359 / final_result_count;
-        for (size_t i = 0; i < final_result_count; i++) {
-            cycled_lums[i].structure_type = LUM_CYCLE;
-            // Arrange in circle
-            cycled_lums[i].position.x = (int)(50 + 30 * cos(i * angle_step));
-            cycled_lums[i].position.y = (int)(50 + 30 * sin(i * angle_step));
-        }
+        copy_retyped(source->lums, final_result_count, LUM_CYCLE, cycled_lums);
     }
 
-    return create_lum_group(cycled_lums, final_result_count, GROUP_NODE);
+    if (result_count_raw > 0) {
+        result->layout = lum_layout_circle(50, 50, 30, final_result_count); // Arrange in circle
+    }
+    return result;
 }
 
 /**
@@ -224,38 +338,38 @@ LUMGroup* lum_cycle(LUMGroup* source, int modulo) {
  * Transfers LUMs to target zone (conceptual)
  */
 LUMGroup* lum_flow(LUMGroup* source, const char* target_zone) {
+    if (source && source->storage == LUM_STORAGE_HYBRID) {
+        return hybrid_lum_flow(source, target_zone);
+    }
+    if (source && source->storage == LUM_STORAGE_PACKED) {
+        return packed_lum_flow(source, target_zone);
+    }
+    if (source && source->storage == LUM_STORAGE_COMPACT) {
+        return compact_lum_flow(source, target_zone);
+    }
+    if (source && source->storage == LUM_STORAGE_SOA) {
+        return soa_lum_flow(source, target_zone);
+    }
     if (!source || !source->lums || !target_zone) {
         LOG_ERROR("Invalid input for lum_flow");
         return NULL;
     }
 
     // Create a copy with flow metadata
-    LUM* flowed_lums = (LUM*)malloc(sizeof(LUM) * source->count);
-    if (!flowed_lums) {
-        LOG_ERROR("Memory allocation failed for flowed LUMs array");
-        return NULL;
-    }
-
-    memcpy(flowed_lums, source->lums, sizeof(LUM) * source->count);
-
-    // Update positions to show flow direction
-    for (size_t i = 0; i < source->count; i++) {
-        flowed_lums[i].position.x += 100; // Offset to show movement
-        flowed_lums[i].structure_type = LUM_LINEAR; // Reset to linear for flow
-    }
-
-    LUMGroup* result = create_lum_group(flowed_lums, source->count, source->group_type);
+    LUMGroup* result = lum_group_alloc(source->count, source->group_type);
     if (!result) {
-        LOG_ERROR("Failed to create LUM group for flow operation");
-        // The caller is responsible for freeing flowed_lums if create_lum_group fails.
-        // However, if create_lum_group succeeds, it duplicates the data, so flowed_lums should not be freed here.
+        LOG_ERROR("Memory allocation failed for flowed LUM group");
         return NULL;
     }
+    copy_retyped(source->lums, source->count, LUM_LINEAR, result->lums); // Reset to linear for flow
+
+    result->layout = source->layout;
+    lum_group_translate(result, 100, 0); // Offset to show movement
 
     // Store target zone information
     size_t target_len = strlen(target_zone);
     // Use a temporary pointer for allocation to check for success
-    char* temp_spatial_data = (char*)malloc(target_len + 1);
+    char* temp_spatial_data = (char*)lum_group_field_alloc(result, target_len + 1);
     if (temp_spatial_data) {
         strcpy(temp_spatial_data, target_zone);
         result->spatial_data = temp_spatial_data; // Assign only if allocation and copy succeed
@@ -270,10 +384,420 @@ LUMGroup* lum_flow(LUMGroup* source, const char* target_zone) {
     return result;
 }
 
+/**
+ * Move result's storage into group, for backends without an in-place path
+ */
+static int replace_storage(LUMGroup* group, LUMGroup* result) {
+    if (!result) {
+        return -1;
+    }
+    // Inline LUMs live in result's header, which is freed below (a shared
+    // result already has their heap copy in its buffer)
+    if (result->lums_inline && result->owner) {
+        result->lums = result->owner->lums;
+        result->lums_inline = 0;
+    } else if (result->lums_inline) {
+        LUM* lums = (LUM*)malloc(sizeof(LUM) * (result->count > 0 ? result->count : 1));
+        if (!lums) {
+            free_lum_group(result);
+            return -1;
+        }
+        memcpy(lums, result->lums, sizeof(LUM) * result->count);
+        result->lums = lums;
+        result->lums_inline = 0;
+    }
+
+    lum_group_release_storage(group);
+    group->lums = result->lums;
+    group->count = result->count;
+    group->group_type = result->group_type;
+    group->storage = result->storage;
+    group->packed = result->packed;
+    group->compact = result->compact;
+    group->soa = result->soa;
+    group->hybrid = result->hybrid;
+    group->layout = result->layout;
+    group->owner = result->owner;
+    lum_group_touch(group); // New content, the callers rehash what they can
+
+    result->lums = NULL;
+    result->packed = NULL;
+    result->compact = NULL;
+    result->soa = NULL;
+    result->hybrid = NULL;
+    result->owner = NULL;
+    free_lum_group(result);
+    return 0;
+}
+
+/**
+ * Private dense buffer of at least count LUMs, existing LUMs kept
+ */
+static int reserve_lums(LUMGroup* group, size_t count) {
+    if (lum_group_detach(group) != 0) {
+        return -1;
+    }
+    if (count <= group->count && group->lums) {
+        return 0;
+    }
+
+    if (!group->lums_inline) {
+        LUM* grown = (LUM*)realloc(group->lums, sizeof(LUM) * count);
+        if (!grown) {
+            LOG_ERROR("Memory allocation failed growing group to %zu LUMs", count);
+            return -1;
+        }
+        group->lums = grown;
+        return 0;
+    }
+
+    // Inline LUMs cannot be resized, they move to the heap
+    LUM* lums = (LUM*)malloc(sizeof(LUM) * count);
+    if (!lums) {
+        LOG_ERROR("Memory allocation failed growing group to %zu LUMs", count);
+        return -1;
+    }
+    memcpy(lums, group->lums, sizeof(LUM) * group->count);
+    group->lums = lums;
+    group->lums_inline = 0;
+    return 0;
+}
+
+static int set_flow_target(LUMGroup* group, const char* target_zone) {
+    size_t target_len = strlen(target_zone);
+    char* target = (char*)lum_group_field_alloc(group, target_len + 1);
+    if (!target) {
+        LOG_ERROR("Memory allocation failed for spatial_data in lum_flow_inplace");
+        return -1;
+    }
+    memcpy(target, target_zone, target_len + 1);
+    lum_group_field_free(group, group->spatial_data);
+    group->spatial_data = target;
+    return 0;
+}
+
+static int cycle_lums(LUMGroup* group, int modulo) {
+    if (group->storage != LUM_STORAGE_DENSE) {
+        return replace_storage(group, lum_cycle(group, modulo));
+    }
+    if (!group->lums) {
+        LOG_ERROR("Invalid input for lum_cycle_inplace");
+        return -1;
+    }
+
+    size_t result_count_raw = group->count % modulo;
+    if (reserve_lums(group, result_count_raw > 0 ? result_count_raw : 1) != 0) {
+        return -1;
+    }
+
+    if (result_count_raw == 0) {
+        group->lums[0].presence = 1;
+        group->lums[0].structure_type = LUM_CYCLE;
+        group->lums[0].spatial_data = NULL;
+        group->lums[0].position.x = 0;
+        group->lums[0].position.y = 0;
+        group->count = 1;
+        group->layout = lum_layout_explicit();
+    } else {
+        for (size_t i = 0; i < result_count_raw; i++) {
+            group->lums[i].structure_type = LUM_CYCLE;
+        }
+        group->count = result_count_raw;
+        group->layout = lum_layout_circle(50, 50, 30, result_count_raw);
+    }
+    group->group_type = GROUP_NODE;
+    return 0;
+}
+
+/**
+ * Cycle (⟲) in place: the result is a prefix of the source, no copy
+ */
+int lum_cycle_inplace(LUMGroup* group, int modulo) {
+    if (!group || modulo <= 0) {
+        LOG_ERROR("Invalid input for lum_cycle_inplace");
+        return -1;
+    }
+
+    int rehash = group->hash_cached;
+    if (cycle_lums(group, modulo) != 0) {
+        return -1;
+    }
+    // lum_cycle results carry no spatial data (a flow target would be stale)
+    lum_group_field_free(group, group->spatial_data);
+    group->spatial_data = NULL;
+    if (rehash) {
+        group->hash_sum = lum_group_hash_words(group, 0, SIZE_MAX); // Kept LUMs only
+        group->hash_cached = 1;
+    }
+    return 0;
+}
+
+/**
+ * Flow (→) in place: types reset and layout moved, no copy
+ */
+int lum_flow_inplace(LUMGroup* group, const char* target_zone) {
+    if (!group || !target_zone) {
+        LOG_ERROR("Invalid input for lum_flow_inplace");
+        return -1;
+    }
+    if (group->storage != LUM_STORAGE_DENSE) {
+        // Same presence bits, the cached hash stays valid
+        uint64_t hash_sum = group->hash_sum;
+        int hash_cached = group->hash_cached;
+        if (replace_storage(group, lum_flow(group, target_zone)) != 0) {
+            return -1;
+        }
+        group->hash_sum = hash_sum;
+        group->hash_cached = hash_cached;
+        return set_flow_target(group, target_zone);
+    }
+    int hash_cached = group->hash_cached; // Types only, presence untouched
+    LUM* lums = group->lums ? lum_group_writable(group) : NULL;
+    if (!lums) {
+        return -1;
+    }
+    group->hash_cached = hash_cached;
+
+    for (size_t i = 0; i < group->count; i++) {
+        lums[i].structure_type = LUM_LINEAR;
+    }
+    lum_group_translate(group, 100, 0);
+    return set_flow_target(group, target_zone);
+}
+
+static int append_lums(LUMGroup* dst, const LUMGroup* src) {
+    if (dst == src || dst->storage != LUM_STORAGE_DENSE || src->storage != LUM_STORAGE_DENSE) {
+        return replace_storage(dst, lum_fusion(dst, (LUMGroup*)src));
+    }
+    if (!dst->lums || !src->lums) {
+        LOG_ERROR("Invalid input groups for lum_fusion_append");
+        return -1;
+    }
+
+    size_t count_a = dst->count;
+    size_t total_count = count_a + src->count;
+    int shift_x = lum_fusion_shift(count_a);
+    LumLayout fused_layout;
+    int implicit = lum_layout_concat(&dst->layout, count_a, &src->layout, shift_x, &fused_layout) == 0;
+
+    if (reserve_lums(dst, total_count) != 0) {
+        return -1;
+    }
+    if (!implicit) {
+        fused_layout = lum_layout_explicit();
+        lum_group_fill_positions(dst, 0, 0, dst->lums); // Index-for-index, safe in place
+    }
+
+    memcpy(dst->lums + count_a, src->lums, sizeof(LUM) * src->count);
+    for (size_t i = count_a; i < total_count; i++) {
+        dst->lums[i].structure_type = LUM_GROUP;
+    }
+    if (!implicit) {
+        lum_group_fill_positions(src, shift_x, 0, dst->lums + count_a);
+    }
+
+    dst->count = total_count;
+    dst->group_type = GROUP_CLUSTER;
+    dst->layout = fused_layout;
+    return 0;
+}
+
+/**
+ * Fusion (⧉) into dst: src is appended, dst's LUMs stay where they are
+ */
+int lum_fusion_append(LUMGroup* dst, const LUMGroup* src) {
+    if (!dst || !src) {
+        LOG_ERROR("Invalid input groups for lum_fusion_append");
+        return -1;
+    }
+
+    // A cached hash only needs the words from dst's last one on
+    size_t tail_word = dst->count / 64;
+    int rehash = dst->hash_cached;
+    uint64_t kept_sum = rehash ? dst->hash_sum - lum_group_hash_words(dst, tail_word, tail_word + 1) : 0;
+
+    if (append_lums(dst, src) != 0) {
+        return -1;
+    }
+    if (rehash) {
+        dst->hash_sum = kept_sum + lum_group_hash_words(dst, tail_word, SIZE_MAX);
+        dst->hash_cached = 1;
+    }
+    return 0;
+}
+
+typedef struct {
+    LUMGroup** groups;
+    const size_t* offsets;  // Output index of each group's first LUM
+    size_t first;
+    size_t last;            // Exclusive
+    LUM* out;
+    int explicit_positions;
+    int status;
+} FusionRange;
+
+/**
+ * Every LUM of group into out[0 .. count), any backend
+ */
+static int expand_lums(const LUMGroup* group, LUM* out) {
+    switch (group->storage) {
+        case LUM_STORAGE_PACKED:
+            return packed_expand(group, out);
+        case LUM_STORAGE_COMPACT:
+            return compact_expand(group, out);
+        case LUM_STORAGE_SOA:
+            return soa_expand(group, out);
+        case LUM_STORAGE_HYBRID:
+            return hybrid_expand_range(group, 0, group->count, out);
+        default:
+            if (group->count > 0) {
+                memcpy(out, group->lums, sizeof(LUM) * group->count);
+            }
+            return 0;
+    }
+}
+
+/**
+ * Expand one input into its slot of the fused array
+ */
+static int fusion_copy_group(const LUMGroup* group, size_t index, size_t offset,
+                             int explicit_positions, LUM* out) {
+    LUM* dst = out + offset;
+    if (expand_lums(group, dst) != 0) {
+        return -1;
+    }
+
+    if (index > 0) {
+        for (size_t i = 0; i < group->count; i++) {
+            dst[i].structure_type = LUM_GROUP; // Every group but the first, as in lum_fusion
+        }
+    }
+    if (explicit_positions) {
+        lum_group_fill_positions(group, lum_fusion_shift(offset), 0, dst);
+    }
+    return 0;
+}
+
+static void fusion_copy_range(void* context, size_t task) {
+    FusionRange* range = (FusionRange*)context + task;
+    for (size_t g = range->first; g < range->last && range->status == 0; g++) {
+        range->status = fusion_copy_group(range->groups[g], g, range->offsets[g],
+                                          range->explicit_positions, range->out);
+    }
+}
+
+/**
+ * Contiguous runs of groups of about total / thread_count LUMs each
+ */
+static int fusion_copy_parallel(LUMGroup** groups, const size_t* offsets, size_t group_count,
+                                size_t total_count, int explicit_positions, LUM* out) {
+    size_t thread_count = lum_parallel_threads(total_count);
+    if (thread_count > group_count) {
+        thread_count = group_count;
+    }
+
+    FusionRange ranges[LUM_POOL_MAX_THREADS];
+    size_t g = 0;
+    for (size_t t = 0; t < thread_count; t++) {
+        size_t target = total_count / thread_count * (t + 1);
+        ranges[t] = (FusionRange){groups, offsets, g, g, out, explicit_positions, 0};
+        while (g < group_count && (t + 1 == thread_count || offsets[g] < target)) {
+            g++;
+        }
+        ranges[t].last = g;
+    }
+
+    lum_parallel_run(thread_count, fusion_copy_range, ranges);
+
+    for (size_t t = 0; t < thread_count; t++) {
+        if (ranges[t].status != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Fusion (⧉) of group_count groups at once: same result as folding lum_fusion
+ * left to right, with one allocation and each input copied once. Large
+ * fusions fill disjoint output ranges on the pool threads.
+ */
+LUMGroup* lum_fusion_many(LUMGroup** groups, size_t group_count) {
+    if (!groups || group_count == 0) {
+        LOG_ERROR("Invalid input for lum_fusion_many");
+        return NULL;
+    }
+
+    size_t* offsets = (size_t*)malloc(sizeof(size_t) * group_count);
+    if (!offsets) {
+        LOG_ERROR("Memory allocation failed for fusion offsets");
+        return NULL;
+    }
+
+    size_t total_count = 0;
+    for (size_t i = 0; i < group_count; i++) {
+        LUMGroup* group = groups[i];
+        if (!group || (group->storage == LUM_STORAGE_DENSE && !group->lums && group->count > 0)) {
+            LOG_ERROR("Invalid input group %zu for lum_fusion_many", i);
+            free(offsets);
+            return NULL;
+        }
+        offsets[i] = total_count;
+        total_count += group->count;
+    }
+
+    // Chain the layouts as the pairwise fold would, explicit as soon as one link
+    // fails or an input has positions its layout does not give
+    LumLayout fused_layout = groups[0]->layout;
+    int explicit_positions = 0;
+    for (size_t i = 0; i < group_count && !explicit_positions; i++) {
+        explicit_positions = !lum_group_layout_complete(groups[i]);
+    }
+    for (size_t i = 1; i < group_count && !explicit_positions; i++) {
+        LumLayout next;
+        if (lum_layout_concat(&fused_layout, offsets[i], &groups[i]->layout,
+                              lum_fusion_shift(offsets[i]), &next) != 0) {
+            explicit_positions = 1;
+        } else {
+            fused_layout = next;
+        }
+    }
+    if (explicit_positions) {
+        fused_layout = lum_layout_explicit();
+    }
+
+    LUMGroup* fused_group = lum_group_alloc(total_count, GROUP_CLUSTER);
+    if (!fused_group) {
+        LOG_ERROR("Memory allocation failed for fused LUM group");
+        free(offsets);
+        return NULL;
+    }
+
+    int status = fusion_copy_parallel(groups, offsets, group_count, total_count,
+                                      explicit_positions, fused_group->lums);
+    free(offsets);
+
+    if (status != 0) {
+        LOG_ERROR("Failed to expand input groups for lum_fusion_many");
+        free_lum_group(fused_group);
+        return NULL;
+    }
+
+    fused_group->layout = fused_layout;
+    return fused_group;
+}
+
 /**
  * Advanced Operation: Organic Fusion
  * Fuses groups while preserving spatial relationships
  */
+/**
+ * Group with LUMs organic fusion can read (NULL groups are skipped)
+ */
+static int organic_input(const LUMGroup* group) {
+    return group && (group->lums || group->packed || group->compact || group->soa || group->hybrid);
+}
+
 LUMGroup* lum_organic_fusion(LUMGroup** groups, size_t group_count) {
     if (!groups || group_count == 0) {
         LOG_ERROR("Invalid input for lum_organic_fusion");
@@ -282,7 +806,7 @@ LUMGroup* lum_organic_fusion(LUMGroup** groups, size_t group_count) {
 
     size_t total_count = 0;
     for (size_t i = 0; i < group_count; i++) {
-        if (groups[i] && groups[i]->lums) {
+        if (organic_input(groups[i])) {
             total_count += groups[i]->count;
         }
     }
@@ -292,80 +816,113 @@ LUMGroup* lum_organic_fusion(LUMGroup** groups, size_t group_count) {
         return NULL;
     }
 
-    LUM* fused_lums = (LUM*)malloc(sizeof(LUM) * total_count);
-    if (!fused_lums) {
+    LUMGroup* fused_group = lum_group_alloc(total_count, GROUP_CLUSTER);
+    if (!fused_group) {
         LOG_ERROR("Memory allocation failed for fused LUMs in organic fusion");
         return NULL;
     }
+    LUM* fused_lums = fused_group->lums;
 
     size_t current_pos = 0;
-    int spiral_radius = 0;
-    double angle = 0;
-    const double PI = 3.14159265359;
-    const double angle_increment = 0.5;
-    const int radius_increment = 10;
 
     for (size_t i = 0; i < group_count; i++) {
-        if (!groups[i] || !groups[i]->lums) continue;
+        if (!organic_input(groups[i])) continue;
 
+        if (expand_lums(groups[i], fused_lums + current_pos) != 0) {
+            LOG_ERROR("Failed to expand group %zu in organic fusion", i);
+            free_lum_group(fused_group);
+            return NULL;
+        }
         for (size_t j = 0; j < groups[i]->count; j++) {
-            // Copy LUM data
-            fused_lums[current_pos] = groups[i]->lums[j];
-
-            // Arrange in spiral pattern
-            fused_lums[current_pos].position.x = (int)(spiral_radius * cos(angle));
-            fused_lums[current_pos].position.y = (int)(spiral_radius * sin(angle));
             fused_lums[current_pos].structure_type = LUM_GROUP; // Mark as part of fusion
-
-            // Update spiral parameters
-            angle += angle_increment;
-            if (angle > 2 * PI) {
-                angle = fmod(angle, 2 * PI); // Keep angle within [0, 2*PI)
-                spiral_radius += radius_increment;
-            }
-
             current_pos++;
         }
     }
 
-    LUMGroup* fused_group = create_lum_group(fused_lums, total_count, GROUP_CLUSTER);
-    if (!fused_group) {
-        free(fused_lums); // Clean up if create_lum_group fails
-        LOG_ERROR("Failed to create fused LUM group in organic fusion");
-        return NULL;
-    }
+    // Arrange in spiral pattern: angle += 0.5, radius += 10 per turn
+    fused_group->layout = lum_layout_spiral(0.5, 10);
     return fused_group;
 }
 
+typedef struct {
+    const LUM* lums;
+    size_t start;
+    size_t count;
+    size_t counts[LUM_STRUCTURE_TYPES + 1]; // Histogram, then the scatter cursors
+    LUM* out;
+} SplitRange;
+
+static void split_count_range(void* context, size_t task) {
+    SplitRange* range = (SplitRange*)context + task;
+    const LUM* lums = range->lums + range->start;
+    for (size_t i = 0; i < range->count; i++) {
+        unsigned type = (unsigned)lums[i].structure_type;
+        range->counts[type < LUM_STRUCTURE_TYPES ? type : LUM_STRUCTURE_TYPES]++;
+    }
+}
+
+static void split_scatter_range(void* context, size_t task) {
+    SplitRange* range = (SplitRange*)context + task;
+    const LUM* lums = range->lums + range->start;
+    for (size_t i = 0; i < range->count; i++) {
+        unsigned type = (unsigned)lums[i].structure_type;
+        if (type < LUM_STRUCTURE_TYPES) {
+            range->out[range->counts[type]++] = lums[i];
+        }
+    }
+}
+
 /**
  * Advanced Operation: Contextual Split
  * Splits based on LUM properties rather than equal distribution
  */
 LUMGroup** lum_contextual_split(LUMGroup* source, size_t* result_count) {
+    if (source && source->storage == LUM_STORAGE_SOA) {
+        return soa_contextual_split(source, result_count);
+    }
+    if (source && result_count && (source->storage == LUM_STORAGE_COMPACT ||
+                                   source->storage == LUM_STORAGE_PACKED ||
+                                   source->storage == LUM_STORAGE_HYBRID)) {
+        // Split a dense expansion, per-type results are dense
+        LUMGroup* dense = lum_group_alloc(source->count, source->group_type);
+        if (dense && expand_lums(source, dense->lums) != 0) {
+            free_lum_group(dense);
+            dense = NULL;
+        }
+        LUMGroup** result = dense ? lum_contextual_split(dense, result_count) : NULL;
+        if (!dense) *result_count = 0;
+        free_lum_group(dense);
+        return result;
+    }
     if (!source || !source->lums || !result_count) {
         if (result_count) *result_count = 0;
         LOG_ERROR("Invalid input for lum_contextual_split");
         return NULL;
     }
 
-    // Count different structure types
-    // Assuming LumStructureType is an enum: LUM_NODE, LUM_LINEAR, LUM_GROUP, LUM_CYCLE
-    // And these map to indices 0, 1, 2, 3 respectively.
-    size_t type_counts[4] = {0};
-    for (size_t i = 0; i < source->count; i++) {
-        // Ensure the structure_type is within the bounds of our array
-        if (source->lums[i].structure_type < 4) {
-            type_counts[source->lums[i].structure_type]++;
-        } else {
-            LOG_ERROR("Encountered unexpected structure_type %d", source->lums[i].structure_type);
-            // Potentially treat as an error or assign to a default category
+    // One slot per structure type, unexpected values counted in the last one
+    size_t type_counts[LUM_STRUCTURE_TYPES + 1] = {0};
+    size_t thread_count = lum_parallel_threads(source->count);
+    SplitRange ranges[LUM_POOL_MAX_THREADS];
+    for (size_t t = 0; t < thread_count; t++) {
+        size_t first, last;
+        lum_parallel_chunk(source->count, thread_count, t, &first, &last);
+        ranges[t] = (SplitRange){source->lums, first, last - first, {0}, NULL};
+    }
+    lum_parallel_run(thread_count, split_count_range, ranges);
+    for (size_t t = 0; t < thread_count; t++) {
+        for (int type = 0; type <= LUM_STRUCTURE_TYPES; type++) {
+            type_counts[type] += ranges[t].counts[type];
         }
     }
 
-    // Count non-empty types to determine the size of the result array
+    if (type_counts[LUM_STRUCTURE_TYPES] > 0) {
+        LOG_ERROR("Encountered %zu LUMs with unexpected structure_type", type_counts[LUM_STRUCTURE_TYPES]);
+    }
+    size_t known = source->count - type_counts[LUM_STRUCTURE_TYPES];
     size_t active_types = 0;
-    for (int i = 0; i < 4; i++) {
-        if (type_counts[i] > 0) active_types++;
+    for (int type = 0; type < LUM_STRUCTURE_TYPES; type++) {
+        if (type_counts[type] > 0) active_types++;
     }
 
     if (active_types == 0) {
@@ -374,65 +931,73 @@ LUMGroup** lum_contextual_split(LUMGroup* source, size_t* result_count) {
         return NULL;
     }
 
-    LUMGroup** result = (LUMGroup**)malloc(sizeof(LUMGroup*) * active_types);
+    LUMGroup** result = (LUMGroup**)calloc(active_types, sizeof(LUMGroup*));
     if (!result) {
         *result_count = 0;
         LOG_ERROR("Memory allocation failed for result array in contextual split");
         return NULL;
     }
 
-    size_t group_index = 0;
-    for (int type = 0; type < 4; type++) {
-        if (type_counts[type] == 0) continue; // Skip types with no LUMs
+    // A single type is already partitioned: view the source as is when it is
+    // already shared, sharing it here would move LUMs under the caller
+    LUMGroup* backing = source;
+    if (active_types > 1 || known < source->count || !lum_group_is_view(source)) {
+        // Prefix sums give each type its slice of one buffer, and each range
+        // its place inside the slice, so the scatter stays stable per type
+        size_t type_start[LUM_STRUCTURE_TYPES];
+        size_t offset = 0;
+        for (int type = 0; type < LUM_STRUCTURE_TYPES; type++) {
+            type_start[type] = offset;
+            offset += type_counts[type];
+        }
 
-        // Allocate memory for LUMs of the current type
-        LUM* type_lums = (LUM*)malloc(sizeof(LUM) * type_counts[type]);
-        if (!type_lums) {
-            LOG_ERROR("Memory allocation failed for LUMs of type %d in contextual split", type);
-            // Cleanup on failure: free allocated memory for LUMs and previously created groups
-            for (size_t i = 0; i < group_index; i++) {
-                free_lum_group(result[i]);
-            }
+        LUM* lums = (LUM*)malloc(sizeof(LUM) * known);
+        backing = lums ? lum_group_adopt(lums, known, GROUP_LINEAR) : NULL;
+        if (!backing) {
+            free(lums);
             free(result);
             *result_count = 0;
+            LOG_ERROR("Memory allocation failed for contextual split buffer");
             return NULL;
         }
 
-        size_t type_index = 0;
-        // Populate the type_lums array with LUMs of the current type
-        for (size_t i = 0; i < source->count; i++) {
-            if (source->lums[i].structure_type == (LumStructureType)type) {
-                type_lums[type_index] = source->lums[i];
-                // Adjust positions based on type and index within the type
-                type_lums[type_index].position.x = (int)(type_index * 20);
-                type_lums[type_index].position.y = type * 40; // Different Y for each type
-                type_index++;
+        for (size_t t = 0; t < thread_count; t++) {
+            for (int type = 0; type < LUM_STRUCTURE_TYPES; type++) {
+                size_t range_count = ranges[t].counts[type];
+                ranges[t].counts[type] = type_start[type];
+                type_start[type] += range_count;
             }
+            ranges[t].out = lums;
         }
+        lum_parallel_run(thread_count, split_scatter_range, ranges);
+    }
 
-        // Determine the group type based on the LUM structure type
-        GroupType group_type;
-        if (type == LUM_GROUP) { // Assuming LUM_GROUP is mapped to index 2
-            group_type = GROUP_CLUSTER;
-        } else {
-            group_type = GROUP_LINEAR;
-        }
+    size_t group_index = 0;
+    size_t offset = 0;
+    for (int type = 0; type < LUM_STRUCTURE_TYPES; type++) {
+        if (type_counts[type] == 0) continue; // Skip types with no LUMs
 
-        result[group_index] = create_lum_group(type_lums, type_counts[type], group_type);
+        GroupType group_type = type == LUM_GROUP || type == LUM_CLUSTER ? GROUP_CLUSTER : GROUP_LINEAR;
+        result[group_index] = lum_group_borrow_range(backing, offset, type_counts[type], group_type);
         if (!result[group_index]) {
             LOG_ERROR("Failed to create LUM group for type %d in contextual split", type);
-            // Cleanup on failure: free allocated memory for LUMs, then previously created groups and the result array
-            free(type_lums);
-            for (size_t i = 0; i < group_index; i++) {
-                free_lum_group(result[i]);
+            free_split_result(result, group_index);
+            if (backing != source) {
+                free_lum_group(backing);
             }
-            free(result);
             *result_count = 0;
             return NULL;
         }
+        result[group_index]->layout = lum_layout_linear(0, type * 40, 20); // Different Y for each type
+        offset += type_counts[type];
         group_index++;
     }
 
+    // The views keep the buffer alive
+    if (backing != source) {
+        free_lum_group(backing);
+    }
+
     *result_count = active_types;
     return result;
 }
@@ -9,6 +9,15 @@ LUMGroup** lum_split(LUMGroup* source, int zones, size_t* result_count);
 LUMGroup* lum_cycle(LUMGroup* source, int modulo);
 LUMGroup* lum_flow(LUMGroup* source, const char* target_zone);
 
+// In-place variants: same result written into the group itself (copied first
+// if its storage is shared), id and other metadata kept. 0 or -1.
+int lum_cycle_inplace(LUMGroup* group, int modulo);
+int lum_flow_inplace(LUMGroup* group, const char* target_zone);
+int lum_fusion_append(LUMGroup* dst, const LUMGroup* src);
+
+// Left fold of lum_fusion over groups, single allocation
+LUMGroup* lum_fusion_many(LUMGroup** groups, size_t group_count);
+
 // Advanced operations
 LUMGroup* lum_organic_fusion(LUMGroup** groups, size_t group_count);
 LUMGroup** lum_contextual_split(LUMGroup* source, size_t* result_count);
@@ -0,0 +1,676 @@
+#include "lums.h"
+#include "packed.h"
+#include "operations.h"
+#include "layout.h"
+#include "compact.h"
+#include "soa.h"
+#include "hybrid.h"
+#include "view.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#ifndef LOG_ERROR
+#define LOG_ERROR(...) fprintf(stderr, "ERROR: " __VA_ARGS__); fprintf(stderr, "\n")
+#endif
+
+#define PACKED_WORDS(count) (((count) + 63) / 64)
+
+/**
+ * Structure type of LUM index (binary search over the type runs)
+ */
+LumStructureType lum_type_runs_at(const LumTypeRun* runs, size_t run_count, size_t index) {
+    size_t lo = 0;
+    size_t hi = run_count;
+
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (runs[mid].start <= index) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return runs[lo].structure_type;
+}
+
+int lum_overrides_push(LumPositionOverride** overrides, size_t* count, size_t* capacity,
+                       size_t index, int x, int y) {
+    if (*count == *capacity) {
+        size_t new_capacity = *capacity ? *capacity * 2 : 16;
+        LumPositionOverride* grown = (LumPositionOverride*)realloc(
+            *overrides, sizeof(LumPositionOverride) * new_capacity);
+        if (!grown) {
+            return -1;
+        }
+        *overrides = grown;
+        *capacity = new_capacity;
+    }
+
+    (*overrides)[*count].index = index;
+    (*overrides)[*count].x = x;
+    (*overrides)[*count].y = y;
+    (*count)++;
+    return 0;
+}
+
+int lum_type_runs_push(LumTypeRun** runs, size_t* run_count, size_t* capacity,
+                       size_t start, LumStructureType type) {
+    if (*run_count > 0 && (*runs)[*run_count - 1].structure_type == type) {
+        return 0; // Extends the previous run
+    }
+
+    if (*run_count == *capacity) {
+        size_t new_capacity = *capacity ? *capacity * 2 : 4;
+        LumTypeRun* grown = (LumTypeRun*)realloc(*runs, sizeof(LumTypeRun) * new_capacity);
+        if (!grown) {
+            return -1;
+        }
+        *runs = grown;
+        *capacity = new_capacity;
+    }
+
+    (*runs)[*run_count].start = start;
+    (*runs)[*run_count].structure_type = type;
+    (*run_count)++;
+    return 0;
+}
+
+static LumStructureType packed_type_at(const LumPackedStorage* packed, size_t index) {
+    return lum_type_runs_at(packed->type_runs, packed->type_run_count, index);
+}
+
+static int packed_push_override(LumPackedStorage* packed, size_t* capacity,
+                                size_t index, int x, int y) {
+    return lum_overrides_push(&packed->overrides, &packed->override_count, capacity, index, x, y);
+}
+
+static int packed_push_type_run(LumPackedStorage* packed, size_t* capacity,
+                                size_t start, LumStructureType type) {
+    return lum_type_runs_push(&packed->type_runs, &packed->type_run_count, capacity, start, type);
+}
+
+/**
+ * Copy bit_count bits between word arrays at arbitrary bit offsets.
+ * Destination bits outside the copied range are preserved.
+ */
+void lum_bits_copy(uint64_t* dst, size_t dst_bit,
+                   const uint64_t* src, size_t src_bit, size_t bit_count) {
+    if (((dst_bit | src_bit) & 63) == 0) {
+        size_t full_words = bit_count / 64;
+        memcpy(dst + dst_bit / 64, src + src_bit / 64, full_words * sizeof(uint64_t));
+        dst_bit += full_words * 64;
+        src_bit += full_words * 64;
+        bit_count -= full_words * 64;
+    }
+
+    while (bit_count > 0) {
+        size_t dst_offset = dst_bit & 63;
+        size_t src_offset = src_bit & 63;
+        size_t chunk = 64 - dst_offset;
+        if (chunk > bit_count) {
+            chunk = bit_count;
+        }
+
+        uint64_t bits = src[src_bit / 64] >> src_offset;
+        if (src_offset != 0 && src_offset + chunk > 64) {
+            bits |= src[src_bit / 64 + 1] << (64 - src_offset);
+        }
+
+        uint64_t mask = chunk == 64 ? ~0ULL : ((1ULL << chunk) - 1);
+        uint64_t* word = &dst[dst_bit / 64];
+        *word = (*word & ~(mask << dst_offset)) | ((bits & mask) << dst_offset);
+
+        dst_bit += chunk;
+        src_bit += chunk;
+        bit_count -= chunk;
+    }
+}
+
+/**
+ * Create a packed LUM group with all presence bits cleared.
+ * Default layout matches encode_bit_to_lum: linear, 20 units apart.
+ */
+LUMGroup* create_packed_lum_group(size_t count, GroupType type) {
+    LUMGroup* group = (LUMGroup*)calloc(1, sizeof(LUMGroup));
+    if (!group) {
+        LOG_ERROR("Memory allocation failed for packed LUMGroup");
+        return NULL;
+    }
+
+    LumPackedStorage* packed = (LumPackedStorage*)calloc(1, sizeof(LumPackedStorage));
+    if (!packed) {
+        free(group);
+        LOG_ERROR("Memory allocation failed for packed storage");
+        return NULL;
+    }
+
+    packed->word_count = PACKED_WORDS(count);
+    if (packed->word_count == 1) {
+        packed->words = &packed->inline_word;
+    } else if (packed->word_count > 0) {
+        packed->words = (uint64_t*)calloc(packed->word_count, sizeof(uint64_t));
+    }
+    packed->type_runs = (LumTypeRun*)malloc(sizeof(LumTypeRun));
+    if ((packed->word_count > 0 && !packed->words) || !packed->type_runs) {
+        free_packed_storage(packed);
+        free(group);
+        LOG_ERROR("Memory allocation failed for %zu packed LUMs", count);
+        return NULL;
+    }
+
+    packed->type_runs[0].start = 0;
+    packed->type_runs[0].structure_type = LUM_LINEAR;
+    packed->type_run_count = 1;
+
+    group->count = count;
+    group->group_type = type;
+    group->storage = LUM_STORAGE_PACKED;
+    group->packed = packed;
+    group->layout = lum_layout_linear(0, 0, 20);
+
+    return group;
+}
+
+void free_packed_storage(LumPackedStorage* packed) {
+    if (!packed) {
+        return;
+    }
+    if (packed->words != &packed->inline_word) {
+        free(packed->words);
+    }
+    free(packed->type_runs);
+    free(packed->overrides);
+    free(packed);
+}
+
+static size_t packed_count_mismatches(const LUM* lums, size_t count, const LumLayout* base,
+                                     const LumLayout* layout) {
+    size_t mismatches = 0;
+    for (size_t i = 0; i < count; i++) {
+        int x, y;
+        lum_layout_position(layout, i, &x, &y);
+        if (lums[i].position.x + base->offset_x != x || lums[i].position.y + base->offset_y != y) {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+/**
+ * Build a packed copy of a dense (or compact / SoA / hybrid) group.
+ * Fails if any LUM carries per-LUM spatial data, which packed storage drops.
+ */
+LUMGroup* packed_from_dense(const LUMGroup* source) {
+    if (source && source->storage == LUM_STORAGE_HYBRID) {
+        return hybrid_to_packed(source);
+    }
+    if (source && (source->storage == LUM_STORAGE_COMPACT || source->storage == LUM_STORAGE_SOA)) {
+        LUMGroup* dense = source->storage == LUM_STORAGE_COMPACT ?
+            compact_to_dense(source) : soa_to_dense(source);
+        LUMGroup* result = packed_from_dense(dense);
+        free_lum_group(dense);
+        return result;
+    }
+    if (!source || source->storage != LUM_STORAGE_DENSE || (!source->lums && source->count > 0)) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < source->count; i++) {
+        if (source->lums[i].spatial_data) {
+            LOG_ERROR("Cannot pack LUM %zu: per-LUM spatial data is not representable", i);
+            return NULL;
+        }
+    }
+
+    LUMGroup* result = create_packed_lum_group(source->count, source->group_type);
+    if (!result) {
+        return NULL;
+    }
+    LumPackedStorage* packed = result->packed;
+    const LumLayout* base = &source->layout;
+    int explicit_positions = base->kind == LUM_LAYOUT_EXPLICIT;
+
+    for (size_t i = 0; i < source->count; i++) {
+        if (source->lums[i].presence) {
+            packed->words[i / 64] |= 1ULL << (i % 64);
+        }
+    }
+
+    if (!explicit_positions) {
+        result->layout = *base; // Implicit layouts carry over as is
+    } else if (source->count > 0) {
+        // Pick the cheaper of a linear layout inferred from the first two LUMs
+        // and the 32-column grid produced by encode_array
+        const LUM* lums = source->lums;
+        int x0 = lums[0].position.x + base->offset_x;
+        int y0 = lums[0].position.y + base->offset_y;
+        int stride = source->count > 1 ? lums[1].position.x - lums[0].position.x : 20;
+
+        LumLayout linear = lum_layout_linear(x0, y0, stride);
+        LumLayout grid = lum_layout_grid(x0, y0, 20, 32, 30);
+
+        size_t linear_misses = packed_count_mismatches(lums, source->count, base, &linear);
+        size_t grid_misses = linear_misses > 0 ?
+            packed_count_mismatches(lums, source->count, base, &grid) : linear_misses;
+        result->layout = grid_misses < linear_misses ? grid : linear;
+    }
+
+    size_t run_capacity = 1;
+    size_t override_capacity = 0;
+    const LumLayout* layout = &result->layout;
+    packed->type_run_count = 0;
+
+    for (size_t i = 0; i < source->count; i++) {
+        if (packed_push_type_run(packed, &run_capacity, i, source->lums[i].structure_type) != 0) {
+            free_lum_group(result);
+            return NULL;
+        }
+        if (!explicit_positions) {
+            continue;
+        }
+        int x, y;
+        int actual_x = source->lums[i].position.x + base->offset_x;
+        int actual_y = source->lums[i].position.y + base->offset_y;
+        lum_layout_position(layout, i, &x, &y);
+        if ((actual_x != x || actual_y != y) &&
+            packed_push_override(packed, &override_capacity, i,
+                                 actual_x - layout->offset_x, actual_y - layout->offset_y) != 0) {
+            free_lum_group(result);
+            return NULL;
+        }
+    }
+    if (packed->type_run_count == 0) {
+        packed->type_run_count = 1; // Empty group keeps the default LUM_LINEAR run
+    }
+
+    return result;
+}
+
+/**
+ * Deep copy of a packed group
+ */
+LUMGroup* packed_clone(const LUMGroup* source) {
+    if (!source || source->storage != LUM_STORAGE_PACKED || !source->packed) {
+        return NULL;
+    }
+
+    const LumPackedStorage* src = source->packed;
+    LUMGroup* result = create_packed_lum_group(source->count, source->group_type);
+    if (!result) {
+        return NULL;
+    }
+    LumPackedStorage* dst = result->packed;
+
+    if (src->word_count > 0) {
+        memcpy(dst->words, src->words, sizeof(uint64_t) * src->word_count);
+    }
+
+    LumTypeRun* runs = (LumTypeRun*)malloc(sizeof(LumTypeRun) * src->type_run_count);
+    LumPositionOverride* overrides = NULL;
+    if (src->override_count > 0) {
+        overrides = (LumPositionOverride*)malloc(sizeof(LumPositionOverride) * src->override_count);
+    }
+    if (!runs || (src->override_count > 0 && !overrides)) {
+        free(runs);
+        free(overrides);
+        free_lum_group(result);
+        return NULL;
+    }
+
+    memcpy(runs, src->type_runs, sizeof(LumTypeRun) * src->type_run_count);
+    if (overrides) {
+        memcpy(overrides, src->overrides, sizeof(LumPositionOverride) * src->override_count);
+    }
+
+    free(dst->type_runs);
+    dst->type_runs = runs;
+    dst->type_run_count = src->type_run_count;
+    dst->overrides = overrides;
+    dst->override_count = src->override_count;
+    result->layout = source->layout;
+
+    return result;
+}
+
+/**
+ * Convert a dense group to packed storage in place
+ */
+int lum_group_pack(LUMGroup* group) {
+    if (!group) {
+        return -1;
+    }
+    if (group->storage == LUM_STORAGE_PACKED) {
+        return 0;
+    }
+
+    LUMGroup* packed_group = packed_from_dense(group);
+    if (!packed_group) {
+        return -1;
+    }
+
+    lum_group_release_storage(group);
+    group->storage = LUM_STORAGE_PACKED;
+    group->packed = packed_group->packed;
+    group->layout = packed_group->layout;
+
+    packed_group->packed = NULL;
+    free(packed_group);
+    return 0;
+}
+
+/**
+ * Convert a packed group back to one LUM struct per bit, in place
+ */
+int lum_group_unpack(LUMGroup* group) {
+    if (!group) {
+        return -1;
+    }
+    if (group->storage == LUM_STORAGE_DENSE) {
+        return 0;
+    }
+    if (group->storage != LUM_STORAGE_PACKED) {
+        return -1;
+    }
+
+    LUM* lums = (LUM*)malloc(sizeof(LUM) * (group->count > 0 ? group->count : 1));
+    if (!lums) {
+        LOG_ERROR("Memory allocation failed unpacking %zu LUMs", group->count);
+        return -1;
+    }
+    packed_expand(group, lums);
+    if (group->packed->override_count > 0) {
+        group->layout = lum_layout_explicit(); // Positions laid out by hand
+    }
+
+    lum_group_release_storage(group);
+    group->lums = lums;
+    group->storage = LUM_STORAGE_DENSE;
+    return 0;
+}
+
+uint8_t packed_get_presence(const LUMGroup* group, size_t index) {
+    if (!group || !group->packed || index >= group->count) {
+        return 0;
+    }
+    return (uint8_t)((group->packed->words[index / 64] >> (index % 64)) & 1);
+}
+
+int packed_get_lum(const LUMGroup* group, size_t index, LUM* out) {
+    if (!group || !group->packed || !out || index >= group->count) {
+        return -1;
+    }
+
+    out->presence = packed_get_presence(group, index);
+    out->structure_type = packed_type_at(group->packed, index);
+    out->spatial_data = NULL;
+    return lum_group_position(group, index, &out->position.x, &out->position.y);
+}
+
+/**
+ * Materialize every LUM of a packed group into out[0..count)
+ */
+int packed_expand(const LUMGroup* group, LUM* out) {
+    return group ? packed_expand_range(group, 0, group->count, out) : -1;
+}
+
+int packed_expand_range(const LUMGroup* group, size_t start, size_t count, LUM* out) {
+    if (!group || !group->packed || (!out && count > 0) ||
+        start > group->count || count > group->count - start) {
+        return -1;
+    }
+
+    const LumPackedStorage* packed = group->packed;
+    size_t run = 0;
+
+    for (size_t k = 0; k < count; k++) {
+        size_t i = start + k;
+        while (run + 1 < packed->type_run_count && packed->type_runs[run + 1].start <= i) {
+            run++;
+        }
+
+        out[k].presence = (uint8_t)((packed->words[i / 64] >> (i % 64)) & 1);
+        out[k].structure_type = packed->type_runs[run].structure_type;
+        out[k].spatial_data = NULL;
+    }
+    // One range fill: trig layouts are not sought again for every LUM
+    return lum_group_fill_positions_range(group, start, count, 0, 0, out);
+}
+
+size_t packed_popcount(const LUMGroup* group) {
+    if (!group || !group->packed) {
+        return 0;
+    }
+
+    size_t ones = 0;
+    for (size_t w = 0; w < group->packed->word_count; w++) {
+        ones += (size_t)__builtin_popcountll(group->packed->words[w]);
+    }
+    return ones;
+}
+
+/**
+ * Packed Fusion (⧉): word-level concatenation.
+ * Positions of the second group are shifted by group1->count * 20 and
+ * only stored where they leave the fused default layout.
+ */
+LUMGroup* packed_lum_fusion(LUMGroup* group1, LUMGroup* group2) {
+    if (!group1 || !group2) {
+        LOG_ERROR("Invalid input groups for packed_lum_fusion");
+        return NULL;
+    }
+
+    // Mixed storage: pack the dense operand into a temporary
+    LUMGroup* temp1 = group1->storage == LUM_STORAGE_PACKED ? NULL : packed_from_dense(group1);
+    LUMGroup* temp2 = group2->storage == LUM_STORAGE_PACKED ? NULL : packed_from_dense(group2);
+    LUMGroup* a = temp1 ? temp1 : group1;
+    LUMGroup* b = temp2 ? temp2 : group2;
+    LUMGroup* result = NULL;
+
+    if (a->storage != LUM_STORAGE_PACKED || b->storage != LUM_STORAGE_PACKED) {
+        LOG_ERROR("Failed to pack operands for packed_lum_fusion");
+        goto cleanup;
+    }
+
+    const LumPackedStorage* pa = a->packed;
+    const LumPackedStorage* pb = b->packed;
+    size_t total_count = a->count + b->count;
+    int shift_x = lum_fusion_shift(a->count);
+
+    result = create_packed_lum_group(total_count, GROUP_CLUSTER);
+    if (!result) {
+        LOG_ERROR("Failed to create fused packed LUM group");
+        goto cleanup;
+    }
+    LumPackedStorage* out = result->packed;
+
+    if (pa->word_count > 0) {
+        memcpy(out->words, pa->words, sizeof(uint64_t) * pa->word_count);
+    }
+    if (b->count > 0) {
+        lum_bits_copy(out->words, a->count, pb->words, 0, b->count);
+    }
+
+    size_t run_capacity = 1;
+    out->type_run_count = 0;
+    for (size_t r = 0; r < pa->type_run_count && a->count > 0; r++) {
+        if (packed_push_type_run(out, &run_capacity, pa->type_runs[r].start,
+                                 pa->type_runs[r].structure_type) != 0) {
+            goto fail;
+        }
+    }
+    if (b->count > 0 && packed_push_type_run(out, &run_capacity, a->count, LUM_GROUP) != 0) {
+        goto fail;
+    }
+    if (out->type_run_count == 0) {
+        out->type_runs[0].structure_type = LUM_LINEAR;
+        out->type_run_count = 1;
+    }
+
+    size_t override_capacity = 0;
+    for (size_t i = 0; i < pa->override_count; i++) {
+        if (packed_push_override(out, &override_capacity, pa->overrides[i].index,
+                                 pa->overrides[i].x, pa->overrides[i].y) != 0) {
+            goto fail;
+        }
+    }
+
+    if (lum_layout_concat(&a->layout, a->count, &b->layout, shift_x, &result->layout) == 0) {
+        // Second operand lines up with the fused layout: rebase its overrides only
+        int rebase_x = b->layout.offset_x + shift_x - result->layout.offset_x;
+        int rebase_y = b->layout.offset_y - result->layout.offset_y;
+        for (size_t i = 0; i < pb->override_count; i++) {
+            if (packed_push_override(out, &override_capacity, pb->overrides[i].index + a->count,
+                                     pb->overrides[i].x + rebase_x, pb->overrides[i].y + rebase_y) != 0) {
+                goto fail;
+            }
+        }
+    } else if (b->count > 0) {
+        // Keep the first operand's layout, store the second one's deviations
+        result->layout = a->layout;
+        LUM* actual = (LUM*)malloc(sizeof(LUM) * b->count * 2);
+        if (!actual) {
+            goto fail;
+        }
+        LUM* expected = actual + b->count;
+        lum_group_fill_positions(b, shift_x, 0, actual);
+        lum_layout_fill(&result->layout, a->count, b->count, expected);
+
+        for (size_t j = 0; j < b->count; j++) {
+            if ((actual[j].position.x != expected[j].position.x ||
+                 actual[j].position.y != expected[j].position.y) &&
+                packed_push_override(out, &override_capacity, a->count + j,
+                                     actual[j].position.x - result->layout.offset_x,
+                                     actual[j].position.y - result->layout.offset_y) != 0) {
+                free(actual);
+                goto fail;
+            }
+        }
+        free(actual);
+    } else {
+        result->layout = a->layout;
+    }
+    goto cleanup;
+
+fail:
+    LOG_ERROR("Memory allocation failed in packed_lum_fusion");
+    free_lum_group(result);
+    result = NULL;
+
+cleanup:
+    free_lum_group(temp1);
+    free_lum_group(temp2);
+    return result;
+}
+
+/**
+ * Packed Split (⇅): each zone receives a bit range, laid out linearly
+ * at y = zone * 50 exactly like the dense split, so no overrides are stored.
+ */
+LUMGroup** packed_lum_split(LUMGroup* source, int zones, size_t* result_count) {
+    if (!source || !source->packed || zones <= 0 || !result_count) {
+        if (result_count) *result_count = 0;
+        LOG_ERROR("Invalid input for packed_lum_split");
+        return NULL;
+    }
+
+    LUMGroup** result = (LUMGroup**)malloc(sizeof(LUMGroup*) * zones);
+    if (!result) {
+        *result_count = 0;
+        LOG_ERROR("Memory allocation failed for split result array");
+        return NULL;
+    }
+
+    size_t lums_per_zone = source->count / zones;
+    size_t remainder = source->count % zones;
+    size_t current_index = 0;
+
+    for (int i = 0; i < zones; i++) {
+        size_t zone_count = lums_per_zone + ((size_t)i < remainder ? 1 : 0);
+
+        result[i] = create_packed_lum_group(zone_count, GROUP_LINEAR);
+        if (!result[i]) {
+            LOG_ERROR("Failed to create packed LUM group for zone %d", i);
+            free_split_result(result, (size_t)i);
+            *result_count = 0;
+            return NULL;
+        }
+
+        if (zone_count > 0) {
+            lum_bits_copy(result[i]->packed->words, 0, source->packed->words, current_index, zone_count);
+        }
+        result[i]->layout = lum_layout_linear(0, i * 50, 20);
+        current_index += zone_count;
+    }
+
+    *result_count = zones;
+    return result;
+}
+
+/**
+ * Packed Cycle (⟲): keeps a bit prefix laid out on a circle layout
+ */
+LUMGroup* packed_lum_cycle(LUMGroup* source, int modulo) {
+    if (!source || !source->packed || modulo <= 0) {
+        LOG_ERROR("Invalid input for packed_lum_cycle");
+        return NULL;
+    }
+
+    size_t result_count_raw = source->count % modulo;
+
+    if (result_count_raw == 0) {
+        // Single present LUM at the origin, as in the dense cycle
+        LUMGroup* result = create_packed_lum_group(1, GROUP_NODE);
+        if (!result) {
+            return NULL;
+        }
+        result->packed->words[0] = 1;
+        result->packed->type_runs[0].structure_type = LUM_CYCLE;
+        return result;
+    }
+
+    LUMGroup* result = create_packed_lum_group(result_count_raw, GROUP_NODE);
+    if (!result) {
+        LOG_ERROR("Memory allocation failed for %zu LUMs in packed_lum_cycle", result_count_raw);
+        return NULL;
+    }
+    LumPackedStorage* out = result->packed;
+
+    lum_bits_copy(out->words, 0, source->packed->words, 0, result_count_raw);
+    out->type_runs[0].structure_type = LUM_CYCLE;
+    result->layout = lum_layout_circle(50, 50, 30, result_count_raw);
+
+    return result;
+}
+
+/**
+ * Packed Flow (→): copies the words and moves the layout offset by 100
+ */
+LUMGroup* packed_lum_flow(LUMGroup* source, const char* target_zone) {
+    if (!source || !source->packed || !target_zone) {
+        LOG_ERROR("Invalid input for packed_lum_flow");
+        return NULL;
+    }
+
+    LUMGroup* result = packed_clone(source);
+    if (!result) {
+        LOG_ERROR("Failed to create LUM group for packed flow operation");
+        return NULL;
+    }
+    LumPackedStorage* out = result->packed;
+
+    lum_group_translate(result, 100, 0);
+    out->type_runs[0].structure_type = LUM_LINEAR;
+    out->type_run_count = 1;
+
+    char* target = (char*)malloc(strlen(target_zone) + 1);
+    if (target) {
+        strcpy(target, target_zone);
+        result->spatial_data = target;
+    } else {
+        LOG_ERROR("Memory allocation failed for spatial_data in packed_lum_flow");
+    }
+
+    return result;
+}
@@ -0,0 +1,39 @@
+#ifndef PACKED_H
+#define PACKED_H
+
+#include "lums.h"
+
+// Packed group management
+LUMGroup* create_packed_lum_group(size_t count, GroupType type);
+LUMGroup* packed_from_dense(const LUMGroup* source);
+LUMGroup* packed_clone(const LUMGroup* source);
+void free_packed_storage(LumPackedStorage* packed);
+int lum_group_pack(LUMGroup* group);
+int lum_group_unpack(LUMGroup* group);
+
+// Element access
+uint8_t packed_get_presence(const LUMGroup* group, size_t index);
+int packed_get_lum(const LUMGroup* group, size_t index, LUM* out);
+int packed_expand(const LUMGroup* group, LUM* out);
+// LUMs [start, start + count) only, in out[0 .. count)
+int packed_expand_range(const LUMGroup* group, size_t start, size_t count, LUM* out);
+size_t packed_popcount(const LUMGroup* group);
+
+// Word-granular bit copy (bit i lives in word i / 64, position i % 64)
+void lum_bits_copy(uint64_t* dst, size_t dst_bit,
+                   const uint64_t* src, size_t src_bit, size_t bit_count);
+
+// Type runs / position overrides (shared with hybrid storage)
+LumStructureType lum_type_runs_at(const LumTypeRun* runs, size_t run_count, size_t index);
+int lum_type_runs_push(LumTypeRun** runs, size_t* run_count, size_t* capacity,
+                       size_t start, LumStructureType type);
+int lum_overrides_push(LumPositionOverride** overrides, size_t* count, size_t* capacity,
+                       size_t index, int x, int y);
+
+// Packed VORAX operations (dispatched from operations.c)
+LUMGroup* packed_lum_fusion(LUMGroup* group1, LUMGroup* group2);
+LUMGroup** packed_lum_split(LUMGroup* source, int zones, size_t* result_count);
+LUMGroup* packed_lum_cycle(LUMGroup* source, int modulo);
+LUMGroup* packed_lum_flow(LUMGroup* source, const char* target_zone);
+
+#endif // PACKED_H
@@ -0,0 +1,428 @@
+#include "lums.h"
+#include "pipeline.h"
+#include "pool.h"
+#include "view.h"
+#include "layout.h"
+#include "packed.h"
+#include "compact.h"
+#include "soa.h"
+#include "hybrid.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef LOG_ERROR
+#define LOG_ERROR(...) fprintf(stderr, "ERROR: " __VA_ARGS__); fprintf(stderr, "\n")
+#endif
+
+#define FLOW_SHIFT_X 100   // lum_flow offset
+#define KEEP_TYPE (-1)     // No retype pending from the consumers
+
+typedef enum {
+    PIPE_INPUT,
+    PIPE_FUSION,
+    PIPE_CYCLE,
+    PIPE_FLOW,
+    PIPE_SPLIT
+} PipeKind;
+
+typedef struct {
+    PipeKind kind;
+    int inputs[2];
+    size_t count;          // LUMs yielded
+    size_t start;          // SPLIT: first source LUM of the zone
+    int shift_x;           // FUSION: shift of the second input
+    GroupType group_type;
+    LumLayout layout;      // As the eager result; explicit positions are computed per range
+    char* target_zone;     // FLOW
+    LUMGroup* value;       // INPUT group (borrowed), or shared copy of the last read
+} PipeNode;
+
+struct LumPipeline {
+    PipeNode* nodes;
+    size_t count;
+    size_t capacity;
+};
+
+LumPipeline* lum_pipeline_create(void) {
+    LumPipeline* pipeline = (LumPipeline*)calloc(1, sizeof(LumPipeline));
+    if (!pipeline) {
+        LOG_ERROR("Memory allocation failed for LUM pipeline");
+    }
+    return pipeline;
+}
+
+void lum_pipeline_free(LumPipeline* pipeline) {
+    if (!pipeline) {
+        return;
+    }
+    for (size_t i = 0; i < pipeline->count; i++) {
+        if (pipeline->nodes[i].kind != PIPE_INPUT) {
+            free_lum_group(pipeline->nodes[i].value);
+        }
+        free(pipeline->nodes[i].target_zone);
+    }
+    free(pipeline->nodes);
+    free(pipeline);
+}
+
+static const PipeNode* node_at(const LumPipeline* pipeline, int node) {
+    if (!pipeline || node < 0 || (size_t)node >= pipeline->count) {
+        return NULL;
+    }
+    return &pipeline->nodes[node];
+}
+
+/**
+ * Appends a node, returns its id or -1
+ */
+static int add_node(LumPipeline* pipeline, const PipeNode* node) {
+    if (pipeline->count == pipeline->capacity) {
+        size_t capacity = pipeline->capacity ? pipeline->capacity * 2 : 8;
+        PipeNode* nodes = (PipeNode*)realloc(pipeline->nodes, sizeof(PipeNode) * capacity);
+        if (!nodes) {
+            LOG_ERROR("Memory allocation failed for pipeline nodes");
+            return -1;
+        }
+        pipeline->nodes = nodes;
+        pipeline->capacity = capacity;
+    }
+    pipeline->nodes[pipeline->count] = *node;
+    return (int)pipeline->count++;
+}
+
+int lum_pipeline_input(LumPipeline* pipeline, LUMGroup* group) {
+    if (!pipeline || !group) {
+        LOG_ERROR("Invalid input for lum_pipeline_input");
+        return -1;
+    }
+    // Packed / hybrid overrides are only in the group: downstream nodes must
+    // come back to it for positions instead of extending its layout
+    PipeNode node = {PIPE_INPUT, {-1, -1}, group->count, 0, 0, group->group_type,
+                     lum_group_layout_complete(group) ? group->layout : lum_layout_explicit(), NULL, group};
+    return add_node(pipeline, &node);
+}
+
+int lum_pipeline_fusion(LumPipeline* pipeline, int node1, int node2) {
+    const PipeNode* a = node_at(pipeline, node1);
+    const PipeNode* b = node_at(pipeline, node2);
+    if (!a || !b) {
+        LOG_ERROR("Invalid input for lum_pipeline_fusion");
+        return -1;
+    }
+
+    PipeNode node = {PIPE_FUSION, {node1, node2}, a->count + b->count, 0,
+                     lum_fusion_shift(a->count), GROUP_CLUSTER, lum_layout_explicit(), NULL, NULL};
+    if (lum_layout_concat(&a->layout, a->count, &b->layout, node.shift_x, &node.layout) != 0) {
+        node.layout = lum_layout_explicit();
+    }
+    return add_node(pipeline, &node);
+}
+
+int lum_pipeline_cycle(LumPipeline* pipeline, int node, int modulo) {
+    const PipeNode* source = node_at(pipeline, node);
+    if (!source || modulo <= 0) {
+        LOG_ERROR("Invalid input for lum_pipeline_cycle");
+        return -1;
+    }
+
+    // Single present LUM when count % modulo is 0, as lum_cycle
+    size_t count = source->count % (size_t)modulo;
+    PipeNode cycle = {PIPE_CYCLE, {node, -1}, count > 0 ? count : 1, 0, 0, GROUP_NODE,
+                      count > 0 ? lum_layout_circle(50, 50, 30, count) : lum_layout_explicit(),
+                      NULL, NULL};
+    return add_node(pipeline, &cycle);
+}
+
+int lum_pipeline_flow(LumPipeline* pipeline, int node, const char* target_zone) {
+    const PipeNode* source = node_at(pipeline, node);
+    if (!source || !target_zone) {
+        LOG_ERROR("Invalid input for lum_pipeline_flow");
+        return -1;
+    }
+
+    PipeNode flow = {PIPE_FLOW, {node, -1}, source->count, 0, 0, source->group_type,
+                     source->layout, NULL, NULL};
+    flow.layout.offset_x += FLOW_SHIFT_X;
+    flow.target_zone = (char*)malloc(strlen(target_zone) + 1);
+    if (!flow.target_zone) {
+        LOG_ERROR("Memory allocation failed for pipeline flow target");
+        return -1;
+    }
+    strcpy(flow.target_zone, target_zone);
+
+    int id = add_node(pipeline, &flow);
+    if (id < 0) {
+        free(flow.target_zone);
+    }
+    return id;
+}
+
+int lum_pipeline_split(LumPipeline* pipeline, int node, int zones) {
+    const PipeNode* source = node_at(pipeline, node);
+    if (!source || zones <= 0) {
+        LOG_ERROR("Invalid input for lum_pipeline_split");
+        return -1;
+    }
+
+    size_t source_count = source->count;
+    int first = -1;
+    for (int i = 0; i < zones; i++) {
+        size_t zone_start, zone_end;
+        lum_parallel_chunk(source_count, (size_t)zones, (size_t)i, &zone_start, &zone_end);
+        PipeNode zone = {PIPE_SPLIT, {node, -1}, zone_end - zone_start, zone_start, 0, GROUP_LINEAR,
+                         zone_end > zone_start ? lum_layout_linear(0, i * 50, 20) : lum_layout_explicit(),
+                         NULL, NULL};
+        int id = add_node(pipeline, &zone);
+        if (id < 0) {
+            pipeline->count = first >= 0 ? (size_t)first : pipeline->count; // All zones or none
+            return -1;
+        }
+        if (i == 0) {
+            first = id;
+        }
+    }
+    return first;
+}
+
+size_t lum_pipeline_count(const LumPipeline* pipeline, int node) {
+    const PipeNode* source = node_at(pipeline, node);
+    return source ? source->count : 0;
+}
+
+/**
+ * LUMs [start, start + count) of group as stored, any backend
+ */
+static int read_lums(const LUMGroup* group, size_t start, size_t count, LUM* out) {
+    int status = 0;
+    switch (group->storage) {
+        case LUM_STORAGE_PACKED:
+            return packed_expand_range(group, start, count, out);
+        case LUM_STORAGE_COMPACT:
+            for (size_t i = 0; i < count && status == 0; i++) {
+                status = compact_get_lum(group, start + i, &out[i]);
+            }
+            return status;
+        case LUM_STORAGE_SOA:
+            for (size_t i = 0; i < count && status == 0; i++) {
+                status = soa_get_lum(group, start + i, &out[i]);
+            }
+            return status;
+        case LUM_STORAGE_HYBRID:
+            return hybrid_expand_range(group, start, count, out);
+        default:
+            if (count > 0 && !group->lums) {
+                return -1;
+            }
+            if (count > 0) {
+                memcpy(out, group->lums + start, sizeof(LUM) * count);
+            }
+            return 0;
+    }
+}
+
+/**
+ * LUMs [start, start + count) of node into out. type is the retype of the
+ * closest consumer that has one: it overrides whatever the node would set.
+ */
+static int emit_lums(const LumPipeline* pipeline, int id, size_t start, size_t count, int type, LUM* out) {
+    const PipeNode* node = &pipeline->nodes[id];
+
+    if (node->value) {
+        if (read_lums(node->value, start, count, out) != 0) {
+            return -1;
+        }
+    } else {
+        switch (node->kind) {
+            case PIPE_FUSION: {
+                size_t count1 = pipeline->nodes[node->inputs[0]].count;
+                size_t n1 = start < count1 ? (start + count < count1 ? count : count1 - start) : 0;
+                if (n1 > 0 && emit_lums(pipeline, node->inputs[0], start, n1, type, out) != 0) {
+                    return -1;
+                }
+                if (count > n1 &&
+                    emit_lums(pipeline, node->inputs[1], start + n1 - count1, count - n1,
+                              type != KEEP_TYPE ? type : LUM_GROUP, out + n1) != 0) {
+                    return -1;
+                }
+                return 0;
+            }
+            case PIPE_CYCLE:
+                if (node->layout.kind == LUM_LAYOUT_EXPLICIT) {
+                    // count % modulo was 0: one default LUM
+                    out[0].presence = 1;
+                    out[0].structure_type = (LumStructureType)(type != KEEP_TYPE ? type : LUM_CYCLE);
+                    out[0].spatial_data = NULL;
+                    out[0].position.x = 0;
+                    out[0].position.y = 0;
+                    return 0;
+                }
+                return emit_lums(pipeline, node->inputs[0], start, count,
+                                 type != KEEP_TYPE ? type : LUM_CYCLE, out);
+            case PIPE_FLOW:
+                return emit_lums(pipeline, node->inputs[0], start, count,
+                                 type != KEEP_TYPE ? type : LUM_LINEAR, out);
+            case PIPE_SPLIT:
+                return emit_lums(pipeline, node->inputs[0], node->start + start, count,
+                                 type != KEEP_TYPE ? type : LUM_LINEAR, out);
+            default:
+                return -1;
+        }
+    }
+
+    if (type != KEEP_TYPE) {
+        for (size_t i = 0; i < count; i++) {
+            out[i].structure_type = (LumStructureType)type;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Positions of LUMs [start, start + count) of node, shifted by (dx, dy)
+ */
+static int emit_positions(const LumPipeline* pipeline, int id, size_t start, size_t count,
+                          int dx, int dy, LUM* out) {
+    const PipeNode* node = &pipeline->nodes[id];
+
+    if (node->value) {
+        return lum_group_fill_positions_range(node->value, start, count, dx, dy, out);
+    }
+    if (node->layout.kind != LUM_LAYOUT_EXPLICIT) {
+        LumLayout layout = node->layout;
+        layout.offset_x += dx;
+        layout.offset_y += dy;
+        lum_layout_fill(&layout, start, count, out);
+        return 0;
+    }
+
+    switch (node->kind) {
+        case PIPE_FUSION: {
+            size_t count1 = pipeline->nodes[node->inputs[0]].count;
+            size_t n1 = start < count1 ? (start + count < count1 ? count : count1 - start) : 0;
+            if (n1 > 0 && emit_positions(pipeline, node->inputs[0], start, n1, dx, dy, out) != 0) {
+                return -1;
+            }
+            if (count > n1 &&
+                emit_positions(pipeline, node->inputs[1], start + n1 - count1, count - n1,
+                               dx + node->shift_x, dy, out + n1) != 0) {
+                return -1;
+            }
+            return 0;
+        }
+        case PIPE_FLOW:
+            return emit_positions(pipeline, node->inputs[0], start, count, dx + FLOW_SHIFT_X, dy, out);
+        case PIPE_CYCLE:
+            if (count > 0) {
+                out[0].position.x = dx;
+                out[0].position.y = dy;
+            }
+            return 0;
+        default:
+            return count == 0 ? 0 : -1; // Empty split zones only
+    }
+}
+
+typedef struct {
+    const LumPipeline* pipeline;
+    int node;
+    LUM* out;
+    size_t count;
+    size_t tasks;
+    int explicit_positions;
+    int failed;
+} PipelineRun;
+
+static void pipeline_run_chunk(void* context, size_t task) {
+    PipelineRun* job = (PipelineRun*)context;
+    size_t start, end;
+    lum_parallel_chunk(job->count, job->tasks, task, &start, &end);
+
+    if (emit_lums(job->pipeline, job->node, start, end - start, KEEP_TYPE, job->out + start) != 0 ||
+        (job->explicit_positions &&
+         emit_positions(job->pipeline, job->node, start, end - start, 0, 0, job->out + start) != 0)) {
+        __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * Flow results carry their target zone in spatial_data, as lum_flow
+ */
+static void attach_target_zone(const PipeNode* node, LUMGroup* result) {
+    if (node->kind != PIPE_FLOW) {
+        return;
+    }
+    char* target = (char*)lum_group_field_alloc(result, strlen(node->target_zone) + 1);
+    if (target) {
+        strcpy(target, node->target_zone);
+        result->spatial_data = target;
+    } else {
+        LOG_ERROR("Memory allocation failed for spatial_data in lum_pipeline_read");
+    }
+}
+
+/**
+ * Copy of group sharing no storage with it (group itself is not shared either)
+ */
+static LUMGroup* private_copy(const LUMGroup* group) {
+    switch (group->storage) {
+        case LUM_STORAGE_PACKED: return packed_clone(group);
+        case LUM_STORAGE_COMPACT: return compact_clone(group);
+        case LUM_STORAGE_SOA: return soa_clone(group);
+        case LUM_STORAGE_HYBRID: return hybrid_clone(group);
+        default: break;
+    }
+    if (!group->lums && group->count > 0) {
+        return NULL;
+    }
+    LUMGroup* copy = lum_group_copy(group->lums, group->count, group->group_type);
+    if (copy) {
+        copy->layout = group->layout;
+    }
+    return copy;
+}
+
+LUMGroup* lum_pipeline_read(LumPipeline* pipeline, int id) {
+    const PipeNode* node = node_at(pipeline, id);
+    if (!node) {
+        LOG_ERROR("Invalid input for lum_pipeline_read");
+        return NULL;
+    }
+    // Results never share storage with the inputs or the cache, callers write them freely
+    if (node->kind == PIPE_INPUT) {
+        return private_copy(node->value);
+    }
+    if (node->value) {
+        LUMGroup* result = private_copy(node->value);
+        if (result) {
+            attach_target_zone(node, result);
+        }
+        return result;
+    }
+
+    LUMGroup* result = lum_group_alloc(node->count, node->group_type);
+    if (!result) {
+        LOG_ERROR("Memory allocation failed for %zu LUMs in lum_pipeline_read", node->count);
+        return NULL;
+    }
+
+    // Output ranges are independent, each one pulls its LUMs straight from the inputs
+    int explicit_positions = node->layout.kind == LUM_LAYOUT_EXPLICIT;
+    PipelineRun job = {pipeline, id, result->lums, node->count,
+                       lum_parallel_threads(node->count), explicit_positions, 0};
+    if (node->count > 0) {
+        lum_parallel_run(job.tasks, pipeline_run_chunk, &job);
+    }
+    if (job.failed) {
+        LOG_ERROR("Failed to read LUMs of pipeline node %d", id);
+        free_lum_group(result);
+        return NULL;
+    }
+    // Explicit results store absolute positions
+    result->layout = explicit_positions ? lum_layout_explicit() : node->layout;
+
+    // Private copy kept for the nodes built on this one (no cache if it fails)
+    pipeline->nodes[id].value = private_copy(result);
+    attach_target_zone(node, result);
+    return result;
+}
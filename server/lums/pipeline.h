@@ -0,0 +1,32 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "lums.h"
+
+// Lazy VORAX pipelines: operations are recorded as nodes and nothing runs
+// until a node is read. A read is one pass over the input LUMs it needs
+// (cycle after fusion only touches the first count % modulo of them), no
+// intermediate group is built.
+typedef struct LumPipeline LumPipeline;
+
+LumPipeline* lum_pipeline_create(void);
+// Frees the nodes and cached reads, never the input groups
+void lum_pipeline_free(LumPipeline* pipeline);
+
+// Node ids, -1 on invalid arguments (same checks as the eager operations).
+// Input groups are borrowed and must not change while the pipeline is used.
+int lum_pipeline_input(LumPipeline* pipeline, LUMGroup* group);
+int lum_pipeline_fusion(LumPipeline* pipeline, int node1, int node2);
+int lum_pipeline_cycle(LumPipeline* pipeline, int node, int modulo);
+int lum_pipeline_flow(LumPipeline* pipeline, int node, const char* target_zone);
+// Records the zones of lum_split as consecutive nodes, returns the first one
+int lum_pipeline_split(LumPipeline* pipeline, int node, int zones);
+
+// LUMs a node yields, known without running anything (0 for invalid ids)
+size_t lum_pipeline_count(const LumPipeline* pipeline, int node);
+// Runs node: same LUMs, types and positions as the eager operations, in a
+// group owned by the caller that shares no storage with the pipeline. Read
+// nodes keep a private copy and later reads of nodes built on them start there.
+LUMGroup* lum_pipeline_read(LumPipeline* pipeline, int node);
+
+#endif // PIPELINE_H
@@ -0,0 +1,182 @@
+#define _POSIX_C_SOURCE 200112L
+#include "pool.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <stdio.h>
+
+#ifndef LOG_ERROR
+#define LOG_ERROR(...) fprintf(stderr, "ERROR: " __VA_ARGS__); fprintf(stderr, "\n")
+#endif
+
+// One job at a time: workers wake on a new generation, pull task indices
+// from next_task and report back through pending_workers
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pool_done = PTHREAD_COND_INITIALIZER;
+static struct {
+    pthread_t threads[LUM_POOL_MAX_THREADS];
+    size_t started;
+    int busy;
+    int stopping;
+    unsigned long generation;
+    void (*fn)(void*, size_t);
+    void* context;
+    size_t task_count;
+    size_t next_task;
+    size_t pending_workers;
+} pool;
+
+static size_t config_min_lums = LUM_PARALLEL_MIN_LUMS;
+static size_t config_threads = 0;
+
+void lum_parallel_configure(size_t min_lums, size_t thread_count) {
+    if (thread_count > LUM_POOL_MAX_THREADS) {
+        thread_count = LUM_POOL_MAX_THREADS;
+    }
+    __atomic_store_n(&config_min_lums, min_lums > 0 ? min_lums : LUM_PARALLEL_MIN_LUMS, __ATOMIC_RELAXED);
+    __atomic_store_n(&config_threads, thread_count, __ATOMIC_RELAXED);
+}
+
+static size_t configured_threads(void) {
+    size_t thread_count = __atomic_load_n(&config_threads, __ATOMIC_RELAXED);
+    if (thread_count == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = cpus > 1 ? (size_t)cpus : 1;
+    }
+    return thread_count < LUM_POOL_MAX_THREADS ? thread_count : LUM_POOL_MAX_THREADS;
+}
+
+size_t lum_parallel_threads(size_t count) {
+    if (count < __atomic_load_n(&config_min_lums, __ATOMIC_RELAXED)) {
+        return 1;
+    }
+    return configured_threads();
+}
+
+void lum_parallel_chunk(size_t count, size_t task_count, size_t task, size_t* start, size_t* end) {
+    size_t chunk = count / task_count;
+    size_t remainder = count % task_count;
+    // The first remainder chunks take one extra item
+    *start = task * chunk + (task < remainder ? task : remainder);
+    *end = *start + chunk + (task < remainder ? 1 : 0);
+}
+
+static void run_tasks(void (*fn)(void*, size_t), void* context, size_t task_count) {
+    size_t task;
+    while ((task = __atomic_fetch_add(&pool.next_task, 1, __ATOMIC_RELAXED)) < task_count) {
+        fn(context, task);
+    }
+}
+
+// arg: generation when the worker was started, any later one is its first job
+static void* pool_worker(void* arg) {
+    unsigned long seen = (unsigned long)(uintptr_t)arg;
+    pthread_mutex_lock(&pool_lock);
+
+    for (;;) {
+        while (!pool.stopping && pool.generation == seen) {
+            pthread_cond_wait(&pool_work, &pool_lock);
+        }
+        if (pool.stopping) {
+            break;
+        }
+        seen = pool.generation;
+        void (*fn)(void*, size_t) = pool.fn;
+        void* context = pool.context;
+        size_t task_count = pool.task_count;
+        pthread_mutex_unlock(&pool_lock);
+
+        run_tasks(fn, context, task_count);
+
+        pthread_mutex_lock(&pool_lock);
+        if (--pool.pending_workers == 0) {
+            pthread_cond_signal(&pool_done);
+        }
+    }
+
+    pthread_mutex_unlock(&pool_lock);
+    return NULL;
+}
+
+/**
+ * Grow the pool to workers threads, keeps what it could start (lock held)
+ */
+static void start_workers(size_t workers) {
+    while (pool.started < workers) {
+        if (pthread_create(&pool.threads[pool.started], NULL, pool_worker,
+                           (void*)(uintptr_t)pool.generation) != 0) {
+            LOG_ERROR("Failed to start LUM pool worker %zu", pool.started);
+            return;
+        }
+        pool.started++;
+    }
+}
+
+void lum_parallel_run(size_t task_count, void (*fn)(void* context, size_t task), void* context) {
+    if (task_count == 0 || !fn) {
+        return;
+    }
+
+    size_t workers = configured_threads() - 1;
+    if (workers > task_count - 1) {
+        workers = task_count - 1;
+    }
+
+    pthread_mutex_lock(&pool_lock);
+    if (workers > 0 && !pool.busy) {
+        start_workers(workers);
+    }
+    if (workers == 0 || pool.busy || pool.started == 0) {
+        pthread_mutex_unlock(&pool_lock);
+        for (size_t task = 0; task < task_count; task++) {
+            fn(context, task);
+        }
+        return;
+    }
+
+    pool.busy = 1;
+    pool.fn = fn;
+    pool.context = context;
+    pool.task_count = task_count;
+    pool.next_task = 0;
+    pool.pending_workers = pool.started;
+    pool.generation++;
+    pthread_cond_broadcast(&pool_work);
+    pthread_mutex_unlock(&pool_lock);
+
+    run_tasks(fn, context, task_count);
+
+    pthread_mutex_lock(&pool_lock);
+    while (pool.pending_workers > 0) {
+        pthread_cond_wait(&pool_done, &pool_lock);
+    }
+    pool.busy = 0;
+    pthread_mutex_unlock(&pool_lock);
+}
+
+void lum_parallel_shutdown(void) {
+    pthread_mutex_lock(&pool_lock);
+    while (pool.busy) {
+        // Let the job in flight finish first
+        pthread_mutex_unlock(&pool_lock);
+        sched_yield();
+        pthread_mutex_lock(&pool_lock);
+    }
+    pool.stopping = 1;
+    pthread_cond_broadcast(&pool_work);
+    size_t started = pool.started;
+    pool.busy = 1; // No new job while joining
+    pthread_mutex_unlock(&pool_lock);
+
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(pool.threads[i], NULL);
+    }
+
+    pthread_mutex_lock(&pool_lock);
+    pool.started = 0;
+    pool.stopping = 0;
+    pool.busy = 0;
+    pthread_mutex_unlock(&pool_lock);
+}
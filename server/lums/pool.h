@@ -0,0 +1,25 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+
+#define LUM_PARALLEL_MIN_LUMS (1 << 20)     // Default size below which kernels stay serial
+#define LUM_POOL_MAX_THREADS 16
+
+// Kernels split groups of at least min_lums LUMs across thread_count threads
+// (calling thread included). 0 keeps the default: LUM_PARALLEL_MIN_LUMS and
+// one thread per CPU. thread_count 1 disables the parallel mode.
+void lum_parallel_configure(size_t min_lums, size_t thread_count);
+// Threads worth using for count LUMs, 1 below the threshold
+size_t lum_parallel_threads(size_t count);
+
+// Calls fn(context, task) for every task in [0, task_count) on the pool
+// workers and the calling thread, returns once all have run. Runs them
+// serially when the pool is busy (nested or concurrent calls).
+void lum_parallel_run(size_t task_count, void (*fn)(void* context, size_t task), void* context);
+// [start, end) of task out of task_count equal chunks of count items
+void lum_parallel_chunk(size_t count, size_t task_count, size_t task, size_t* start, size_t* end);
+// Stops and joins the workers, the next parallel call starts them again
+void lum_parallel_shutdown(void);
+
+#endif // POOL_H
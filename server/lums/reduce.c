@@ -0,0 +1,356 @@
+#include "lums.h"
+#include "reduce.h"
+#include "pool.h"
+#include "layout.h"
+#include "hybrid.h"
+#include "simd_codec.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#ifndef LOG_ERROR
+#define LOG_ERROR(...) fprintf(stderr, "ERROR: " __VA_ARGS__); fprintf(stderr, "\n")
+#endif
+
+#define REDUCE_WORDS (LUM_REDUCE_CHUNK / 64)
+#define REDUCE_STACK_CHUNKS 16      // Partials stay on the stack up to 1M LUMs
+#define REDUCE_POSITION_BLOCK 256
+
+typedef struct {
+    size_t ones;
+    uint64_t hash;
+    size_t types[LUM_STRUCTURE_TYPES + 1];
+    LumBounds bounds;
+} ReducePartial;
+
+typedef struct ReduceJob ReduceJob;
+struct ReduceJob {
+    const LUMGroup* group;
+    const LUMGroup* other;      // Second operand of lum_group_hamming
+    void (*kernel)(const ReduceJob* job, size_t start, size_t count, ReducePartial* out);
+    size_t start;               // LUMs reduced: [start, start + count)
+    size_t count;
+    ReducePartial* partials;
+};
+
+static int has_storage(const LUMGroup* group) {
+    switch (group->storage) {
+        case LUM_STORAGE_PACKED: return group->packed != NULL;
+        case LUM_STORAGE_COMPACT: return group->compact != NULL;
+        case LUM_STORAGE_SOA: return group->soa != NULL;
+        case LUM_STORAGE_HYBRID: return group->hybrid != NULL;
+        default: return group->lums != NULL || group->count == 0;
+    }
+}
+
+static uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Presence bits of LUMs [start, start + count), bit k in words[k / 64].
+ * start is a word boundary, so packed words are used in place.
+ */
+static const uint64_t* chunk_words(const LUMGroup* group, size_t start, size_t count, uint64_t* buffer) {
+    size_t word_count = (count + 63) / 64;
+
+    switch (group->storage) {
+        case LUM_STORAGE_PACKED:
+            return group->packed->words + start / 64; // Bits past count are kept clear
+        case LUM_STORAGE_HYBRID:
+            hybrid_extract_words(group, start, count, buffer);
+            return buffer;
+        case LUM_STORAGE_SOA:
+            lum_presence_to_words(group->soa->presence + start, count, buffer);
+            return buffer;
+        case LUM_STORAGE_COMPACT: {
+            const LumCompact* records = group->compact->records + start;
+            memset(buffer, 0, sizeof(uint64_t) * word_count);
+            for (size_t i = 0; i < count; i++) {
+                buffer[i / 64] |= (uint64_t)records[i].presence << (i % 64);
+            }
+            return buffer;
+        }
+        default: {
+            const LUM* lums = group->lums + start;
+            memset(buffer, 0, sizeof(uint64_t) * word_count);
+            for (size_t i = 0; i < count; i++) {
+                buffer[i / 64] |= (uint64_t)(lums[i].presence != 0) << (i % 64);
+            }
+            return buffer;
+        }
+    }
+}
+
+static void popcount_kernel(const ReduceJob* job, size_t start, size_t count, ReducePartial* out) {
+    uint64_t buffer[REDUCE_WORDS];
+    out->ones = lum_words_popcount(chunk_words(job->group, start, count, buffer), (count + 63) / 64);
+}
+
+static void hamming_kernel(const ReduceJob* job, size_t start, size_t count, ReducePartial* out) {
+    uint64_t buffer1[REDUCE_WORDS];
+    uint64_t buffer2[REDUCE_WORDS];
+    const uint64_t* words1 = chunk_words(job->group, start, count, buffer1);
+    const uint64_t* words2 = chunk_words(job->other, start, count, buffer2);
+    out->ones = lum_words_hamming(words1, words2, (count + 63) / 64);
+}
+
+/**
+ * Hash term of presence word index holding bits
+ */
+static uint64_t word_term(size_t index, uint64_t bits) {
+    return mix64(bits ^ mix64((uint64_t)index + 0x9E3779B97F4A7C15ULL));
+}
+
+static void hash_kernel(const ReduceJob* job, size_t start, size_t count, ReducePartial* out) {
+    uint64_t buffer[REDUCE_WORDS];
+    const uint64_t* words = chunk_words(job->group, start, count, buffer);
+    uint64_t hash = 0;
+    for (size_t w = 0; w < (count + 63) / 64; w++) {
+        hash += word_term(start / 64 + w, words[w]);
+    }
+    out->hash = hash;
+}
+
+static void types_kernel(const ReduceJob* job, size_t start, size_t count, ReducePartial* out) {
+    const LUMGroup* group = job->group;
+    size_t* types = out->types;
+
+    if (group->storage == LUM_STORAGE_SOA) {
+        size_t counts[8];
+        size_t known = 0;
+        lum_bytes_histogram8(group->soa->structure_type + start, count, counts);
+        for (int type = 0; type < LUM_STRUCTURE_TYPES; type++) {
+            types[type] = counts[type];
+            known += counts[type];
+        }
+        types[LUM_STRUCTURE_TYPES] = count - known;
+    } else if (group->storage == LUM_STORAGE_COMPACT) {
+        const LumCompact* records = group->compact->records + start;
+        for (size_t i = 0; i < count; i++) {
+            unsigned type = records[i].structure_type;
+            types[type < LUM_STRUCTURE_TYPES ? type : LUM_STRUCTURE_TYPES]++;
+        }
+    } else {
+        const LUM* lums = group->lums + start;
+        for (size_t i = 0; i < count; i++) {
+            unsigned type = (unsigned)lums[i].structure_type;
+            types[type < LUM_STRUCTURE_TYPES ? type : LUM_STRUCTURE_TYPES]++;
+        }
+    }
+}
+
+static void bounds_kernel(const ReduceJob* job, size_t start, size_t count, ReducePartial* out) {
+    LUM block[REDUCE_POSITION_BLOCK];
+    LumBounds bounds = {INT_MAX, INT_MAX, INT_MIN, INT_MIN};
+
+    for (size_t base = 0; base < count; base += REDUCE_POSITION_BLOCK) {
+        size_t n = count - base < REDUCE_POSITION_BLOCK ? count - base : REDUCE_POSITION_BLOCK;
+        lum_group_fill_positions_range(job->group, start + base, n, 0, 0, block);
+        for (size_t k = 0; k < n; k++) {
+            int x = block[k].position.x;
+            int y = block[k].position.y;
+            bounds.min_x = x < bounds.min_x ? x : bounds.min_x;
+            bounds.min_y = y < bounds.min_y ? y : bounds.min_y;
+            bounds.max_x = x > bounds.max_x ? x : bounds.max_x;
+            bounds.max_y = y > bounds.max_y ? y : bounds.max_y;
+        }
+    }
+    out->bounds = bounds;
+}
+
+static void reduce_task(void* context, size_t chunk) {
+    const ReduceJob* job = (const ReduceJob*)context;
+    size_t start = job->start + chunk * LUM_REDUCE_CHUNK;
+    size_t remaining = job->start + job->count - start;
+    ReducePartial* out = &job->partials[chunk];
+
+    memset(out, 0, sizeof(*out));
+    job->kernel(job, start, remaining < LUM_REDUCE_CHUNK ? remaining : LUM_REDUCE_CHUNK, out);
+}
+
+/**
+ * One partial per chunk in job->partials (stack when it fits), chunk count
+ * returned; job->partials is NULL if they could not be allocated
+ */
+static size_t reduce_run(ReduceJob* job, ReducePartial* stack) {
+    size_t count = job->count;
+    size_t chunk_count = (count + LUM_REDUCE_CHUNK - 1) / LUM_REDUCE_CHUNK;
+
+    job->partials = chunk_count <= REDUCE_STACK_CHUNKS
+                        ? stack
+                        : (ReducePartial*)malloc(sizeof(ReducePartial) * chunk_count);
+    if (!job->partials) {
+        LOG_ERROR("Memory allocation failed for %zu reduction chunks", chunk_count);
+        return 0;
+    }
+
+    if (lum_parallel_threads(count) > 1) {
+        lum_parallel_run(chunk_count, reduce_task, job);
+    } else {
+        for (size_t chunk = 0; chunk < chunk_count; chunk++) {
+            reduce_task(job, chunk);
+        }
+    }
+    return chunk_count;
+}
+
+static void reduce_done(ReduceJob* job, ReducePartial* stack) {
+    if (job->partials != stack) {
+        free(job->partials);
+    }
+}
+
+size_t lum_group_popcount(const LUMGroup* group) {
+    if (!group || !has_storage(group)) {
+        return 0;
+    }
+    if (group->storage == LUM_STORAGE_HYBRID) {
+        return hybrid_popcount(group); // Container cardinalities, no scan
+    }
+
+    ReducePartial stack[REDUCE_STACK_CHUNKS];
+    ReduceJob job = {group, NULL, popcount_kernel, 0, group->count, NULL};
+    size_t chunk_count = reduce_run(&job, stack);
+    size_t ones = 0;
+    for (size_t chunk = 0; job.partials && chunk < chunk_count; chunk++) {
+        ones += job.partials[chunk].ones;
+    }
+    reduce_done(&job, stack);
+    return ones;
+}
+
+int lum_group_type_histogram(const LUMGroup* group, size_t counts[LUM_STRUCTURE_TYPES + 1]) {
+    if (!group || !counts || !has_storage(group)) {
+        return -1;
+    }
+    memset(counts, 0, sizeof(size_t) * (LUM_STRUCTURE_TYPES + 1));
+
+    if (group->storage == LUM_STORAGE_PACKED || group->storage == LUM_STORAGE_HYBRID) {
+        // Types are stored as runs, a handful per group
+        const LumTypeRun* runs = group->storage == LUM_STORAGE_PACKED ? group->packed->type_runs
+                                                                       : group->hybrid->type_runs;
+        size_t run_count = group->storage == LUM_STORAGE_PACKED ? group->packed->type_run_count
+                                                                 : group->hybrid->type_run_count;
+        if (run_count == 0) {
+            counts[LUM_LINEAR] = group->count;
+            return 0;
+        }
+        for (size_t r = 0; r < run_count; r++) {
+            size_t end = r + 1 < run_count ? runs[r + 1].start : group->count;
+            unsigned type = (unsigned)runs[r].structure_type;
+            counts[type < LUM_STRUCTURE_TYPES ? type : LUM_STRUCTURE_TYPES] += end - runs[r].start;
+        }
+        return 0;
+    }
+
+    ReducePartial stack[REDUCE_STACK_CHUNKS];
+    ReduceJob job = {group, NULL, types_kernel, 0, group->count, NULL};
+    size_t chunk_count = reduce_run(&job, stack);
+    if (!job.partials) {
+        return -1;
+    }
+    for (size_t chunk = 0; chunk < chunk_count; chunk++) {
+        for (int type = 0; type <= LUM_STRUCTURE_TYPES; type++) {
+            counts[type] += job.partials[chunk].types[type];
+        }
+    }
+    reduce_done(&job, stack);
+    return 0;
+}
+
+int lum_group_bounds(const LUMGroup* group, LumBounds* bounds) {
+    if (!group || !bounds || group->count == 0 || !has_storage(group)) {
+        return -1;
+    }
+
+    ReducePartial stack[REDUCE_STACK_CHUNKS];
+    ReduceJob job = {group, NULL, bounds_kernel, 0, group->count, NULL};
+    size_t chunk_count = reduce_run(&job, stack);
+    if (!job.partials) {
+        return -1;
+    }
+    *bounds = job.partials[0].bounds;
+    for (size_t chunk = 1; chunk < chunk_count; chunk++) {
+        const LumBounds* part = &job.partials[chunk].bounds;
+        bounds->min_x = part->min_x < bounds->min_x ? part->min_x : bounds->min_x;
+        bounds->min_y = part->min_y < bounds->min_y ? part->min_y : bounds->min_y;
+        bounds->max_x = part->max_x > bounds->max_x ? part->max_x : bounds->max_x;
+        bounds->max_y = part->max_y > bounds->max_y ? part->max_y : bounds->max_y;
+    }
+    reduce_done(&job, stack);
+    return 0;
+}
+
+size_t lum_group_hamming(const LUMGroup* group1, const LUMGroup* group2) {
+    if (!group1 || !group2 || group1->count != group2->count ||
+        !has_storage(group1) || !has_storage(group2)) {
+        return SIZE_MAX;
+    }
+
+    ReducePartial stack[REDUCE_STACK_CHUNKS];
+    ReduceJob job = {group1, group2, hamming_kernel, 0, group1->count, NULL};
+    size_t chunk_count = reduce_run(&job, stack);
+    if (!job.partials) {
+        return SIZE_MAX;
+    }
+    size_t distance = 0;
+    for (size_t chunk = 0; chunk < chunk_count; chunk++) {
+        distance += job.partials[chunk].ones;
+    }
+    reduce_done(&job, stack);
+    return distance;
+}
+
+uint64_t lum_group_hash_words(const LUMGroup* group, size_t first_word, size_t end_word) {
+    if (!group || !has_storage(group) || first_word >= end_word || first_word >= (group->count + 63) / 64) {
+        return 0;
+    }
+    size_t start = first_word * 64;
+    size_t end = end_word < (group->count + 63) / 64 ? end_word * 64 : group->count;
+
+    // Terms are summed, so chunks combine in any order
+    ReducePartial stack[REDUCE_STACK_CHUNKS];
+    ReduceJob job = {group, NULL, hash_kernel, start, end - start, NULL};
+    size_t chunk_count = reduce_run(&job, stack);
+    uint64_t sum = 0;
+    for (size_t chunk = 0; job.partials && chunk < chunk_count; chunk++) {
+        sum += job.partials[chunk].hash;
+    }
+    reduce_done(&job, stack);
+    return sum;
+}
+
+/**
+ * Hash of a group from its word terms, bound to the LUM count
+ */
+static uint64_t hash_finish(uint64_t sum, size_t count) {
+    return mix64(sum + mix64((uint64_t)count ^ 0xD6E8FEB86659FD93ULL));
+}
+
+uint64_t lum_group_hash(const LUMGroup* group) {
+    if (!group || !has_storage(group)) {
+        return 0;
+    }
+    return hash_finish(lum_group_hash_words(group, 0, SIZE_MAX), group->count);
+}
+
+uint64_t lum_group_content_hash(LUMGroup* group) {
+    if (!group || !has_storage(group)) {
+        return 0;
+    }
+    if (!group->hash_cached) {
+        group->hash_sum = lum_group_hash_words(group, 0, SIZE_MAX);
+        group->hash_cached = 1;
+    }
+    return hash_finish(group->hash_sum, group->count);
+}
+
+void lum_group_touch(LUMGroup* group) {
+    if (group) {
+        group->hash_cached = 0;
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef REDUCE_H
+#define REDUCE_H
+
+#include "lums.h"
+
+// Reductions over whole groups, any storage. Groups are cut into fixed
+// chunks of LUM_REDUCE_CHUNK LUMs reduced on the pool, and the partial
+// results are combined in chunk order: same value whatever the thread count.
+#define LUM_REDUCE_CHUNK (1 << 16)
+
+typedef struct {
+    int min_x, min_y;
+    int max_x, max_y;
+} LumBounds;
+
+// Present LUMs
+size_t lum_group_popcount(const LUMGroup* group);
+// counts[t] = LUMs of structure type t, counts[LUM_STRUCTURE_TYPES] = unexpected values.
+// 0, or -1 if the group has no storage.
+int lum_group_type_histogram(const LUMGroup* group, size_t counts[LUM_STRUCTURE_TYPES + 1]);
+// Smallest box around every position, -1 if the group is empty
+int lum_group_bounds(const LUMGroup* group, LumBounds* bounds);
+// LUMs whose presence differs, SIZE_MAX if the counts differ
+size_t lum_group_hamming(const LUMGroup* group1, const LUMGroup* group2);
+// 64-bit hash of the presence bits, identical across storages. Built from one
+// term per 64-LUM word, summed, so an edit only rehashes the words it touches.
+uint64_t lum_group_hash(const LUMGroup* group);
+// Sum of the terms of words [first_word, end_word) (LUMs from first_word * 64)
+uint64_t lum_group_hash_words(const LUMGroup* group, size_t first_word, size_t end_word);
+
+// lum_group_hash kept in the group: computed on first use, carried by clones
+// and storage changes, updated by the in-place operations, dropped by
+// lum_group_writable / lum_group_detach. Code writing presence through any
+// other pointer (packed words...) calls lum_group_touch afterwards.
+uint64_t lum_group_content_hash(LUMGroup* group);
+void lum_group_touch(LUMGroup* group);
+
+#endif // REDUCE_H
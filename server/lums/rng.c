@@ -0,0 +1,223 @@
+#define _POSIX_C_SOURCE 200112L
+#include "rng.h"
+#include "simd_codec.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/random.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LUM_RNG_X86 1
+#endif
+
+#define RNG_LANES 4
+
+static __thread LumRng thread_rng;
+static __thread int thread_rng_seeded;
+
+static uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t splitmix64(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+int lum_rng_entropy(void* buffer, size_t size) {
+    unsigned char* out = (unsigned char*)buffer;
+    size_t filled = 0;
+
+    while (filled < size) {
+        ssize_t n = getrandom(out + filled, size - filled, 0);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        filled += (size_t)n;
+    }
+    if (filled == size) {
+        return 0;
+    }
+
+    // Kernels without getrandom
+    FILE* urandom = fopen("/dev/urandom", "rb");
+    if (!urandom) {
+        return -1;
+    }
+    size_t got = fread(out + filled, 1, size - filled, urandom);
+    fclose(urandom);
+    return got == size - filled ? 0 : -1;
+}
+
+void lum_rng_init(LumRng* rng, uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+        rng->s[i] = splitmix64(&seed);
+    }
+}
+
+void lum_rng_init_entropy(LumRng* rng) {
+    uint64_t seed;
+    if (lum_rng_entropy(&seed, sizeof(seed)) != 0) {
+        // No entropy source: clock and stack address still differ per thread
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        seed = ((uint64_t)ts.tv_sec << 32) ^ (uint64_t)ts.tv_nsec ^ (uint64_t)(uintptr_t)&seed;
+    }
+    lum_rng_init(rng, seed);
+}
+
+uint64_t lum_rng_next(LumRng* rng) {
+    uint64_t* s = rng->s;
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+}
+
+uint64_t lum_rng_below(LumRng* rng, uint64_t bound) {
+    if (bound == 0) {
+        return 0;
+    }
+    // Reject the low values that would bias the modulo
+    uint64_t threshold = (0 - bound) % bound;
+    uint64_t value;
+    do {
+        value = lum_rng_next(rng);
+    } while (value < threshold);
+    return value % bound;
+}
+
+double lum_rng_double(LumRng* rng) {
+    return (double)(lum_rng_next(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * steps rounds of four lanes, lanes[word][lane], output lane-interleaved
+ */
+static void fill_lanes_scalar(uint64_t lanes[4][RNG_LANES], uint64_t* out, size_t steps) {
+    for (size_t k = 0; k < steps; k++) {
+        for (int lane = 0; lane < RNG_LANES; lane++) {
+            LumRng rng;
+            for (int w = 0; w < 4; w++) {
+                rng.s[w] = lanes[w][lane];
+            }
+            out[k * RNG_LANES + lane] = lum_rng_next(&rng);
+            for (int w = 0; w < 4; w++) {
+                lanes[w][lane] = rng.s[w];
+            }
+        }
+    }
+}
+
+#ifdef LUM_RNG_X86
+// AVX2 has no 64-bit multiply: * 5 and * 9 are shift-adds
+__attribute__((target("avx2")))
+static void fill_lanes_avx2(uint64_t lanes[4][RNG_LANES], uint64_t* out, size_t steps) {
+    __m256i s0 = _mm256_loadu_si256((const __m256i*)lanes[0]);
+    __m256i s1 = _mm256_loadu_si256((const __m256i*)lanes[1]);
+    __m256i s2 = _mm256_loadu_si256((const __m256i*)lanes[2]);
+    __m256i s3 = _mm256_loadu_si256((const __m256i*)lanes[3]);
+
+    for (size_t k = 0; k < steps; k++) {
+        __m256i x5 = _mm256_add_epi64(_mm256_slli_epi64(s1, 2), s1);
+        __m256i r = _mm256_or_si256(_mm256_slli_epi64(x5, 7), _mm256_srli_epi64(x5, 57));
+        __m256i result = _mm256_add_epi64(_mm256_slli_epi64(r, 3), r);
+        _mm256_storeu_si256((__m256i*)(out + k * RNG_LANES), result);
+
+        __m256i t = _mm256_slli_epi64(s1, 17);
+        s2 = _mm256_xor_si256(s2, s0);
+        s3 = _mm256_xor_si256(s3, s1);
+        s1 = _mm256_xor_si256(s1, s2);
+        s0 = _mm256_xor_si256(s0, s3);
+        s2 = _mm256_xor_si256(s2, t);
+        s3 = _mm256_or_si256(_mm256_slli_epi64(s3, 45), _mm256_srli_epi64(s3, 19));
+    }
+
+    _mm256_storeu_si256((__m256i*)lanes[0], s0);
+    _mm256_storeu_si256((__m256i*)lanes[1], s1);
+    _mm256_storeu_si256((__m256i*)lanes[2], s2);
+    _mm256_storeu_si256((__m256i*)lanes[3], s3);
+}
+#endif
+
+static void fill_lanes(uint64_t lanes[4][RNG_LANES], uint64_t* out, size_t steps) {
+#ifdef LUM_RNG_X86
+    if (lum_codec_level() >= LUM_CODEC_AVX2) {
+        fill_lanes_avx2(lanes, out, steps);
+        return;
+    }
+#endif
+    fill_lanes_scalar(lanes, out, steps);
+}
+
+void lum_rng_fill(LumRng* rng, void* out, size_t size) {
+    unsigned char* bytes = (unsigned char*)out;
+    const size_t step_bytes = sizeof(uint64_t) * RNG_LANES;
+
+    if (size < step_bytes) {
+        while (size > 0) {
+            uint64_t value = lum_rng_next(rng);
+            size_t n = size < sizeof(value) ? size : sizeof(value);
+            memcpy(bytes, &value, n);
+            bytes += n;
+            size -= n;
+        }
+        return;
+    }
+
+    // Each lane is its own stream, seeded from the parent
+    uint64_t lanes[4][RNG_LANES];
+    for (int lane = 0; lane < RNG_LANES; lane++) {
+        LumRng seeded;
+        lum_rng_init(&seeded, lum_rng_next(rng));
+        for (int w = 0; w < 4; w++) {
+            lanes[w][lane] = seeded.s[w];
+        }
+    }
+
+    // Whole steps through a stack block, the tail through one more step
+    uint64_t block[256];
+    while (size >= step_bytes) {
+        size_t steps = size / step_bytes;
+        if (steps > sizeof(block) / step_bytes) {
+            steps = sizeof(block) / step_bytes;
+        }
+        fill_lanes(lanes, block, steps);
+        memcpy(bytes, block, steps * step_bytes);
+        bytes += steps * step_bytes;
+        size -= steps * step_bytes;
+    }
+    if (size > 0) {
+        fill_lanes(lanes, block, 1);
+        memcpy(bytes, block, size);
+    }
+}
+
+LumRng* lum_rng_thread(void) {
+    if (!thread_rng_seeded) {
+        lum_rng_init_entropy(&thread_rng);
+        thread_rng_seeded = 1;
+    }
+    return &thread_rng;
+}
+
+uint64_t lum_random_u64(void) {
+    return lum_rng_next(lum_rng_thread());
+}
+
+uint64_t lum_random_below(uint64_t bound) {
+    return lum_rng_below(lum_rng_thread(), bound);
+}
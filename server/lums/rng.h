@@ -0,0 +1,32 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// xoshiro256** stream, not for secrets (use lum_rng_entropy for those)
+typedef struct {
+    uint64_t s[4];
+} LumRng;
+
+// Fills buffer from getrandom (/dev/urandom if unavailable), 0 or -1
+int lum_rng_entropy(void* buffer, size_t size);
+
+// Same seed, same stream (state expanded with splitmix64)
+void lum_rng_init(LumRng* rng, uint64_t seed);
+void lum_rng_init_entropy(LumRng* rng);
+uint64_t lum_rng_next(LumRng* rng);
+// Uniform in [0, bound), 0 if bound is 0
+uint64_t lum_rng_below(LumRng* rng, uint64_t bound);
+// Uniform in [0, 1)
+double lum_rng_double(LumRng* rng);
+// Bulk fill through four interleaved lanes (AVX2 when available),
+// identical bytes whatever the instruction set
+void lum_rng_fill(LumRng* rng, void* out, size_t size);
+
+// Calling thread's stream, seeded once from lum_rng_entropy, no locking
+LumRng* lum_rng_thread(void);
+uint64_t lum_random_u64(void);
+uint64_t lum_random_below(uint64_t bound);
+
+#endif // RNG_H
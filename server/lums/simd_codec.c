@@ -0,0 +1,804 @@
+#define _POSIX_C_SOURCE 200112L
+#include "lums.h"
+#include "simd_codec.h"
+#include <pthread.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LUM_CODEC_X86 1
+#endif
+
+// Words are stored little-endian in bytes (bit i of byte k = LUM 8k + i)
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define LUM_LITTLE_ENDIAN 0
+#define LUM_LE64(word) __builtin_bswap64(word)
+#else
+#define LUM_LITTLE_ENDIAN 1
+#define LUM_LE64(word) (word)
+#endif
+
+// Détection runtime des capacités SIMD, une fois par processus.
+// codec_level (-1 = pas encore choisi) est lu par les threads du pool : accès atomiques.
+static pthread_once_t cpu_once = PTHREAD_ONCE_INIT;
+static int cpu_level = LUM_CODEC_SCALAR;
+static int codec_level = -1;
+
+static void detect_cpu_level(void) {
+#ifdef LUM_CODEC_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        cpu_level = LUM_CODEC_AVX2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        cpu_level = LUM_CODEC_SSE2;
+    }
+#endif
+}
+
+static LumCodecLevel cpu_codec_level(void) {
+    pthread_once(&cpu_once, detect_cpu_level);
+    return (LumCodecLevel)cpu_level;
+}
+
+LumCodecLevel lum_codec_level(void) {
+    int level = __atomic_load_n(&codec_level, __ATOMIC_ACQUIRE);
+    if (level < 0) {
+        // First call: publish the CPU's level unless force_level got there first
+        int expected = -1;
+        level = cpu_codec_level();
+        if (!__atomic_compare_exchange_n(&codec_level, &expected, level, 0,
+                                         __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            level = expected;
+        }
+    }
+    return (LumCodecLevel)level;
+}
+
+/**
+ * Restrict the codecs to a lower instruction set (never above the CPU's)
+ */
+void lum_codec_force_level(LumCodecLevel level) {
+    LumCodecLevel detected = cpu_codec_level();
+    __atomic_store_n(&codec_level, (int)(level < detected ? level : detected), __ATOMIC_RELEASE);
+}
+
+/**
+ * Scalar pack of up to 64 characters, branch-free validation
+ */
+static int ascii_pack_scalar(const char* text, size_t len, uint64_t* word) {
+    uint64_t bits = 0;
+    unsigned invalid = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        unsigned digit = (unsigned char)(text[i] - '0');
+        invalid |= digit & ~1u;
+        bits |= (uint64_t)(digit & 1) << i;
+    }
+
+    *word = bits;
+    return invalid ? -1 : 0;
+}
+
+/**
+ * Scalar expansion: out[i] = base + bit i (base '0' for text, 0 for presence)
+ */
+static void bits_expand_scalar(uint64_t word, size_t len, char base, char* out) {
+    for (size_t i = 0; i < len; i++) {
+        out[i] = (char)(base + ((word >> i) & 1));
+    }
+}
+
+/**
+ * Scalar pack of up to 64 presence bytes (any non-zero byte counts as 1)
+ */
+static uint64_t presence_pack_scalar(const uint8_t* presence, size_t len) {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < len; i++) {
+        bits |= (uint64_t)(presence[i] != 0) << i;
+    }
+    return bits;
+}
+
+#ifdef LUM_CODEC_X86
+
+// Byte j selects bit (j % 8) of its source byte
+#define LUM_BIT_SELECT_BYTES \
+    1, 2, 4, 8, 16, 32, 64, (char)0x80, 1, 2, 4, 8, 16, 32, 64, (char)0x80
+
+/**
+ * SSE2: 4 x 16 characters, compare + movemask
+ */
+__attribute__((target("sse2")))
+static int ascii_pack64_sse2(const char* text, uint64_t* word) {
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i one = _mm_set1_epi8('1');
+    uint64_t bits = 0;
+
+    for (int k = 0; k < 4; k++) {
+        __m128i chars = _mm_loadu_si128((const __m128i*)(text + 16 * k));
+        __m128i is_one = _mm_cmpeq_epi8(chars, one);
+        __m128i valid = _mm_or_si128(is_one, _mm_cmpeq_epi8(chars, zero));
+        if (_mm_movemask_epi8(valid) != 0xFFFF) {
+            return -1;
+        }
+        bits |= (uint64_t)(unsigned)_mm_movemask_epi8(is_one) << (16 * k);
+    }
+
+    *word = bits;
+    return 0;
+}
+
+__attribute__((target("sse2")))
+static void bits_expand64_sse2(uint64_t word, char base, char* out) {
+    const __m128i select = _mm_setr_epi8(LUM_BIT_SELECT_BYTES);
+    const __m128i zero = _mm_set1_epi8(base);
+
+    for (int k = 0; k < 4; k++) {
+        // Spread 2 source bytes over 8 lanes each
+        __m128i bytes = _mm_cvtsi32_si128((int)((word >> (16 * k)) & 0xFFFF));
+        bytes = _mm_unpacklo_epi8(bytes, bytes);
+        bytes = _mm_unpacklo_epi16(bytes, bytes);
+        bytes = _mm_unpacklo_epi32(bytes, bytes);
+
+        __m128i set = _mm_cmpeq_epi8(_mm_and_si128(bytes, select), select);
+        _mm_storeu_si128((__m128i*)(out + 16 * k), _mm_sub_epi8(zero, set));
+    }
+}
+
+/**
+ * AVX2: 2 x 32 characters, compare + movemask
+ */
+__attribute__((target("avx2")))
+static int ascii_pack64_avx2(const char* text, uint64_t* word) {
+    const __m256i zero = _mm256_set1_epi8('0');
+    const __m256i one = _mm256_set1_epi8('1');
+
+    __m256i low = _mm256_loadu_si256((const __m256i*)text);
+    __m256i high = _mm256_loadu_si256((const __m256i*)(text + 32));
+    __m256i low_one = _mm256_cmpeq_epi8(low, one);
+    __m256i high_one = _mm256_cmpeq_epi8(high, one);
+    __m256i valid = _mm256_and_si256(
+        _mm256_or_si256(low_one, _mm256_cmpeq_epi8(low, zero)),
+        _mm256_or_si256(high_one, _mm256_cmpeq_epi8(high, zero)));
+
+    if ((unsigned)_mm256_movemask_epi8(valid) != 0xFFFFFFFFu) {
+        return -1;
+    }
+
+    *word = (uint64_t)(unsigned)_mm256_movemask_epi8(low_one) |
+            ((uint64_t)(unsigned)_mm256_movemask_epi8(high_one) << 32);
+    return 0;
+}
+
+__attribute__((target("sse2")))
+static uint64_t presence_pack64_sse2(const uint8_t* presence) {
+    const __m128i zero = _mm_setzero_si128();
+    uint64_t bits = 0;
+
+    for (int k = 0; k < 4; k++) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*)(presence + 16 * k));
+        unsigned absent = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, zero));
+        bits |= (uint64_t)(~absent & 0xFFFFu) << (16 * k);
+    }
+    return bits;
+}
+
+__attribute__((target("avx2")))
+static void bits_expand64_avx2(uint64_t word, char base, char* out) {
+    const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                            2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+    const __m256i select = _mm256_setr_epi8(LUM_BIT_SELECT_BYTES, LUM_BIT_SELECT_BYTES);
+    const __m256i zero = _mm256_set1_epi8(base);
+
+    for (int k = 0; k < 2; k++) {
+        __m256i bytes = _mm256_set1_epi32((int)(uint32_t)(word >> (32 * k)));
+        bytes = _mm256_shuffle_epi8(bytes, spread);
+
+        __m256i set = _mm256_cmpeq_epi8(_mm256_and_si256(bytes, select), select);
+        _mm256_storeu_si256((__m256i*)(out + 32 * k), _mm256_sub_epi8(zero, set));
+    }
+}
+
+__attribute__((target("avx2")))
+static uint64_t presence_pack64_avx2(const uint8_t* presence) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i low = _mm256_loadu_si256((const __m256i*)presence);
+    __m256i high = _mm256_loadu_si256((const __m256i*)(presence + 32));
+    uint32_t low_absent = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, zero));
+    uint32_t high_absent = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, zero));
+
+    return ~((uint64_t)low_absent | ((uint64_t)high_absent << 32));
+}
+
+#endif // LUM_CODEC_X86
+
+static void bits_expand64(LumCodecLevel level, uint64_t word, char base, char* out) {
+#ifdef LUM_CODEC_X86
+    if (level == LUM_CODEC_AVX2) {
+        bits_expand64_avx2(word, base, out);
+        return;
+    }
+    if (level == LUM_CODEC_SSE2) {
+        bits_expand64_sse2(word, base, out);
+        return;
+    }
+#endif
+    (void)level;
+    bits_expand_scalar(word, 64, base, out);
+}
+
+static uint64_t presence_pack64(LumCodecLevel level, const uint8_t* presence) {
+#ifdef LUM_CODEC_X86
+    if (level == LUM_CODEC_AVX2) {
+        return presence_pack64_avx2(presence);
+    }
+    if (level == LUM_CODEC_SSE2) {
+        return presence_pack64_sse2(presence);
+    }
+#endif
+    (void)level;
+    return presence_pack_scalar(presence, 64);
+}
+
+int lum_ascii_to_words(const char* text, size_t len, uint64_t* words) {
+    if (!text || (!words && len > 0)) {
+        return -1;
+    }
+
+    LumCodecLevel level = lum_codec_level();
+    size_t full_words = len / 64;
+
+    for (size_t w = 0; w < full_words; w++) {
+        const char* block = text + w * 64;
+        int rc;
+#ifdef LUM_CODEC_X86
+        if (level == LUM_CODEC_AVX2) {
+            rc = ascii_pack64_avx2(block, &words[w]);
+        } else if (level == LUM_CODEC_SSE2) {
+            rc = ascii_pack64_sse2(block, &words[w]);
+        } else
+#endif
+        {
+            rc = ascii_pack_scalar(block, 64, &words[w]);
+        }
+        if (rc != 0) {
+            return -1;
+        }
+    }
+    (void)level;
+
+    if (len % 64) {
+        return ascii_pack_scalar(text + full_words * 64, len % 64, &words[full_words]);
+    }
+    return 0;
+}
+
+void lum_words_to_ascii(const uint64_t* words, size_t bit_count, char* out) {
+    if (!words || !out) {
+        return;
+    }
+
+    LumCodecLevel level = lum_codec_level();
+    size_t full_words = bit_count / 64;
+
+    for (size_t w = 0; w < full_words; w++) {
+        bits_expand64(level, words[w], '0', out + w * 64);
+    }
+
+    if (bit_count % 64) {
+        bits_expand_scalar(words[full_words], bit_count % 64, '0', out + full_words * 64);
+    }
+}
+
+void lum_bytes_to_presence(const uint8_t* bytes, size_t bit_count, uint8_t* presence) {
+    if (!bytes || !presence) {
+        return;
+    }
+
+    LumCodecLevel level = lum_codec_level();
+    size_t full_words = bit_count / 64;
+
+    for (size_t w = 0; w < full_words; w++) {
+        uint64_t word;
+        memcpy(&word, bytes + w * 8, sizeof(word));
+        bits_expand64(level, LUM_LE64(word), 0, (char*)presence + w * 64);
+    }
+
+    size_t done = full_words * 64;
+    for (size_t i = done; i < bit_count; i++) {
+        presence[i] = (bytes[i / 8] >> (i % 8)) & 1;
+    }
+}
+
+void lum_presence_to_bytes(const uint8_t* presence, size_t bit_count, uint8_t* bytes) {
+    if (!presence || !bytes) {
+        return;
+    }
+
+    LumCodecLevel level = lum_codec_level();
+    size_t full_words = bit_count / 64;
+
+    for (size_t w = 0; w < full_words; w++) {
+        uint64_t word = LUM_LE64(presence_pack64(level, presence + w * 64));
+        memcpy(bytes + w * 8, &word, sizeof(word));
+    }
+
+    size_t done = full_words * 64;
+    if (done < bit_count) {
+        uint64_t tail = presence_pack_scalar(presence + done, bit_count - done);
+        for (size_t i = 0; i * 8 < bit_count - done; i++) {
+            bytes[done / 8 + i] = (uint8_t)(tail >> (i * 8));
+        }
+    }
+}
+
+void lum_presence_to_words(const uint8_t* presence, size_t bit_count, uint64_t* words) {
+    if (!presence || !words) {
+        return;
+    }
+
+    LumCodecLevel level = lum_codec_level();
+    size_t full_words = bit_count / 64;
+
+    for (size_t w = 0; w < full_words; w++) {
+        words[w] = presence_pack64(level, presence + w * 64);
+    }
+    if (full_words * 64 < bit_count) {
+        words[full_words] = presence_pack_scalar(presence + full_words * 64, bit_count - full_words * 64);
+    }
+}
+
+void lum_bytes_to_words(const uint8_t* bytes, size_t byte_count, uint64_t* words) {
+    if (!bytes || !words) {
+        return;
+    }
+
+    size_t full_words = byte_count / 8;
+#if LUM_LITTLE_ENDIAN
+    memcpy(words, bytes, full_words * 8);
+#else
+    for (size_t w = 0; w < full_words; w++) {
+        uint64_t word;
+        memcpy(&word, bytes + w * 8, sizeof(word));
+        words[w] = LUM_LE64(word);
+    }
+#endif
+
+    if (byte_count % 8) {
+        uint64_t tail = 0;
+        for (size_t i = full_words * 8; i < byte_count; i++) {
+            tail |= (uint64_t)bytes[i] << ((i % 8) * 8);
+        }
+        words[full_words] = tail;
+    }
+}
+
+void lum_words_to_bytes(const uint64_t* words, size_t byte_count, uint8_t* bytes) {
+    if (!words || !bytes) {
+        return;
+    }
+
+    size_t full_words = byte_count / 8;
+#if LUM_LITTLE_ENDIAN
+    memcpy(bytes, words, full_words * 8);
+#else
+    for (size_t w = 0; w < full_words; w++) {
+        uint64_t word = LUM_LE64(words[w]);
+        memcpy(bytes + w * 8, &word, sizeof(word));
+    }
+#endif
+
+    for (size_t i = full_words * 8; i < byte_count; i++) {
+        bytes[i] = (uint8_t)(words[full_words] >> ((i % 8) * 8));
+    }
+}
+
+// ===== Column kernels (structure-of-arrays groups) =====
+
+static size_t bytes_sum_scalar(const uint8_t* bytes, size_t count) {
+    size_t sum = 0;
+    for (size_t i = 0; i < count; i++) {
+        sum += bytes[i];
+    }
+    return sum;
+}
+
+static uint8_t bytes_max_scalar(const uint8_t* bytes, size_t count) {
+    uint8_t max = 0;
+    for (size_t i = 0; i < count; i++) {
+        max = bytes[i] > max ? bytes[i] : max;
+    }
+    return max;
+}
+
+static void bytes_histogram8_scalar(const uint8_t* bytes, size_t count, size_t counts[8]) {
+    for (size_t i = 0; i < count; i++) {
+        if (bytes[i] < 8) {
+            counts[bytes[i]]++;
+        }
+    }
+}
+
+static int positions_check_scalar(const int32_t* x, const int32_t* y, size_t count,
+                                  int32_t offset_x, int32_t offset_y,
+                                  int32_t bound, int32_t min_distance_sq) {
+    for (size_t i = 0; i < count; i++) {
+        int32_t px = x[i] + offset_x;
+        int32_t py = y[i] + offset_y;
+        if (px < -bound || px > bound || py < -bound || py > bound) {
+            return 0;
+        }
+        if (i > 0) {
+            int32_t dx = x[i] - x[i - 1];
+            int32_t dy = y[i] - y[i - 1];
+            if (dx * dx + dy * dy < min_distance_sq) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+// ===== Word kernels (presence bits) =====
+
+static size_t words_popcount_scalar(const uint64_t* words, size_t count) {
+    size_t ones = 0;
+    for (size_t w = 0; w < count; w++) {
+        ones += (size_t)__builtin_popcountll(words[w]);
+    }
+    return ones;
+}
+
+static size_t words_hamming_scalar(const uint64_t* a, const uint64_t* b, size_t count) {
+    size_t ones = 0;
+    for (size_t w = 0; w < count; w++) {
+        ones += (size_t)__builtin_popcountll(a[w] ^ b[w]);
+    }
+    return ones;
+}
+
+#ifdef LUM_CODEC_X86
+
+__attribute__((target("sse2")))
+static size_t bytes_sum_sse2(const uint8_t* bytes, size_t count) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = zero;
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(bytes + i));
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(v, zero));
+    }
+
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i*)lanes, acc);
+    return (size_t)(lanes[0] + lanes[1]) + bytes_sum_scalar(bytes + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static size_t bytes_sum_avx2(const uint8_t* bytes, size_t count) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i acc = zero;
+    size_t i = 0;
+
+    for (; i + 32 <= count; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(bytes + i));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(v, zero));
+    }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, acc);
+    return (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]) +
+           bytes_sum_scalar(bytes + i, count - i);
+}
+
+__attribute__((target("sse2")))
+static uint8_t bytes_max_sse2(const uint8_t* bytes, size_t count) {
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        acc = _mm_max_epu8(acc, _mm_loadu_si128((const __m128i*)(bytes + i)));
+    }
+
+    uint8_t lanes[16];
+    _mm_storeu_si128((__m128i*)lanes, acc);
+    uint8_t max = bytes_max_scalar(lanes, 16);
+    uint8_t tail = bytes_max_scalar(bytes + i, count - i);
+    return tail > max ? tail : max;
+}
+
+__attribute__((target("avx2")))
+static uint8_t bytes_max_avx2(const uint8_t* bytes, size_t count) {
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; i + 32 <= count; i += 32) {
+        acc = _mm256_max_epu8(acc, _mm256_loadu_si256((const __m256i*)(bytes + i)));
+    }
+
+    uint8_t lanes[32];
+    _mm256_storeu_si256((__m256i*)lanes, acc);
+    uint8_t max = bytes_max_scalar(lanes, 32);
+    uint8_t tail = bytes_max_scalar(bytes + i, count - i);
+    return tail > max ? tail : max;
+}
+
+// Byte counters overflow after 255 vectors, flush them through psadbw
+#define HISTOGRAM_FLUSH 255
+
+__attribute__((target("sse2")))
+static void bytes_histogram8_sse2(const uint8_t* bytes, size_t count, size_t counts[8]) {
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+
+    while (i + 16 <= count) {
+        __m128i acc[8];
+        for (int v = 0; v < 8; v++) {
+            acc[v] = zero;
+        }
+
+        for (int n = 0; n < HISTOGRAM_FLUSH && i + 16 <= count; n++, i += 16) {
+            __m128i data = _mm_loadu_si128((const __m128i*)(bytes + i));
+            for (int v = 0; v < 8; v++) {
+                acc[v] = _mm_sub_epi8(acc[v], _mm_cmpeq_epi8(data, _mm_set1_epi8((char)v)));
+            }
+        }
+
+        for (int v = 0; v < 8; v++) {
+            uint64_t lanes[2];
+            _mm_storeu_si128((__m128i*)lanes, _mm_sad_epu8(acc[v], zero));
+            counts[v] += (size_t)(lanes[0] + lanes[1]);
+        }
+    }
+    bytes_histogram8_scalar(bytes + i, count - i, counts);
+}
+
+__attribute__((target("avx2")))
+static void bytes_histogram8_avx2(const uint8_t* bytes, size_t count, size_t counts[8]) {
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+
+    while (i + 32 <= count) {
+        __m256i acc[8];
+        for (int v = 0; v < 8; v++) {
+            acc[v] = zero;
+        }
+
+        for (int n = 0; n < HISTOGRAM_FLUSH && i + 32 <= count; n++, i += 32) {
+            __m256i data = _mm256_loadu_si256((const __m256i*)(bytes + i));
+            for (int v = 0; v < 8; v++) {
+                acc[v] = _mm256_sub_epi8(acc[v], _mm256_cmpeq_epi8(data, _mm256_set1_epi8((char)v)));
+            }
+        }
+
+        for (int v = 0; v < 8; v++) {
+            uint64_t lanes[4];
+            _mm256_storeu_si256((__m256i*)lanes, _mm256_sad_epu8(acc[v], zero));
+            counts[v] += (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+        }
+    }
+    bytes_histogram8_scalar(bytes + i, count - i, counts);
+}
+
+/**
+ * dx^2 + dy^2 per 32-bit lane with pmaddwd: dx / dy are packed as the
+ * low / high int16 of each lane, exact while |dx|, |dy| <= 32767
+ */
+__attribute__((target("sse2")))
+static int positions_check_sse2(const int32_t* x, const int32_t* y, size_t count,
+                                int32_t offset_x, int32_t offset_y,
+                                int32_t bound, int32_t min_distance_sq) {
+    if (count == 0) {
+        return 1;
+    }
+    const __m128i ox = _mm_set1_epi32(offset_x);
+    const __m128i oy = _mm_set1_epi32(offset_y);
+    const __m128i hi = _mm_set1_epi32(bound);
+    const __m128i lo = _mm_set1_epi32(-bound);
+    const __m128i min_sq = _mm_set1_epi32(min_distance_sq);
+    const __m128i low16 = _mm_set1_epi32(0xFFFF);
+    __m128i bad = _mm_setzero_si128();
+    size_t i = 1;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i cx = _mm_loadu_si128((const __m128i*)(x + i));
+        __m128i cy = _mm_loadu_si128((const __m128i*)(y + i));
+        __m128i px = _mm_add_epi32(cx, ox);
+        __m128i py = _mm_add_epi32(cy, oy);
+        bad = _mm_or_si128(bad, _mm_or_si128(_mm_cmpgt_epi32(px, hi), _mm_cmpgt_epi32(lo, px)));
+        bad = _mm_or_si128(bad, _mm_or_si128(_mm_cmpgt_epi32(py, hi), _mm_cmpgt_epi32(lo, py)));
+
+        __m128i dx = _mm_sub_epi32(cx, _mm_loadu_si128((const __m128i*)(x + i - 1)));
+        __m128i dy = _mm_sub_epi32(cy, _mm_loadu_si128((const __m128i*)(y + i - 1)));
+        __m128i dxy = _mm_or_si128(_mm_and_si128(dx, low16), _mm_slli_epi32(dy, 16));
+        bad = _mm_or_si128(bad, _mm_cmpgt_epi32(min_sq, _mm_madd_epi16(dxy, dxy)));
+    }
+
+    if (_mm_movemask_epi8(bad) != 0) {
+        return 0;
+    }
+    // Element 0 and the tail (overlapping by one for the last distance)
+    return positions_check_scalar(x, y, 1, offset_x, offset_y, bound, min_distance_sq) &&
+           positions_check_scalar(x + i - 1, y + i - 1, count - i + 1,
+                                  offset_x, offset_y, bound, min_distance_sq);
+}
+
+__attribute__((target("avx2")))
+static int positions_check_avx2(const int32_t* x, const int32_t* y, size_t count,
+                                int32_t offset_x, int32_t offset_y,
+                                int32_t bound, int32_t min_distance_sq) {
+    if (count == 0) {
+        return 1;
+    }
+    const __m256i ox = _mm256_set1_epi32(offset_x);
+    const __m256i oy = _mm256_set1_epi32(offset_y);
+    const __m256i hi = _mm256_set1_epi32(bound);
+    const __m256i lo = _mm256_set1_epi32(-bound);
+    const __m256i min_sq = _mm256_set1_epi32(min_distance_sq);
+    const __m256i low16 = _mm256_set1_epi32(0xFFFF);
+    __m256i bad = _mm256_setzero_si256();
+    size_t i = 1;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i cx = _mm256_loadu_si256((const __m256i*)(x + i));
+        __m256i cy = _mm256_loadu_si256((const __m256i*)(y + i));
+        __m256i px = _mm256_add_epi32(cx, ox);
+        __m256i py = _mm256_add_epi32(cy, oy);
+        bad = _mm256_or_si256(bad, _mm256_or_si256(_mm256_cmpgt_epi32(px, hi), _mm256_cmpgt_epi32(lo, px)));
+        bad = _mm256_or_si256(bad, _mm256_or_si256(_mm256_cmpgt_epi32(py, hi), _mm256_cmpgt_epi32(lo, py)));
+
+        __m256i dx = _mm256_sub_epi32(cx, _mm256_loadu_si256((const __m256i*)(x + i - 1)));
+        __m256i dy = _mm256_sub_epi32(cy, _mm256_loadu_si256((const __m256i*)(y + i - 1)));
+        __m256i dxy = _mm256_or_si256(_mm256_and_si256(dx, low16), _mm256_slli_epi32(dy, 16));
+        bad = _mm256_or_si256(bad, _mm256_cmpgt_epi32(min_sq, _mm256_madd_epi16(dxy, dxy)));
+    }
+
+    if (_mm256_movemask_epi8(bad) != 0) {
+        return 0;
+    }
+    return positions_check_scalar(x, y, 1, offset_x, offset_y, bound, min_distance_sq) &&
+           positions_check_scalar(x + i - 1, y + i - 1, count - i + 1,
+                                  offset_x, offset_y, bound, min_distance_sq);
+}
+
+/**
+ * Per-byte popcount through a nibble lookup, summed into 64-bit lanes
+ */
+__attribute__((target("avx2")))
+static __m256i popcount256(__m256i v) {
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low4 = _mm256_set1_epi8(0x0F);
+    __m256i low = _mm256_shuffle_epi8(table, _mm256_and_si256(v, low4));
+    __m256i high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), low4));
+    return _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2")))
+static size_t words_popcount_avx2(const uint64_t* words, size_t count) {
+    __m256i acc = _mm256_setzero_si256();
+    size_t w = 0;
+
+    for (; w + 4 <= count; w += 4) {
+        acc = _mm256_add_epi64(acc, popcount256(_mm256_loadu_si256((const __m256i*)(words + w))));
+    }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, acc);
+    return (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]) +
+           words_popcount_scalar(words + w, count - w);
+}
+
+__attribute__((target("avx2")))
+static size_t words_hamming_avx2(const uint64_t* a, const uint64_t* b, size_t count) {
+    __m256i acc = _mm256_setzero_si256();
+    size_t w = 0;
+
+    for (; w + 4 <= count; w += 4) {
+        __m256i diff = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a + w)),
+                                        _mm256_loadu_si256((const __m256i*)(b + w)));
+        acc = _mm256_add_epi64(acc, popcount256(diff));
+    }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, acc);
+    return (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]) +
+           words_hamming_scalar(a + w, b + w, count - w);
+}
+
+#endif // LUM_CODEC_X86
+
+size_t lum_bytes_sum(const uint8_t* bytes, size_t count) {
+    if (!bytes) {
+        return 0;
+    }
+#ifdef LUM_CODEC_X86
+    LumCodecLevel level = lum_codec_level();
+    if (level == LUM_CODEC_AVX2) {
+        return bytes_sum_avx2(bytes, count);
+    }
+    if (level == LUM_CODEC_SSE2) {
+        return bytes_sum_sse2(bytes, count);
+    }
+#endif
+    return bytes_sum_scalar(bytes, count);
+}
+
+uint8_t lum_bytes_max(const uint8_t* bytes, size_t count) {
+    if (!bytes) {
+        return 0;
+    }
+#ifdef LUM_CODEC_X86
+    LumCodecLevel level = lum_codec_level();
+    if (level == LUM_CODEC_AVX2) {
+        return bytes_max_avx2(bytes, count);
+    }
+    if (level == LUM_CODEC_SSE2) {
+        return bytes_max_sse2(bytes, count);
+    }
+#endif
+    return bytes_max_scalar(bytes, count);
+}
+
+void lum_bytes_histogram8(const uint8_t* bytes, size_t count, size_t counts[8]) {
+    memset(counts, 0, sizeof(size_t) * 8);
+    if (!bytes) {
+        return;
+    }
+#ifdef LUM_CODEC_X86
+    LumCodecLevel level = lum_codec_level();
+    if (level == LUM_CODEC_AVX2) {
+        bytes_histogram8_avx2(bytes, count, counts);
+        return;
+    }
+    if (level == LUM_CODEC_SSE2) {
+        bytes_histogram8_sse2(bytes, count, counts);
+        return;
+    }
+#endif
+    bytes_histogram8_scalar(bytes, count, counts);
+}
+
+int lum_positions_check(const int32_t* x, const int32_t* y, size_t count,
+                        int32_t offset_x, int32_t offset_y,
+                        int32_t bound, int32_t min_distance_sq) {
+    if (!x || !y) {
+        return count == 0;
+    }
+#ifdef LUM_CODEC_X86
+    // pmaddwd distances need |dx|, |dy| <= 2 * bound to fit in int16
+    LumCodecLevel level = bound <= 16383 ? lum_codec_level() : LUM_CODEC_SCALAR;
+    if (level == LUM_CODEC_AVX2) {
+        return positions_check_avx2(x, y, count, offset_x, offset_y, bound, min_distance_sq);
+    }
+    if (level == LUM_CODEC_SSE2) {
+        return positions_check_sse2(x, y, count, offset_x, offset_y, bound, min_distance_sq);
+    }
+#endif
+    return positions_check_scalar(x, y, count, offset_x, offset_y, bound, min_distance_sq);
+}
+
+size_t lum_words_popcount(const uint64_t* words, size_t count) {
+    if (!words) {
+        return 0;
+    }
+#ifdef LUM_CODEC_X86
+    if (lum_codec_level() == LUM_CODEC_AVX2) {
+        return words_popcount_avx2(words, count);
+    }
+#endif
+    return words_popcount_scalar(words, count);
+}
+
+size_t lum_words_hamming(const uint64_t* a, const uint64_t* b, size_t count) {
+    if (!a || !b) {
+        return 0;
+    }
+#ifdef LUM_CODEC_X86
+    if (lum_codec_level() == LUM_CODEC_AVX2) {
+        return words_hamming_avx2(a, b, count);
+    }
+#endif
+    return words_hamming_scalar(a, b, count);
+}
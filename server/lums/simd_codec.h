@@ -0,0 +1,50 @@
+#ifndef SIMD_CODEC_H
+#define SIMD_CODEC_H
+
+#include "lums.h"
+
+// Instruction set used by the bulk codecs (detected once at runtime)
+typedef enum {
+    LUM_CODEC_SCALAR = 0,
+    LUM_CODEC_SSE2 = 1,
+    LUM_CODEC_AVX2 = 2
+} LumCodecLevel;
+
+LumCodecLevel lum_codec_level(void);
+void lum_codec_force_level(LumCodecLevel level);
+
+// ASCII '0'/'1' text <-> presence bits (bit i of words[i / 64])
+// Writes (len + 63) / 64 words, bits past len cleared.
+// Returns 0, or -1 if any character is not '0' or '1'.
+int lum_ascii_to_words(const char* text, size_t len, uint64_t* words);
+// Writes bit_count characters, no terminator
+void lum_words_to_ascii(const uint64_t* words, size_t bit_count, char* out);
+
+// Raw bytes <-> one presence byte (0/1) per bit, 64 bits per step
+void lum_bytes_to_presence(const uint8_t* bytes, size_t bit_count, uint8_t* presence);
+// Writes (bit_count + 7) / 8 bytes, bits past bit_count cleared
+void lum_presence_to_bytes(const uint8_t* presence, size_t bit_count, uint8_t* bytes);
+// Writes (bit_count + 63) / 64 words, bits past bit_count cleared
+void lum_presence_to_words(const uint8_t* presence, size_t bit_count, uint64_t* words);
+
+// Raw bytes <-> packed words (bulk copy on little-endian hosts)
+// bytes_to_words writes (byte_count + 7) / 8 words, bytes past byte_count cleared
+void lum_bytes_to_words(const uint8_t* bytes, size_t byte_count, uint64_t* words);
+void lum_words_to_bytes(const uint64_t* words, size_t byte_count, uint8_t* bytes);
+
+// Column kernels for structure-of-arrays groups
+size_t lum_bytes_sum(const uint8_t* bytes, size_t count);
+uint8_t lum_bytes_max(const uint8_t* bytes, size_t count);
+// counts[v] = number of bytes equal to v (values >= 8 are not counted)
+void lum_bytes_histogram8(const uint8_t* bytes, size_t count, size_t counts[8]);
+// 1 if every (x + offset_x, y + offset_y) lies within +/-bound and
+// consecutive points are at least sqrt(min_distance_sq) apart
+int lum_positions_check(const int32_t* x, const int32_t* y, size_t count,
+                        int32_t offset_x, int32_t offset_y,
+                        int32_t bound, int32_t min_distance_sq);
+
+// Set bits of words[0 .. count), and of a[w] ^ b[w]
+size_t lum_words_popcount(const uint64_t* words, size_t count);
+size_t lum_words_hamming(const uint64_t* a, const uint64_t* b, size_t count);
+
+#endif // SIMD_CODEC_H
@@ -0,0 +1,615 @@
+#include "lums.h"
+#include "soa.h"
+#include "layout.h"
+#include "simd_codec.h"
+#include "operations.h"
+#include "view.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#ifndef LOG_ERROR
+#define LOG_ERROR(...) fprintf(stderr, "ERROR: " __VA_ARGS__); fprintf(stderr, "\n")
+#endif
+
+// Same limits as validate_lums
+#define SOA_POSITION_BOUND 10000
+#define SOA_MIN_DISTANCE_SQ 100
+// Implicit positions are validated this many at a time
+#define SOA_VALIDATE_CHUNK 256
+
+void free_soa_storage(LumSoaStorage* soa) {
+    if (!soa) {
+        return;
+    }
+    free(soa->presence);
+    free(soa->structure_type);
+    free(soa->x);
+    free(soa->y);
+    free(soa->spatial_data);
+    free(soa);
+}
+
+/**
+ * Allocate the x / y columns, only needed for LUM_LAYOUT_EXPLICIT
+ */
+static int soa_alloc_positions(LumSoaStorage* soa, size_t count) {
+    if (soa->x || count == 0) {
+        return 0;
+    }
+    soa->x = (int32_t*)calloc(count, sizeof(int32_t));
+    soa->y = (int32_t*)calloc(count, sizeof(int32_t));
+    if (!soa->x || !soa->y) {
+        free(soa->x);
+        free(soa->y);
+        soa->x = soa->y = NULL;
+        LOG_ERROR("Memory allocation failed for %zu SoA positions", count);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Copy spatial pointers of src [start, start + count) to dst from dst_index,
+ * the dst column is only allocated once a pointer has to be stored
+ */
+static int soa_copy_spatial(LUMGroup* dst, size_t dst_index,
+                            const LUMGroup* src, size_t start, size_t count) {
+    SpatialData** column = src->soa->spatial_data;
+    if (!column || count == 0) {
+        return 0;
+    }
+    if (!dst->soa->spatial_data) {
+        dst->soa->spatial_data = (SpatialData**)calloc(dst->count, sizeof(SpatialData*));
+        if (!dst->soa->spatial_data) {
+            return -1;
+        }
+    }
+    memcpy(dst->soa->spatial_data + dst_index, column + start, sizeof(SpatialData*) * count);
+    return 0;
+}
+
+/**
+ * Create a SoA LUM group with every column cleared.
+ * Default layout matches encode_bit_to_lum: linear, 20 units apart.
+ */
+LUMGroup* create_soa_lum_group(size_t count, GroupType type) {
+    LUMGroup* group = (LUMGroup*)calloc(1, sizeof(LUMGroup));
+    LumSoaStorage* soa = (LumSoaStorage*)calloc(1, sizeof(LumSoaStorage));
+    if (!group || !soa) {
+        free(group);
+        free(soa);
+        LOG_ERROR("Memory allocation failed for SoA LUMGroup");
+        return NULL;
+    }
+
+    if (count > 0) {
+        soa->presence = (uint8_t*)calloc(count, sizeof(uint8_t));
+        soa->structure_type = (uint8_t*)calloc(count, sizeof(uint8_t));
+        if (!soa->presence || !soa->structure_type) {
+            free_soa_storage(soa);
+            free(group);
+            LOG_ERROR("Memory allocation failed for %zu SoA LUMs", count);
+            return NULL;
+        }
+    }
+
+    group->count = count;
+    group->group_type = type;
+    group->storage = LUM_STORAGE_SOA;
+    group->soa = soa;
+    group->layout = lum_layout_linear(0, 0, 20);
+
+    return group;
+}
+
+/**
+ * Build a SoA copy of a dense group
+ */
+LUMGroup* soa_from_dense(const LUMGroup* source) {
+    if (!source || source->storage != LUM_STORAGE_DENSE || (!source->lums && source->count > 0)) {
+        return NULL;
+    }
+
+    LUMGroup* result = create_soa_lum_group(source->count, source->group_type);
+    if (!result) {
+        return NULL;
+    }
+    LumSoaStorage* soa = result->soa;
+    result->layout = source->layout;
+
+    if (source->layout.kind == LUM_LAYOUT_EXPLICIT && soa_alloc_positions(soa, source->count) != 0) {
+        free_lum_group(result);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < source->count; i++) {
+        const LUM* lum = &source->lums[i];
+        soa->presence[i] = lum->presence;
+        soa->structure_type[i] = (uint8_t)lum->structure_type;
+        if (soa->x) {
+            soa->x[i] = lum->position.x;
+            soa->y[i] = lum->position.y;
+        }
+        if (lum->spatial_data) {
+            if (!soa->spatial_data) {
+                soa->spatial_data = (SpatialData**)calloc(source->count, sizeof(SpatialData*));
+                if (!soa->spatial_data) {
+                    free_lum_group(result);
+                    return NULL;
+                }
+            }
+            soa->spatial_data[i] = lum->spatial_data;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Columns to LUM structs, positions left as stored (relative to the layout offset)
+ */
+static void soa_unpack_columns(const LUMGroup* group, LUM* out) {
+    const LumSoaStorage* soa = group->soa;
+
+    for (size_t i = 0; i < group->count; i++) {
+        out[i].presence = soa->presence[i];
+        out[i].structure_type = (LumStructureType)soa->structure_type[i];
+        out[i].spatial_data = soa->spatial_data ? soa->spatial_data[i] : NULL;
+        out[i].position.x = soa->x ? soa->x[i] : 0;
+        out[i].position.y = soa->y ? soa->y[i] : 0;
+    }
+}
+
+/**
+ * Dense copy of a SoA group, same layout
+ */
+LUMGroup* soa_to_dense(const LUMGroup* source) {
+    if (!source || source->storage != LUM_STORAGE_SOA || !source->soa) {
+        return NULL;
+    }
+
+    LUMGroup* result = (LUMGroup*)calloc(1, sizeof(LUMGroup));
+    LUM* lums = (LUM*)malloc(sizeof(LUM) * (source->count > 0 ? source->count : 1));
+    if (!result || !lums) {
+        free(result);
+        free(lums);
+        LOG_ERROR("Memory allocation failed expanding %zu SoA LUMs", source->count);
+        return NULL;
+    }
+
+    soa_unpack_columns(source, lums);
+    result->lums = lums;
+    result->count = source->count;
+    result->group_type = source->group_type;
+    result->storage = LUM_STORAGE_DENSE;
+    result->layout = source->layout;
+    return result;
+}
+
+/**
+ * Deep copy of a SoA group (spatial data pointers are shared)
+ */
+LUMGroup* soa_clone(const LUMGroup* source) {
+    if (!source || source->storage != LUM_STORAGE_SOA || !source->soa) {
+        return NULL;
+    }
+
+    LUMGroup* result = create_soa_lum_group(source->count, source->group_type);
+    if (!result) {
+        return NULL;
+    }
+    size_t count = source->count;
+    result->layout = source->layout;
+
+    if (count > 0) {
+        memcpy(result->soa->presence, source->soa->presence, count);
+        memcpy(result->soa->structure_type, source->soa->structure_type, count);
+    }
+    if (source->soa->x) {
+        if (soa_alloc_positions(result->soa, count) != 0) {
+            free_lum_group(result);
+            return NULL;
+        }
+        memcpy(result->soa->x, source->soa->x, sizeof(int32_t) * count);
+        memcpy(result->soa->y, source->soa->y, sizeof(int32_t) * count);
+    }
+    if (soa_copy_spatial(result, 0, source, 0, count) != 0) {
+        free_lum_group(result);
+        return NULL;
+    }
+    return result;
+}
+
+/**
+ * Convert a dense group to columns in place
+ */
+int lum_group_to_soa(LUMGroup* group) {
+    if (!group) {
+        return -1;
+    }
+    if (group->storage == LUM_STORAGE_SOA) {
+        return 0;
+    }
+
+    LUMGroup* soa_group = soa_from_dense(group);
+    if (!soa_group) {
+        return -1;
+    }
+
+    lum_group_release_storage(group);
+    group->storage = LUM_STORAGE_SOA;
+    group->soa = soa_group->soa;
+
+    soa_group->soa = NULL;
+    free(soa_group);
+    return 0;
+}
+
+/**
+ * Convert columns back to one LUM struct each, in place
+ */
+int lum_group_from_soa(LUMGroup* group) {
+    if (!group) {
+        return -1;
+    }
+    if (group->storage != LUM_STORAGE_SOA) {
+        return group->storage == LUM_STORAGE_DENSE ? 0 : -1;
+    }
+
+    LUMGroup* dense = soa_to_dense(group);
+    if (!dense) {
+        return -1;
+    }
+
+    lum_group_release_storage(group);
+    group->lums = dense->lums;
+    group->storage = LUM_STORAGE_DENSE;
+
+    dense->lums = NULL;
+    free(dense);
+    return 0;
+}
+
+int soa_get_lum(const LUMGroup* group, size_t index, LUM* out) {
+    if (!group || !group->soa || !out || index >= group->count) {
+        return -1;
+    }
+
+    const LumSoaStorage* soa = group->soa;
+    out->presence = soa->presence[index];
+    out->structure_type = (LumStructureType)soa->structure_type[index];
+    out->spatial_data = soa->spatial_data ? soa->spatial_data[index] : NULL;
+    return lum_group_position(group, index, &out->position.x, &out->position.y);
+}
+
+/**
+ * Materialize every LUM of a SoA group into out[0..count)
+ */
+int soa_expand(const LUMGroup* group, LUM* out) {
+    if (!group || !group->soa || !out) {
+        return -1;
+    }
+    soa_unpack_columns(group, out);
+    return lum_group_fill_positions(group, 0, 0, out);
+}
+
+/**
+ * Implicit layouts: generate positions chunk by chunk, each chunk starts
+ * with the last position of the previous one for the distance check
+ */
+static int soa_validate_layout(const LUMGroup* group) {
+    if (group->count == 0) {
+        return 1;
+    }
+    // Spiral fills resume where the previous chunk stopped, no replay from index 0
+    size_t chunk = SOA_VALIDATE_CHUNK;
+    LUM* lums = (LUM*)malloc(sizeof(LUM) * chunk);
+    int32_t* xs = (int32_t*)malloc(sizeof(int32_t) * (chunk + 1));
+    int32_t* ys = (int32_t*)malloc(sizeof(int32_t) * (chunk + 1));
+    int valid = lums && xs && ys;
+
+    for (size_t start = 0; valid && start < group->count; start += chunk) {
+        size_t n = group->count - start < chunk ? group->count - start : chunk;
+        lum_layout_fill(&group->layout, start, n, lums);
+        for (size_t k = 0; k < n; k++) {
+            xs[k + 1] = lums[k].position.x;
+            ys[k + 1] = lums[k].position.y;
+        }
+
+        size_t first = start == 0 ? 1 : 0;
+        valid = lum_positions_check(xs + first, ys + first, n + 1 - first, 0, 0,
+                                    SOA_POSITION_BOUND, SOA_MIN_DISTANCE_SQ);
+        xs[0] = xs[n];
+        ys[0] = ys[n];
+    }
+
+    free(lums);
+    free(xs);
+    free(ys);
+    return valid;
+}
+
+/**
+ * validate_lums on the columns: presence and type via byte max,
+ * positions via the vectorized range / distance check
+ */
+int soa_validate(const LUMGroup* group) {
+    if (!group || !group->soa) {
+        return 0;
+    }
+    const LumSoaStorage* soa = group->soa;
+
+    if (lum_bytes_max(soa->presence, group->count) > 1 ||
+        lum_bytes_max(soa->structure_type, group->count) > LUM_CYCLE) {
+        return 0;
+    }
+    if (group->layout.kind == LUM_LAYOUT_EXPLICIT) {
+        return lum_positions_check(soa->x, soa->y, group->count,
+                                   group->layout.offset_x, group->layout.offset_y,
+                                   SOA_POSITION_BOUND, SOA_MIN_DISTANCE_SQ);
+    }
+    return soa_validate_layout(group);
+}
+
+/**
+ * Contextual split on the type column: one histogram pass sizes every
+ * output, one gather pass fills them
+ */
+LUMGroup** soa_contextual_split(LUMGroup* source, size_t* result_count) {
+    if (!source || !source->soa || !result_count) {
+        if (result_count) *result_count = 0;
+        LOG_ERROR("Invalid input for soa_contextual_split");
+        return NULL;
+    }
+
+    const LumSoaStorage* soa = source->soa;
+    size_t type_counts[8];
+    lum_bytes_histogram8(soa->structure_type, source->count, type_counts);
+
+    // Same types as the dense split
+    size_t known = 0;
+    size_t active_types = 0;
+    for (int type = 0; type < LUM_STRUCTURE_TYPES; type++) {
+        known += type_counts[type];
+        active_types += type_counts[type] > 0;
+    }
+    if (known < source->count) {
+        LOG_ERROR("Encountered %zu LUMs with unexpected structure_type", source->count - known);
+    }
+    if (active_types == 0) {
+        *result_count = 0;
+        LOG_ERROR("No LUMs with known structure types found for contextual split");
+        return NULL;
+    }
+
+    LUMGroup** result = (LUMGroup**)calloc(active_types, sizeof(LUMGroup*));
+    LUMGroup* by_type[LUM_STRUCTURE_TYPES] = {NULL};
+    size_t cursor[LUM_STRUCTURE_TYPES] = {0};
+    if (!result) {
+        *result_count = 0;
+        LOG_ERROR("Memory allocation failed for result array in contextual split");
+        return NULL;
+    }
+
+    size_t group_index = 0;
+    for (int type = 0; type < LUM_STRUCTURE_TYPES; type++) {
+        if (type_counts[type] == 0) continue;
+
+        GroupType group_type = type == LUM_GROUP || type == LUM_CLUSTER ? GROUP_CLUSTER : GROUP_LINEAR;
+        by_type[type] = create_soa_lum_group(type_counts[type], group_type);
+        if (!by_type[type] ||
+            (soa->spatial_data &&
+             !(by_type[type]->soa->spatial_data =
+                   (SpatialData**)calloc(type_counts[type], sizeof(SpatialData*))))) {
+            LOG_ERROR("Failed to create LUM group for type %d in contextual split", type);
+            free_lum_group(by_type[type]);
+            free_split_result(result, group_index);
+            *result_count = 0;
+            return NULL;
+        }
+        memset(by_type[type]->soa->structure_type, type, type_counts[type]);
+        by_type[type]->layout = lum_layout_linear(0, type * 40, 20); // Different Y for each type
+        result[group_index++] = by_type[type];
+    }
+
+    for (size_t i = 0; i < source->count; i++) {
+        uint8_t type = soa->structure_type[i];
+        if (type >= LUM_STRUCTURE_TYPES) continue;
+
+        LumSoaStorage* dst = by_type[type]->soa;
+        dst->presence[cursor[type]] = soa->presence[i];
+        if (soa->spatial_data) {
+            dst->spatial_data[cursor[type]] = soa->spatial_data[i];
+        }
+        cursor[type]++;
+    }
+
+    *result_count = active_types;
+    return result;
+}
+
+/**
+ * SoA Fusion (⧉): column concatenation, same semantics as lum_fusion
+ */
+LUMGroup* soa_lum_fusion(LUMGroup* group1, LUMGroup* group2) {
+    if (!group1 || !group2) {
+        LOG_ERROR("Invalid input groups for soa_lum_fusion");
+        return NULL;
+    }
+
+    // Mixed storage: convert the dense operand into a temporary
+    LUMGroup* temp1 = group1->storage == LUM_STORAGE_SOA ? NULL : soa_from_dense(group1);
+    LUMGroup* temp2 = group2->storage == LUM_STORAGE_SOA ? NULL : soa_from_dense(group2);
+    LUMGroup* a = temp1 ? temp1 : group1;
+    LUMGroup* b = temp2 ? temp2 : group2;
+    LUMGroup* result = NULL;
+    LUM* positions = NULL;
+
+    if (a->storage != LUM_STORAGE_SOA || b->storage != LUM_STORAGE_SOA) {
+        LOG_ERROR("Unsupported storage for soa_lum_fusion");
+        goto cleanup;
+    }
+
+    size_t total_count = a->count + b->count;
+    int shift_x = lum_fusion_shift(a->count);
+
+    result = create_soa_lum_group(total_count, GROUP_CLUSTER);
+    if (!result) {
+        LOG_ERROR("Failed to create fused SoA LUM group");
+        goto cleanup;
+    }
+    LumSoaStorage* soa = result->soa;
+
+    if (a->count > 0) {
+        memcpy(soa->presence, a->soa->presence, a->count);
+        memcpy(soa->structure_type, a->soa->structure_type, a->count);
+    }
+    if (b->count > 0) {
+        memcpy(soa->presence + a->count, b->soa->presence, b->count);
+        memset(soa->structure_type + a->count, LUM_GROUP, b->count); // Mark as part of fusion
+    }
+
+    if (soa_copy_spatial(result, 0, a, 0, a->count) != 0 ||
+        soa_copy_spatial(result, a->count, b, 0, b->count) != 0) {
+        goto fail;
+    }
+
+    if (lum_layout_concat(&a->layout, a->count, &b->layout, shift_x, &result->layout) != 0) {
+        positions = (LUM*)malloc(sizeof(LUM) * (total_count > 0 ? total_count : 1));
+        if (!positions || soa_alloc_positions(soa, total_count) != 0) {
+            goto fail;
+        }
+        lum_group_fill_positions(a, 0, 0, positions);
+        lum_group_fill_positions(b, shift_x, 0, positions + a->count);
+        result->layout = lum_layout_explicit();
+
+        for (size_t i = 0; i < total_count; i++) {
+            soa->x[i] = positions[i].position.x;
+            soa->y[i] = positions[i].position.y;
+        }
+    }
+    goto cleanup;
+
+fail:
+    LOG_ERROR("Memory allocation failed in soa_lum_fusion");
+    free_lum_group(result);
+    result = NULL;
+
+cleanup:
+    free(positions);
+    free_lum_group(temp1);
+    free_lum_group(temp2);
+    return result;
+}
+
+/**
+ * SoA Split (⇅): each zone receives a column range laid out at y = zone * 50
+ */
+LUMGroup** soa_lum_split(LUMGroup* source, int zones, size_t* result_count) {
+    if (!source || !source->soa || zones <= 0 || !result_count) {
+        if (result_count) *result_count = 0;
+        LOG_ERROR("Invalid input for soa_lum_split");
+        return NULL;
+    }
+
+    LUMGroup** result = (LUMGroup**)malloc(sizeof(LUMGroup*) * zones);
+    if (!result) {
+        *result_count = 0;
+        LOG_ERROR("Memory allocation failed for split result array");
+        return NULL;
+    }
+
+    size_t lums_per_zone = source->count / zones;
+    size_t remainder = source->count % zones;
+    size_t current_index = 0;
+
+    for (int i = 0; i < zones; i++) {
+        size_t zone_count = lums_per_zone + ((size_t)i < remainder ? 1 : 0);
+
+        result[i] = create_soa_lum_group(zone_count, GROUP_LINEAR);
+        if (!result[i] || soa_copy_spatial(result[i], 0, source, current_index, zone_count) != 0) {
+            LOG_ERROR("Failed to create SoA LUM group for zone %d", i);
+            free_split_result(result, (size_t)i + (result[i] ? 1 : 0));
+            *result_count = 0;
+            return NULL;
+        }
+
+        if (zone_count > 0) {
+            memcpy(result[i]->soa->presence, source->soa->presence + current_index, zone_count);
+            memset(result[i]->soa->structure_type, LUM_LINEAR, zone_count);
+        }
+        result[i]->layout = lum_layout_linear(0, i * 50, 20);
+        current_index += zone_count;
+    }
+
+    *result_count = zones;
+    return result;
+}
+
+/**
+ * SoA Cycle (⟲): keeps a column prefix laid out on a circle
+ */
+LUMGroup* soa_lum_cycle(LUMGroup* source, int modulo) {
+    if (!source || !source->soa || modulo <= 0) {
+        LOG_ERROR("Invalid input for soa_lum_cycle");
+        return NULL;
+    }
+
+    size_t result_count_raw = source->count % modulo;
+
+    if (result_count_raw == 0) {
+        // Single present LUM at the origin, as in the dense cycle
+        LUMGroup* result = create_soa_lum_group(1, GROUP_NODE);
+        if (!result) {
+            return NULL;
+        }
+        result->soa->presence[0] = 1;
+        result->soa->structure_type[0] = LUM_CYCLE;
+        return result;
+    }
+
+    LUMGroup* result = create_soa_lum_group(result_count_raw, GROUP_NODE);
+    if (!result || soa_copy_spatial(result, 0, source, 0, result_count_raw) != 0) {
+        LOG_ERROR("Memory allocation failed for %zu LUMs in soa_lum_cycle", result_count_raw);
+        free_lum_group(result);
+        return NULL;
+    }
+
+    memcpy(result->soa->presence, source->soa->presence, result_count_raw);
+    memset(result->soa->structure_type, LUM_CYCLE, result_count_raw);
+    result->layout = lum_layout_circle(50, 50, 30, result_count_raw);
+
+    return result;
+}
+
+/**
+ * SoA Flow (→): copies the columns and moves the layout offset by 100
+ */
+LUMGroup* soa_lum_flow(LUMGroup* source, const char* target_zone) {
+    if (!source || !source->soa || !target_zone) {
+        LOG_ERROR("Invalid input for soa_lum_flow");
+        return NULL;
+    }
+
+    LUMGroup* result = soa_clone(source);
+    if (!result) {
+        LOG_ERROR("Failed to create LUM group for SoA flow operation");
+        return NULL;
+    }
+
+    if (result->count > 0) {
+        memset(result->soa->structure_type, LUM_LINEAR, result->count); // Reset to linear for flow
+    }
+    lum_group_translate(result, 100, 0);
+
+    char* target = (char*)malloc(strlen(target_zone) + 1);
+    if (target) {
+        strcpy(target, target_zone);
+        result->spatial_data = target;
+    } else {
+        LOG_ERROR("Memory allocation failed for spatial_data in soa_lum_flow");
+    }
+
+    return result;
+}
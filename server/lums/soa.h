@@ -0,0 +1,29 @@
+#ifndef SOA_H
+#define SOA_H
+
+#include "lums.h"
+
+// Structure-of-arrays group management
+LUMGroup* create_soa_lum_group(size_t count, GroupType type);
+LUMGroup* soa_from_dense(const LUMGroup* source);
+LUMGroup* soa_to_dense(const LUMGroup* source);
+LUMGroup* soa_clone(const LUMGroup* source);
+void free_soa_storage(LumSoaStorage* soa);
+int lum_group_to_soa(LUMGroup* group);
+int lum_group_from_soa(LUMGroup* group);
+
+// Element access
+int soa_get_lum(const LUMGroup* group, size_t index, LUM* out);
+int soa_expand(const LUMGroup* group, LUM* out);
+
+// Column kernels (same results as validate_lums / lum_contextual_split on the dense form)
+int soa_validate(const LUMGroup* group);
+LUMGroup** soa_contextual_split(LUMGroup* source, size_t* result_count);
+
+// SoA VORAX operations (dispatched from operations.c, dense operands accepted)
+LUMGroup* soa_lum_fusion(LUMGroup* group1, LUMGroup* group2);
+LUMGroup** soa_lum_split(LUMGroup* source, int zones, size_t* result_count);
+LUMGroup* soa_lum_cycle(LUMGroup* source, int modulo);
+LUMGroup* soa_lum_flow(LUMGroup* source, const char* target_zone);
+
+#endif // SOA_H
@@ -0,0 +1,226 @@
+#define _POSIX_C_SOURCE 200112L
+#include "lums.h"
+#include "stream.h"
+#include "packed.h"
+#include "layout.h"
+#include "simd_codec.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifndef LOG_ERROR
+#define LOG_ERROR(...) fprintf(stderr, "ERROR: " __VA_ARGS__); fprintf(stderr, "\n")
+#endif
+
+static size_t page_size(void) {
+    long size = sysconf(_SC_PAGESIZE);
+    return size > 0 ? (size_t)size : 4096;
+}
+
+static LumEncodeStream* stream_create(size_t chunk_bytes) {
+    if (chunk_bytes == 0 || chunk_bytes > SIZE_MAX / 8) {
+        return NULL;
+    }
+
+    LumEncodeStream* stream = (LumEncodeStream*)calloc(1, sizeof(LumEncodeStream));
+    if (!stream) {
+        LOG_ERROR("Memory allocation failed for encode stream");
+        return NULL;
+    }
+
+    stream->fd = -1;
+    stream->chunk_bytes = chunk_bytes;
+    stream->chunk = create_packed_lum_group(chunk_bytes * 8, GROUP_LINEAR);
+    if (!stream->chunk) {
+        free(stream);
+        return NULL;
+    }
+    stream->chunk->layout = lum_layout_grid(0, 0, 20, 32, 30); // Same grid as encode_array
+    return stream;
+}
+
+LumEncodeStream* lum_stream_open_fd(int fd, size_t chunk_bytes) {
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        return NULL;
+    }
+
+    LumEncodeStream* stream = stream_create(chunk_bytes);
+    if (!stream) {
+        return NULL;
+    }
+    stream->fd = fd;
+
+    // Regular files are mapped chunk by chunk, anything else is read into one buffer
+    if (S_ISREG(info.st_mode) && info.st_size > 0) {
+        stream->use_mmap = 1;
+        stream->size = (size_t)info.st_size;
+        return stream;
+    }
+
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    stream->buffer = (uint8_t*)malloc(chunk_bytes);
+    if (!stream->buffer) {
+        LOG_ERROR("Memory allocation failed for %zu byte stream buffer", chunk_bytes);
+        lum_stream_close(stream);
+        return NULL;
+    }
+    return stream;
+}
+
+LumEncodeStream* lum_stream_open_memory(const void* data, size_t size, size_t chunk_bytes) {
+    if (!data && size > 0) {
+        return NULL;
+    }
+
+    LumEncodeStream* stream = stream_create(chunk_bytes);
+    if (!stream) {
+        return NULL;
+    }
+    stream->data = (const uint8_t*)data;
+    stream->size = size;
+
+    // Only a hint: fails harmlessly on memory that is not a mapping
+    if (size > 0) {
+        uintptr_t start = (uintptr_t)data - (uintptr_t)data % page_size();
+        posix_madvise((void*)start, (uintptr_t)data + size - start, POSIX_MADV_SEQUENTIAL);
+    }
+    return stream;
+}
+
+/**
+ * Read one chunk from a pipe or socket, short reads are retried until
+ * the chunk is full or the input ends
+ */
+static size_t stream_read(LumEncodeStream* stream) {
+    size_t filled = 0;
+
+    while (filled < stream->chunk_bytes) {
+        ssize_t n = read(stream->fd, stream->buffer + filled, stream->chunk_bytes - filled);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            stream->error = errno;
+            return 0;
+        }
+        if (n == 0) {
+            break;
+        }
+        filled += (size_t)n;
+    }
+    return filled;
+}
+
+/**
+ * Map the next chunk of a regular file, encode it and unmap it again, so
+ * at most one chunk of the file is resident through the stream
+ */
+static int stream_encode_mapped(LumEncodeStream* stream, size_t length, uint64_t* words) {
+    size_t lead = stream->offset % page_size();
+    size_t map_length = lead + length;
+
+    void* map = mmap(NULL, map_length, PROT_READ, MAP_PRIVATE, stream->fd, (off_t)(stream->offset - lead));
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+    posix_madvise(map, map_length, POSIX_MADV_SEQUENTIAL);
+    lum_bytes_to_words((const uint8_t*)map + lead, length, words);
+    munmap(map, map_length);
+    return 0;
+}
+
+const LUMGroup* lum_stream_next(LumEncodeStream* stream) {
+    if (!stream || stream->error) {
+        return NULL;
+    }
+
+    LUMGroup* chunk = stream->chunk;
+    uint64_t* words = chunk->packed->words;
+    size_t length;
+
+    if (stream->fd < 0 || stream->use_mmap) {
+        if (stream->offset >= stream->size) {
+            return NULL;
+        }
+        length = stream->size - stream->offset < stream->chunk_bytes ?
+                 stream->size - stream->offset : stream->chunk_bytes;
+
+        if (stream->fd < 0) {
+            lum_bytes_to_words(stream->data + stream->offset, length, words);
+        } else if (stream_encode_mapped(stream, length, words) != 0) {
+            // Files that cannot be mapped fall back to plain reads from here on
+            stream->use_mmap = 0;
+            stream->buffer = (uint8_t*)malloc(stream->chunk_bytes);
+            if (!stream->buffer || lseek(stream->fd, (off_t)stream->offset, SEEK_SET) < 0) {
+                stream->error = stream->buffer ? errno : ENOMEM;
+                return NULL;
+            }
+            return lum_stream_next(stream);
+        }
+    } else {
+        length = stream_read(stream);
+        if (length == 0) {
+            return NULL;
+        }
+        lum_bytes_to_words(stream->buffer, length, words);
+    }
+
+    // The last chunk is shorter, its trailing words are simply not counted
+    chunk->count = length * 8;
+    chunk->packed->word_count = (length + 7) / 8;
+    stream->offset += length;
+    stream->chunk_index++;
+    return chunk;
+}
+
+void lum_stream_close(LumEncodeStream* stream) {
+    if (!stream) {
+        return;
+    }
+    free_lum_group(stream->chunk);
+    free(stream->buffer);
+    free(stream);
+}
+
+/**
+ * Drive an opened stream through sink, closing it in every case
+ */
+static int stream_drain(LumEncodeStream* stream, LumEncodeSink sink, void* context) {
+    if (!stream) {
+        return -1;
+    }
+
+    int status = 0;
+    const LUMGroup* chunk;
+    while (status == 0 && (chunk = lum_stream_next(stream)) != NULL) {
+        status = sink(chunk, stream->chunk_index - 1, context);
+    }
+    if (status == 0 && stream->error) {
+        status = -1;
+    }
+
+    lum_stream_close(stream);
+    return status;
+}
+
+int encode_stream_fd(int fd, size_t chunk_bytes, LumEncodeSink sink, void* context) {
+    if (!sink) {
+        return -1;
+    }
+    return stream_drain(lum_stream_open_fd(fd, chunk_bytes), sink, context);
+}
+
+int encode_stream_memory(const void* data, size_t size, size_t chunk_bytes,
+                         LumEncodeSink sink, void* context) {
+    if (!sink) {
+        return -1;
+    }
+    return stream_drain(lum_stream_open_memory(data, size, chunk_bytes), sink, context);
+}
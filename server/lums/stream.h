@@ -0,0 +1,37 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include "lums.h"
+
+// Chunked encoding of inputs larger than memory: every chunk is a packed
+// group of chunk_bytes * 8 LUMs (the last one shorter), laid out like
+// encode_array_packed on that slice of the input
+typedef struct {
+    int fd;                  // -1 for memory sources
+    const uint8_t* data;     // Memory source
+    size_t size;             // Input size, 0 for descriptors read to EOF
+    size_t offset;           // Input bytes consumed
+    size_t chunk_bytes;
+    size_t chunk_index;      // Chunks produced so far
+    int use_mmap;            // Regular files: one short-lived mapping per chunk
+    uint8_t* buffer;         // Reused read buffer for pipes and sockets
+    LUMGroup* chunk;         // Reused for every chunk
+    int error;               // errno of the failure, 0 if none
+} LumEncodeStream;
+
+LumEncodeStream* lum_stream_open_fd(int fd, size_t chunk_bytes);
+// data may be an mmap'd region, it is only hinted for sequential access
+LumEncodeStream* lum_stream_open_memory(const void* data, size_t size, size_t chunk_bytes);
+// Next chunk, owned by the stream and overwritten by the next call.
+// NULL at end of input or on error (stream->error set).
+const LUMGroup* lum_stream_next(LumEncodeStream* stream);
+void lum_stream_close(LumEncodeStream* stream);
+
+// Receives each chunk in order; a nonzero return stops encoding
+typedef int (*LumEncodeSink)(const LUMGroup* chunk, size_t chunk_index, void* context);
+// 0 once the whole input was encoded, the sink's status if it stopped, -1 on error
+int encode_stream_fd(int fd, size_t chunk_bytes, LumEncodeSink sink, void* context);
+int encode_stream_memory(const void* data, size_t size, size_t chunk_bytes,
+                         LumEncodeSink sink, void* context);
+
+#endif // STREAM_H
@@ -0,0 +1,367 @@
+#include "lums.h"
+#include "view.h"
+#include "reduce.h"
+#include "layout.h"
+#include "packed.h"
+#include "compact.h"
+#include "soa.h"
+#include "hybrid.h"
+#include "arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef LOG_ERROR
+#define LOG_ERROR(...) fprintf(stderr, "ERROR: " __VA_ARGS__); fprintf(stderr, "\n")
+#endif
+
+// Buffer and its copy of inline LUMs in one block
+typedef struct {
+    LumBuffer buffer;
+    LUM lums[];
+} LumInlineBuffer;
+
+/**
+ * Buffer with room for inline_count LUMs, from arena if not NULL
+ */
+static LumBuffer* buffer_create(LumArena* arena, size_t inline_count) {
+    size_t size = sizeof(LumInlineBuffer) + sizeof(LUM) * inline_count;
+    LumInlineBuffer* block = (LumInlineBuffer*)(arena ? lum_arena_alloc(arena, size) : malloc(size));
+    if (!block) {
+        LOG_ERROR("Memory allocation failed for LUM buffer");
+        return NULL;
+    }
+    memset(&block->buffer, 0, sizeof(LumBuffer));
+    block->buffer.refcount = 1;
+    block->buffer.arena = arena;
+    return &block->buffer;
+}
+
+static void buffer_free(LumBuffer* buffer) {
+    if (buffer->arena) {
+        lum_arena_free(buffer->arena, buffer);
+    } else {
+        free(buffer);
+    }
+}
+
+LumBuffer* lum_buffer_wrap(LUM* lums, size_t count, void (*release)(void*), void* context) {
+    LumBuffer* buffer = buffer_create(NULL, 0);
+    if (!buffer) {
+        return NULL;
+    }
+    buffer->lums = lums;
+    buffer->count = count;
+    buffer->release = release;
+    buffer->context = context;
+    return buffer;
+}
+
+void lum_buffer_retain(LumBuffer* buffer) {
+    if (buffer) {
+        __atomic_add_fetch(&buffer->refcount, 1, __ATOMIC_RELAXED);
+    }
+}
+
+void lum_buffer_release(LumBuffer* buffer) {
+    // Acquire-release: the last holder sees every write made before the others let go
+    if (!buffer || __atomic_sub_fetch(&buffer->refcount, 1, __ATOMIC_ACQ_REL) > 0) {
+        return;
+    }
+    if (buffer->release) {
+        buffer->release(buffer->context);
+    } else if (!buffer->lums_inline) {
+        free(buffer->lums);
+    }
+    free_packed_storage(buffer->packed);
+    free_compact_storage(buffer->compact);
+    free_soa_storage(buffer->soa);
+    free_hybrid_storage(buffer->hybrid);
+    buffer_free(buffer);
+}
+
+/**
+ * 1 if no other group can reach the buffer
+ */
+static int buffer_is_exclusive(LumBuffer* buffer) {
+    return __atomic_load_n(&buffer->refcount, __ATOMIC_ACQUIRE) == 1;
+}
+
+/**
+ * Owner as published by lum_group_share, which may run on another thread
+ */
+static LumBuffer* group_owner(const LUMGroup* group) {
+    return __atomic_load_n(&group->owner, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Shared LUMs of group: inline ones stay in the header, the buffer holds their copy
+ */
+static LUM* shared_lums(const LUMGroup* group, const LumBuffer* owner) {
+    return group->lums_inline ? owner->lums : group->lums;
+}
+
+/**
+ * Caller memory that outlives every view needs no release
+ */
+static void keep_borrowed(void* context) {
+    (void)context;
+}
+
+/**
+ * Cleared group header, from the thread's current arena if any (like lum_group_alloc)
+ */
+static LUMGroup* header_create(void) {
+    LumArena* arena = lum_arena_current();
+    LUMGroup* group = (LUMGroup*)(arena ? lum_arena_alloc(arena, sizeof(LUMGroup)) : malloc(sizeof(LUMGroup)));
+    if (!group) {
+        LOG_ERROR("Memory allocation failed for LUMGroup header");
+        return NULL;
+    }
+    memset(group, 0, sizeof(LUMGroup));
+    group->arena = arena;
+    return group;
+}
+
+/**
+ * Dense group over count LUMs at first, holding one reference on buffer
+ */
+static LUMGroup* view_create(LumBuffer* buffer, LUM* first, size_t count, GroupType type) {
+    LUMGroup* view = header_create();
+    if (!view) {
+        return NULL;
+    }
+    lum_buffer_retain(buffer);
+    view->lums = first;
+    view->count = count;
+    view->group_type = type;
+    view->storage = LUM_STORAGE_DENSE;
+    view->layout = lum_layout_explicit();
+    view->owner = buffer;
+    return view;
+}
+
+int lum_group_share(LUMGroup* group) {
+    if (!group) {
+        return -1;
+    }
+    if (group_owner(group)) {
+        return 0;
+    }
+    // Shared LUMs may outlive the group, so the buffer gets its own copy of
+    // inline ones, from the current arena like the clone headers. The group
+    // itself is left untouched: concurrent clones only race on installing the owner.
+    LumBuffer* buffer = buffer_create(lum_arena_current(), group->lums_inline ? group->count : 0);
+    if (!buffer) {
+        return -1;
+    }
+    if (group->lums_inline) {
+        buffer->lums = ((LumInlineBuffer*)buffer)->lums;
+        buffer->lums_inline = 1;
+        memcpy(buffer->lums, group->lums, sizeof(LUM) * group->count);
+    } else {
+        buffer->lums = group->lums;
+    }
+    buffer->count = group->count;
+    buffer->packed = group->packed;
+    buffer->compact = group->compact;
+    buffer->soa = group->soa;
+    buffer->hybrid = group->hybrid;
+
+    // The group keeps the initial reference; a thread that lost the race drops its buffer
+    LumBuffer* expected = NULL;
+    if (!__atomic_compare_exchange_n(&group->owner, &expected, buffer, 0,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        buffer_free(buffer);
+    }
+    return 0;
+}
+
+LUMGroup* lum_group_clone_cow(LUMGroup* source) {
+    if (!source || lum_group_share(source) != 0) {
+        return NULL;
+    }
+
+    LUMGroup* clone = header_create();
+    if (!clone) {
+        return NULL;
+    }
+    LumBuffer* owner = group_owner(source);
+    lum_buffer_retain(owner);
+    clone->lums = shared_lums(source, owner);
+    clone->count = source->count;
+    clone->group_type = source->group_type;
+    clone->storage = source->storage;
+    clone->packed = source->packed;
+    clone->compact = source->compact;
+    clone->soa = source->soa;
+    clone->hybrid = source->hybrid;
+    clone->layout = source->layout;
+    clone->owner = owner;
+    clone->hash_sum = source->hash_sum;
+    clone->hash_cached = source->hash_cached;
+    return clone;
+}
+
+LUMGroup* lum_group_borrow_range(LUMGroup* source, size_t start, size_t count, GroupType type) {
+    if (!source || source->storage != LUM_STORAGE_DENSE ||
+        start > source->count || count > source->count - start ||
+        (!source->lums && source->count > 0) || lum_group_share(source) != 0) {
+        return NULL;
+    }
+    LumBuffer* owner = group_owner(source);
+    return view_create(owner, shared_lums(source, owner) + start, count, type);
+}
+
+LUMGroup* lum_group_view(LUMGroup* source, size_t start, size_t count) {
+    if (!source || start > source->count || count > source->count - start) {
+        return NULL;
+    }
+
+    LumLayout sliced;
+    if (lum_layout_slice(&source->layout, start, &sliced) == 0) {
+        LUMGroup* view = lum_group_borrow_range(source, start, count, source->group_type);
+        if (view) {
+            view->layout = sliced;
+        }
+        return view;
+    }
+
+    // Circle / spiral phases cannot be shifted: copy with positions written out
+    if (source->storage != LUM_STORAGE_DENSE || (!source->lums && count > 0)) {
+        return NULL;
+    }
+    LUMGroup* copy = lum_group_copy(count > 0 ? source->lums + start : NULL, count, source->group_type);
+    if (!copy) {
+        LOG_ERROR("Memory allocation failed copying %zu LUMs", count);
+        return NULL;
+    }
+    lum_layout_fill(&source->layout, start, count, copy->lums);
+    return copy;
+}
+
+LUMGroup* lum_group_borrow(LUM* lums, size_t count, GroupType type,
+                           void (*release)(void*), void* context) {
+    if (!lums && count > 0) {
+        return NULL;
+    }
+
+    LumBuffer* buffer = lum_buffer_wrap(lums, count, release ? release : keep_borrowed, context);
+    if (!buffer) {
+        return NULL;
+    }
+    LUMGroup* view = view_create(buffer, lums, count, type);
+    lum_buffer_release(buffer); // The view holds the only reference
+    return view;
+}
+
+int lum_group_is_view(const LUMGroup* group) {
+    return group && group_owner(group) != NULL;
+}
+
+/**
+ * Replace group's shared backend struct by a deep copy
+ */
+static int detach_backend(LUMGroup* group) {
+    LUMGroup* copy;
+    switch (group->storage) {
+        case LUM_STORAGE_PACKED: copy = packed_clone(group); break;
+        case LUM_STORAGE_COMPACT: copy = compact_clone(group); break;
+        case LUM_STORAGE_SOA: copy = soa_clone(group); break;
+        case LUM_STORAGE_HYBRID: copy = hybrid_clone(group); break;
+        default: return -1;
+    }
+    if (!copy) {
+        return -1;
+    }
+
+    group->packed = copy->packed;
+    group->compact = copy->compact;
+    group->soa = copy->soa;
+    group->hybrid = copy->hybrid;
+    copy->packed = NULL;
+    copy->compact = NULL;
+    copy->soa = NULL;
+    copy->hybrid = NULL;
+    free_lum_group(copy);
+    return 0;
+}
+
+int lum_group_detach(LUMGroup* group) {
+    if (!group) {
+        return -1;
+    }
+    lum_group_touch(group); // Callers detach to write
+    LumBuffer* buffer = group->owner;
+    if (!buffer) {
+        return 0;
+    }
+
+    // Inline LUMs never left the header, only the buffer's copy was shared
+    if (group->lums_inline) {
+        lum_buffer_release(buffer);
+        group->owner = NULL;
+        return 0;
+    }
+
+    // Last holder of the whole storage: take it over instead of copying
+    if (buffer_is_exclusive(buffer) && !buffer->release && !buffer->lums_inline &&
+        group->lums == buffer->lums && group->count == buffer->count) {
+        buffer_free(buffer);
+        group->owner = NULL;
+        return 0;
+    }
+
+    if (group->storage != LUM_STORAGE_DENSE) {
+        if (detach_backend(group) != 0) {
+            return -1;
+        }
+        lum_buffer_release(buffer);
+        group->owner = NULL;
+        return 0;
+    }
+
+    LUM* lums = (LUM*)malloc(sizeof(LUM) * (group->count > 0 ? group->count : 1));
+    if (!lums) {
+        LOG_ERROR("Memory allocation failed detaching %zu LUMs", group->count);
+        return -1;
+    }
+    if (group->count > 0) {
+        memcpy(lums, group->lums, sizeof(LUM) * group->count);
+    }
+    lum_buffer_release(buffer);
+    group->lums = lums;
+    group->owner = NULL;
+    return 0;
+}
+
+LUM* lum_group_writable(LUMGroup* group) {
+    if (!group || group->storage != LUM_STORAGE_DENSE || lum_group_detach(group) != 0) {
+        return NULL;
+    }
+    return group->lums;
+}
+
+void lum_group_release_storage(LUMGroup* group) {
+    if (!group) {
+        return;
+    }
+    if (group->owner) {
+        lum_buffer_release(group->owner);
+        group->owner = NULL;
+    } else {
+        if (!group->lums_inline) {
+            free(group->lums);
+        }
+        free_packed_storage(group->packed);
+        free_compact_storage(group->compact);
+        free_soa_storage(group->soa);
+        free_hybrid_storage(group->hybrid);
+    }
+    group->lums = NULL;
+    group->packed = NULL;
+    group->compact = NULL;
+    group->soa = NULL;
+    group->hybrid = NULL;
+    group->lums_inline = 0;
+}
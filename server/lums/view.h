@@ -0,0 +1,37 @@
+#ifndef VIEW_H
+#define VIEW_H
+
+#include "lums.h"
+
+// Shared buffers (release NULL: the buffer frees lums itself)
+LumBuffer* lum_buffer_wrap(LUM* lums, size_t count, void (*release)(void*), void* context);
+void lum_buffer_retain(LumBuffer* buffer);
+void lum_buffer_release(LumBuffer* buffer);
+
+// Zero-copy views and copy-on-write clones, read-only until detached.
+// Their headers, and the buffer a group gets when first shared, come from the
+// thread's current arena if any (like lum_group_alloc): a clone outlives an
+// arena reset only if neither was made under it.
+// Moves a group's storage into a shared buffer, O(1), no-op if already shared
+int lum_group_share(LUMGroup* group);
+// O(1) clone sharing the source storage, any backend
+LUMGroup* lum_group_clone_cow(LUMGroup* source);
+// View of LUMs [start, start + count) as stored (explicit layout, LUM positions kept)
+LUMGroup* lum_group_borrow_range(LUMGroup* source, size_t start, size_t count, GroupType type);
+// Same LUMs and positions as the source range; copies only when the layout cannot be sliced
+LUMGroup* lum_group_view(LUMGroup* source, size_t start, size_t count);
+// View over caller memory, release(context) runs once the last view is freed (may be NULL)
+LUMGroup* lum_group_borrow(LUM* lums, size_t count, GroupType type,
+                           void (*release)(void*), void* context);
+int lum_group_is_view(const LUMGroup* group);
+// Private copy of shared storage, required before writing to it
+// (takes the storage over without copying when no other group holds it).
+// Drops the cached content hash: the caller is about to write.
+int lum_group_detach(LUMGroup* group);
+// Dense LUMs ready for writing: detaches shared storage first, NULL on failure.
+// Every write to lums[] goes through it (or lum_group_detach).
+LUM* lum_group_writable(LUMGroup* group);
+// Free or unreference every backend of group (in-place storage changes go through this)
+void lum_group_release_storage(LUMGroup* group);
+
+#endif // VIEW_H
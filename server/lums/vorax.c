@@ -3,6 +3,10 @@
 #include "encoder.h"
 #include "decoder.h"
 #include "operations.h"
+#include "layout.h"
+#include "view.h"
+#include "reduce.h"
+#include "dedup.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -23,6 +27,7 @@ VoraxEngine* create_vorax_engine(void) {
     engine->zone_count = 0;
     engine->memory_slots = NULL;
     engine->memory_count = 0;
+    engine->memory_index = lum_dedup_create(); // Without it slots just never share
     engine->last_error = NULL; // Initialize last_error to NULL
 
     // Initialize error_message buffer
@@ -60,6 +65,7 @@ void free_vorax_engine(VoraxEngine* engine) {
     if (engine->memory_slots) {
         free(engine->memory_slots);
     }
+    lum_dedup_free(engine->memory_index);
 
     // Free error message
     if (engine->last_error) {
@@ -137,6 +143,20 @@ int vorax_set_zone_group(VoraxEngine* engine, const char* zone_name, LUMGroup* g
     return -2; // Zone not found
 }
 
+/**
+ * Detach a zone's group without freeing it, NULL if none
+ */
+static LUMGroup* vorax_take_zone_group(VoraxEngine* engine, const char* zone_name) {
+    for (size_t i = 0; i < engine->zone_count; i++) {
+        if (engine->zones[i].name && strcmp(engine->zones[i].name, zone_name) == 0) {
+            LUMGroup* group = engine->zones[i].group;
+            engine->zones[i].group = NULL;
+            return group;
+        }
+    }
+    return NULL;
+}
+
 /**
  * Get LUM group from a zone
  */
@@ -156,6 +176,33 @@ LUMGroup* vorax_get_zone_group(VoraxEngine* engine, const char* zone_name) {
     return NULL; // Zone not found
 }
 
+/**
+ * Copy of group for a memory slot. Slots holding the same LUMs share one
+ * storage, found through the engine's content index.
+ */
+static LUMGroup* vorax_memory_copy(VoraxEngine* engine, LUMGroup* group) {
+    LUMGroup* stored = lum_dedup_find(engine->memory_index, group);
+    LUMGroup* copy = stored ? clone_lum_group(stored) : NULL;
+    if (copy) {
+        copy->group_type = group->group_type;
+    } else {
+        copy = clone_lum_group(group);
+    }
+    // Every slot is indexed: its LUMs stay found when the others are replaced
+    if (copy) {
+        lum_dedup_add(engine->memory_index, copy);
+    }
+    return copy;
+}
+
+/**
+ * Frees the group of a memory slot and its index entry
+ */
+static void vorax_memory_release(VoraxEngine* engine, LUMGroup* stored) {
+    lum_dedup_remove(engine->memory_index, stored);
+    free_lum_group(stored);
+}
+
 /**
  * Store LUM group in memory
  */
@@ -168,9 +215,10 @@ int vorax_store_memory(VoraxEngine* engine, const char* name, LUMGroup* group) {
     // Check if memory slot already exists
     for (size_t i = 0; i < engine->memory_count; i++) {
         if (engine->memory_slots[i].name && strcmp(engine->memory_slots[i].name, name) == 0) {
-            // Replace existing
-            free_lum_group(engine->memory_slots[i].stored_group);
-            engine->memory_slots[i].stored_group = clone_lum_group(group);
+            // Replace existing (copied first: it may share the old group's storage)
+            LUMGroup* stored = vorax_memory_copy(engine, group);
+            vorax_memory_release(engine, engine->memory_slots[i].stored_group);
+            engine->memory_slots[i].stored_group = stored;
             engine->memory_slots[i].timestamp = time(NULL);
             return 0;
         }
@@ -194,7 +242,7 @@ int vorax_store_memory(VoraxEngine* engine, const char* name, LUMGroup* group) {
     }
     strcpy(slot->name, name);
 
-    slot->stored_group = clone_lum_group(group);
+    slot->stored_group = vorax_memory_copy(engine, group);
     slot->timestamp = time(NULL);
 
     engine->memory_count++;
@@ -212,6 +260,7 @@ LUMGroup* vorax_retrieve_memory(VoraxEngine* engine, const char* name) {
 
     for (size_t i = 0; i < engine->memory_count; i++) {
         if (engine->memory_slots[i].name && strcmp(engine->memory_slots[i].name, name) == 0) {
+            // O(1), the slot and the caller share storage until one of them writes
             return clone_lum_group(engine->memory_slots[i].stored_group);
         }
     }
@@ -249,14 +298,12 @@ int vorax_execute_operation(VoraxEngine* engine, const char* operation,
             return -4;
         }
 
-        LUMGroup* result = lum_fusion(source_group, target_group);
-        if (!result) {
+        // Target appended to the source zone's group, no copy of the source
+        if (lum_fusion_append(source_group, target_group) != 0) {
             vorax_set_error(engine, "Fusion operation failed.");
             return -5;
         }
 
-        // Replace source zone with result
-        vorax_set_zone_group(engine, source_zone, result);
         // Clear target zone
         vorax_set_zone_group(engine, target_zone, NULL);
 
@@ -306,29 +353,25 @@ int vorax_execute_operation(VoraxEngine* engine, const char* operation,
         int* modulo_param = (int*)parameters;
         int modulo = modulo_param ? *modulo_param : 3;
 
-        LUMGroup* result = lum_cycle(source_group, modulo);
-        if (!result) {
+        if (lum_cycle_inplace(source_group, modulo) != 0) {
             vorax_set_error(engine, "Cycle operation failed.");
             return -5;
         }
 
-        vorax_set_zone_group(engine, source_zone, result);
-
     } else if (strcmp(operation, "flow") == 0 || strcmp(operation, "→") == 0) {
         if (!target_zone) {
             vorax_set_error(engine, "Target zone not provided for flow.");
             return -3;
         }
 
-        LUMGroup* result = lum_flow(source_group, target_zone);
-        if (!result) {
+        if (lum_flow_inplace(source_group, target_zone) != 0) {
             vorax_set_error(engine, "Flow operation failed.");
             return -5;
         }
 
-        vorax_set_zone_group(engine, target_zone, result);
-        // Clear source zone
-        vorax_set_zone_group(engine, source_zone, NULL);
+        // The group itself moves: clear the source zone without freeing it
+        vorax_take_zone_group(engine, source_zone);
+        vorax_set_zone_group(engine, target_zone, source_group);
 
     } else {
         vorax_set_error(engine, "Unknown operation specified.");
@@ -491,119 +534,6 @@ void vorax_set_error(VoraxEngine* engine, const char* error_msg) {
     }
 }
 
-/**
- * Utility functions
- */
-LUMGroup* create_lum_group(LUM* lums, size_t count, GroupType type) {
-    LUMGroup* group = (LUMGroup*)malloc(sizeof(LUMGroup));
-    if (!group) {
-        return NULL;
-    }
-
-    group->lums = lums;
-    group->count = count;
-    group->group_type = type;
-    group->connections = NULL;
-    group->connection_count = 0;
-    group->spatial_data = NULL;
-
-    // Generate truly unique ID using UUID v4 algorithm
-    group->id = (char*)malloc(37); // UUID standard length + null terminator
-    if (group->id) {
-        // Generate cryptographically secure UUID v4
-        uint8_t uuid_bytes[16];
-
-        // Use cryptographically secure random source
-        FILE* urandom = fopen("/dev/urandom", "rb");
-        if (urandom) {
-            if (fread(uuid_bytes, 1, 16, urandom) != 16) {
-                // Fallback to time-based if urandom fails
-                struct timespec ts;
-                clock_gettime(CLOCK_MONOTONIC, &ts);
-                unsigned int seed = (unsigned int)(ts.tv_sec ^ ts.tv_nsec ^ getpid());
-                srand(seed);
-                for (int i = 0; i < 16; i++) {
-                    uuid_bytes[i] = (uint8_t)(rand() % 256);
-                }
-            }
-            fclose(urandom);
-        } else {
-            // Fallback to time-based
-            struct timespec ts;
-            clock_gettime(CLOCK_MONOTONIC, &ts);
-            unsigned int seed = (unsigned int)(ts.tv_sec ^ ts.tv_nsec ^ getpid());
-            srand(seed);
-            for (int i = 0; i < 16; i++) {
-                uuid_bytes[i] = (uint8_t)(rand() % 256);
-            }
-        }
-
-        // Set version (4) and variant bits according to RFC 4122
-        uuid_bytes[6] = (uuid_bytes[6] & 0x0F) | 0x40; // Version 4
-        uuid_bytes[8] = (uuid_bytes[8] & 0x3F) | 0x80; // Variant 10
-
-        snprintf(group->id, 37, "%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
-                uuid_bytes[0], uuid_bytes[1], uuid_bytes[2], uuid_bytes[3],
-                uuid_bytes[4], uuid_bytes[5], uuid_bytes[6], uuid_bytes[7],
-                uuid_bytes[8], uuid_bytes[9], uuid_bytes[10], uuid_bytes[11],
-                uuid_bytes[12], uuid_bytes[13], uuid_bytes[14], uuid_bytes[15]);
-    }
-
-    return group;
-}
-
-LUMGroup* clone_lum_group(LUMGroup* source) {
-    if (!source || !source->lums) {
-        return NULL;
-    }
-
-    LUM* cloned_lums = (LUM*)malloc(sizeof(LUM) * source->count);
-    if (!cloned_lums) {
-        return NULL;
-    }
-
-    memcpy(cloned_lums, source->lums, sizeof(LUM) * source->count);
-
-    return create_lum_group(cloned_lums, source->count, source->group_type);
-}
-
-int compare_lum_groups(LUMGroup* group1, LUMGroup* group2) {
-    if (!group1 || !group2) {
-        return group1 == group2 ? 0 : -1;
-    }
-
-    if (group1->count != group2->count) {
-        return (int)(group1->count - group2->count);
-    }
-
-    for (size_t i = 0; i < group1->count; i++) {
-        if (group1->lums[i].presence != group2->lums[i].presence) {
-            return group1->lums[i].presence - group2->lums[i].presence;
-        }
-    }
-
-    return 0; // Equal
-}
-
-void print_lum_group(LUMGroup* group) {
-    if (!group) {
-        printf("NULL group\n");
-        return;
-    }
-
-    printf("LUM Group [%s]: %zu LUMs, Type: %d\n",
-           group->id ? group->id : "unknown",
-           group->count,
-           group->group_type);
-
-    for (size_t i = 0; i < group->count && i < 20; i++) {
-        printf("%s", group->lums[i].presence ? "•" : "○");
-    }
-    if (group->count > 20) {
-        printf("...");
-    }
-    printf("\n");
-}
 
 
 // --- VORAX VM Implementation ---
@@ -660,13 +590,12 @@ int vorax_fuse_zones(VoraxEngine* engine, int zone1, int zone2) {
     memcpy(fused_lums + g1->count, g2->lums, sizeof(LUM) * g2->count);
 
     // Update zone1 with fused result
-    free(g1->lums);
+    lum_group_release_storage(g1);
     g1->lums = fused_lums;
     g1->count = total_count;
 
     // Clear zone2
-    free(g2->lums);
-    g2->lums = NULL;
+    lum_group_release_storage(g2);
     g2->count = 0;
 
     engine->current_tick++;
@@ -723,7 +652,7 @@ int vorax_cycle_zone(VoraxEngine* engine, int zone, int modulo) {
             memcpy(new_lums, group->lums, sizeof(LUM) * new_count);
         }
 
-        free(group->lums);
+        lum_group_release_storage(group);
         group->lums = new_lums;
         group->count = new_count;
     }
@@ -12,6 +12,7 @@
 #include <sys/time.h>
 #include <cjson/cJSON.h>
 #include "lums/lums_backend.h"
+#include "lums/arena.h"
 
 // Configuration serveur
 #define PORT 8080
@@ -330,7 +331,14 @@ void* client_handler(void* arg) {
             char* body = body_start ? body_start + 4 : "";
             
             total_requests++;
+            
+            // Groups built for the request come from one arena, released in one shot
+            // (it allocates no chunk until a route builds a group)
+            LumArena* arena = lum_arena_create(0);
+            LumArena* previous = lum_arena_use(arena);
             route_request(client->socket_fd, method, path, body, client->request_id);
+            lum_arena_use(previous);
+            lum_arena_destroy(arena);
         } else {
             send_http_response(client->socket_fd, 400, "text/plain", "Bad Request");
         }
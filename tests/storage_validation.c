@@ -0,0 +1,2306 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <string.h>
+#include "../server/lums/lums.h"
+#include "../server/lums/encoder.h"
+#include "../server/lums/decoder.h"
+#include "../server/lums/operations.h"
+#include "../server/lums/packed.h"
+#include "../server/lums/simd_codec.h"
+#include "../server/lums/layout.h"
+#include "../server/lums/compact.h"
+#include "../server/lums/soa.h"
+#include "../server/lums/hybrid.h"
+#include "../server/lums/stream.h"
+#include "../server/lums/view.h"
+#include "../server/lums/arena.h"
+#include "../server/lums/rng.h"
+#include "../server/lums/pool.h"
+#include "../server/lums/reduce.h"
+#include "../server/lums/pipeline.h"
+#include "../server/lums/batch.h"
+#include "../server/lums/dedup.h"
+#include <math.h>
+#include <unistd.h>
+#include <pthread.h>
+
+// ===== TESTS STOCKAGE LUMGROUP =====
+
+// Compare un groupe dense et un groupe packed/compact/SoA LUM par LUM
+static int groups_match(LUMGroup* dense, LUMGroup* other) {
+    if (!dense || !other || dense->count != other->count) {
+        return 0;
+    }
+    for (size_t i = 0; i < dense->count; i++) {
+        LUM lum;
+        int x, y;
+        int got = other->storage == LUM_STORAGE_COMPACT ? compact_get_lum(other, i, &lum) :
+                  other->storage == LUM_STORAGE_SOA ? soa_get_lum(other, i, &lum) :
+                  other->storage == LUM_STORAGE_HYBRID ? hybrid_get_lum(other, i, &lum) :
+                  packed_get_lum(other, i, &lum);
+        if (got != 0 ||
+            lum_group_position(dense, i, &x, &y) != 0 ||
+            lum.presence != dense->lums[i].presence ||
+            lum.structure_type != dense->lums[i].structure_type ||
+            lum.position.x != x || lum.position.y != y) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Test encodage packed vs dense
+int test_packed_encoding() {
+    printf("   Test encodage packed...\n");
+
+    uint8_t payload[257];
+    for (size_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = (uint8_t)(i * 37 + 11);
+    }
+
+    LUMGroup* dense = encode_array(payload, 1, sizeof(payload));
+    LUMGroup* packed = encode_array_packed(payload, 1, sizeof(payload));
+    LUMGroup* dense_word = encode_to_lum_group(0xDEADBEEFCAFEULL, 51);
+    LUMGroup* packed_word = encode_to_packed_group(0xDEADBEEFCAFEULL, 51);
+
+    int ok = groups_match(dense, packed) && groups_match(dense_word, packed_word) &&
+             packed->packed->override_count == 0 &&
+             decode_lum_group(packed_word) == 0xDEADBEEFCAFEULL;
+
+    free_lum_group(dense);
+    free_lum_group(packed);
+    free_lum_group(dense_word);
+    free_lum_group(packed_word);
+
+    if (ok) {
+        printf("      ✅ Encodage packed identique au dense (%zu octets)\n", sizeof(payload));
+        return 1;
+    }
+    printf("      ❌ Encodage packed divergent\n");
+    return 0;
+}
+
+// Test opérations VORAX sur stockage packed
+int test_packed_operations() {
+    printf("   Test opérations VORAX packed...\n");
+
+    uint8_t payload[100];
+    for (size_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = (uint8_t)(i ^ 0x5A);
+    }
+
+    LUMGroup* dense_a = encode_to_lum_group(0x0123456789ABCDEFULL, 64);
+    LUMGroup* packed_a = encode_to_packed_group(0x0123456789ABCDEFULL, 64);
+    LUMGroup* dense_b = encode_array(payload, 1, sizeof(payload));
+    LUMGroup* packed_b = encode_array_packed(payload, 1, sizeof(payload));
+
+    LUMGroup* dense_fused = lum_fusion(dense_a, dense_b);
+    LUMGroup* packed_fused = lum_fusion(packed_a, packed_b);
+    int ok = groups_match(dense_fused, packed_fused);
+
+    size_t dense_zones = 0, packed_zones = 0;
+    LUMGroup** dense_split = lum_split(dense_fused, 5, &dense_zones);
+    LUMGroup** packed_split = lum_split(packed_fused, 5, &packed_zones);
+    ok = ok && dense_zones == packed_zones;
+    for (size_t i = 0; ok && i < dense_zones; i++) {
+        ok = groups_match(dense_split[i], packed_split[i]);
+    }
+
+    for (int modulo = 1; ok && modulo < 200; modulo += 7) {
+        LUMGroup* dense_cycle = lum_cycle(dense_fused, modulo);
+        LUMGroup* packed_cycle = lum_cycle(packed_fused, modulo);
+        ok = groups_match(dense_cycle, packed_cycle);
+        free_lum_group(dense_cycle);
+        free_lum_group(packed_cycle);
+    }
+
+    uint8_t dense_bytes[120], packed_bytes[120];
+    ok = ok && decode_to_array(dense_fused, dense_bytes, 1, sizeof(dense_bytes)) ==
+               decode_to_array(packed_fused, packed_bytes, 1, sizeof(packed_bytes)) &&
+         memcmp(dense_bytes, packed_bytes, sizeof(dense_bytes)) == 0;
+
+    free_split_result(dense_split, dense_zones);
+    free_split_result(packed_split, packed_zones);
+    free_lum_group(dense_fused);
+    free_lum_group(packed_fused);
+    free_lum_group(dense_a);
+    free_lum_group(packed_a);
+    free_lum_group(dense_b);
+    free_lum_group(packed_b);
+
+    if (ok) {
+        printf("      ✅ Fusion/split/cycle/décodage packed conformes\n");
+        return 1;
+    }
+    printf("      ❌ Divergence opérations packed\n");
+    return 0;
+}
+
+// Test codec texte SIMD (chaque niveau doit produire le même résultat)
+int test_simd_text_codec() {
+    printf("   Test codec texte SIMD...\n");
+
+    const size_t len = 1000;
+    char* text = malloc(len + 1);
+    if (!text) return 0;
+    for (size_t i = 0; i < len; i++) {
+        text[i] = ((i * 2654435761u) >> 7) & 1 ? '1' : '0';
+    }
+    text[len] = '\0';
+
+    LumCodecLevel detected = lum_codec_level();
+    int ok = 1;
+
+    for (int level = LUM_CODEC_SCALAR; ok && level <= (int)detected; level++) {
+        lum_codec_force_level((LumCodecLevel)level);
+
+        LUMGroup* dense = encode_binary_string(text);
+        LUMGroup* packed = encode_binary_string_packed(text);
+        char* dense_text = decode_group_to_binary_string(dense);
+        char* packed_text = decode_group_to_binary_string(packed);
+
+        ok = groups_match(dense, packed) && dense_text && packed_text &&
+             strcmp(dense_text, text) == 0 && strcmp(packed_text, text) == 0;
+
+        text[777] = '2';
+        ok = ok && encode_binary_string(text) == NULL && encode_binary_string_packed(text) == NULL;
+        text[777] = '1';
+
+        free(dense_text);
+        free(packed_text);
+        free_lum_group(dense);
+        free_lum_group(packed);
+    }
+    lum_codec_force_level(detected);
+    free(text);
+
+    if (ok) {
+        printf("      ✅ Codec texte conforme (niveau SIMD max: %d)\n", (int)detected);
+        return 1;
+    }
+    printf("      ❌ Codec texte divergent\n");
+    return 0;
+}
+
+// Test codecs tableau d'octets (tailles d'éléments et longueurs arbitraires)
+int test_array_codec() {
+    printf("   Test codecs tableau d'octets...\n");
+
+    uint8_t payload[777];
+    uint8_t dense_out[777], packed_out[777];
+    for (size_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = (uint8_t)((i * 2654435761u) >> 13);
+    }
+
+    const size_t element_sizes[] = {1, 3, 8, 37};
+    LumCodecLevel detected = lum_codec_level();
+    int ok = 1;
+
+    for (int level = LUM_CODEC_SCALAR; ok && level <= (int)detected; level++) {
+        lum_codec_force_level((LumCodecLevel)level);
+
+        for (size_t e = 0; ok && e < sizeof(element_sizes) / sizeof(element_sizes[0]); e++) {
+            size_t element_size = element_sizes[e];
+            size_t count = sizeof(payload) / element_size;
+
+            LUMGroup* dense = encode_array(payload, element_size, count);
+            LUMGroup* packed = encode_array_packed(payload, element_size, count);
+
+            ok = groups_match(dense, packed) &&
+                 decode_to_array(dense, dense_out, element_size, count) == (int)count &&
+                 decode_to_array(packed, packed_out, element_size, count) == (int)count &&
+                 memcmp(dense_out, payload, element_size * count) == 0 &&
+                 memcmp(packed_out, payload, element_size * count) == 0;
+
+            free_lum_group(dense);
+            free_lum_group(packed);
+        }
+    }
+    lum_codec_force_level(detected);
+
+    if (ok) {
+        printf("      ✅ Aller-retour octets → LUMs → octets conforme\n");
+        return 1;
+    }
+    printf("      ❌ Aller-retour tableau divergent\n");
+    return 0;
+}
+
+// Vérifie les positions d'un groupe contre des positions attendues
+static int positions_match(LUMGroup* group, const int* xs, const int* ys) {
+    for (size_t i = 0; i < group->count; i++) {
+        int x, y;
+        if (lum_group_position(group, i, &x, &y) != 0 || x != xs[i] || y != ys[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Test descripteurs de layout (positions calculées à la demande)
+int test_layout_descriptors() {
+    printf("   Test descripteurs de layout...\n");
+
+    enum { N = 150 };
+    int xs[2 * N], ys[2 * N];
+    int ok = 1;
+
+    // Flow et fusion alignée ne touchent que le descripteur
+    LUMGroup* a = encode_binary_string("1011001110001111010101");
+    LUMGroup* flowed = lum_flow(a, "zone");
+    LUMGroup* twice = lum_flow(flowed, "zone");
+    LUMGroup* fused = lum_fusion(a, a);
+    ok = ok && twice->layout.kind == LUM_LAYOUT_LINEAR && twice->layout.offset_x == 200 &&
+         fused->layout.kind == LUM_LAYOUT_LINEAR;
+    for (size_t i = 0; i < a->count; i++) {
+        xs[i] = (int)i * 20 + 200;
+        ys[i] = 0;
+    }
+    ok = ok && positions_match(twice, xs, ys);
+    for (size_t i = 0; i < fused->count; i++) {
+        xs[i] = (int)i * 20;
+        ys[i] = 0;
+    }
+    ok = ok && positions_match(fused, xs, ys);
+
+    // Cycle: cercle identique aux positions historiques
+    uint8_t payload[N / 8 + 1];
+    memset(payload, 0xA5, sizeof(payload));
+    LUMGroup* grid = encode_array(payload, 1, sizeof(payload));
+    LUMGroup* cycled = lum_cycle(grid, 100);
+    double angle_step = 2.0 * 3.14159265359 / cycled->count;
+    for (size_t i = 0; i < cycled->count; i++) {
+        xs[i] = (int)(50 + 30 * cos(i * angle_step));
+        ys[i] = (int)(50 + 30 * sin(i * angle_step));
+    }
+    ok = ok && cycled->layout.kind == LUM_LAYOUT_CIRCLE && positions_match(cycled, xs, ys);
+
+    // Fusion non alignée (cercle + grille): positions matérialisées
+    LUMGroup* mixed = lum_fusion(cycled, grid);
+    for (size_t i = 0; i < grid->count; i++) {
+        xs[cycled->count + i] = (int)(i % 32) * 20 + (int)cycled->count * 20;
+        ys[cycled->count + i] = (int)(i / 32) * 30;
+    }
+    ok = ok && mixed->layout.kind == LUM_LAYOUT_EXPLICIT && positions_match(mixed, xs, ys);
+
+    // Fusion organique: spirale rejouée à l'identique
+    LUMGroup* parts[2] = {a, grid};
+    LUMGroup* organic = lum_organic_fusion(parts, 2);
+    int radius = 0;
+    double angle = 0;
+    for (size_t i = 0; i < organic->count; i++) {
+        xs[i] = (int)(radius * cos(angle));
+        ys[i] = (int)(radius * sin(angle));
+        angle += 0.5;
+        if (angle > 2 * 3.14159265359) {
+            angle = fmod(angle, 2 * 3.14159265359);
+            radius += 10;
+        }
+    }
+    ok = ok && positions_match(organic, xs, ys);
+    ok = ok && lum_group_materialize_positions(organic) == 0 &&
+         organic->layout.kind == LUM_LAYOUT_EXPLICIT && positions_match(organic, xs, ys);
+
+    // Index au-delà de INT_MAX: calcul 64 bits, bornes de int
+    int x = 0, y = 0;
+    LumLayout wide = lum_layout_linear(-100, 0, 1);
+    lum_layout_position(&wide, (size_t)INT_MAX + 50, &x, &y);
+    ok = ok && x == INT_MAX - 50;
+    LumLayout far = lum_layout_grid(0, 0, 20, 4, 30);
+    lum_layout_position(&far, (size_t)4 << 40, &x, &y);
+    ok = ok && x == 0 && y == INT_MAX;
+    LUM edge[2];
+    lum_layout_fill(&wide, SIZE_MAX - 1, 2, edge);
+    LumLayout slice;
+    ok = ok && edge[0].position.x == INT_MAX && edge[1].position.x == INT_MAX &&
+         lum_layout_slice(&wide, (size_t)INT_MAX + 200, &slice) == -1 &&
+         lum_layout_slice(&wide, (size_t)INT_MAX + 50, &slice) == 0 && slice.offset_x == INT_MAX - 50;
+    ok = ok && lum_fusion_shift(150) == 3000 && lum_fusion_shift((size_t)INT_MAX / 20 + 1) == INT_MAX &&
+         lum_fusion_shift(SIZE_MAX) == INT_MAX;
+
+    // Layout implicite : lums[].position non stockées mais jamais indéterminées
+    char bits[201];
+    for (size_t i = 0; i < 200; i++) bits[i] = (char)('0' + (i * 7 % 3 == 0));
+    bits[200] = '\0';
+    LUMGroup* long_bits = encode_binary_string(bits);
+    LUMGroup* long_array = encode_array(payload, 1, sizeof(payload));
+    ok = ok && long_bits && long_array && long_bits->layout.kind == LUM_LAYOUT_LINEAR;
+    for (size_t i = 0; ok && i < 200; i++) {
+        ok = long_bits->lums[i].position.x == 0 && long_bits->lums[i].position.y == 0 &&
+             (i >= long_array->count ||
+              (long_array->lums[i].position.x == 0 && long_array->lums[i].position.y == 0));
+    }
+    ok = ok && validate_lum_group(long_bits) == 1;
+    free_lum_group(long_bits);
+    free_lum_group(long_array);
+
+    free_lum_group(a);
+    free_lum_group(flowed);
+    free_lum_group(twice);
+    free_lum_group(fused);
+    free_lum_group(grid);
+    free_lum_group(cycled);
+    free_lum_group(mixed);
+    free_lum_group(organic);
+
+    if (ok) {
+        printf("      ✅ Layouts linéaire/grille/cercle/spirale conformes\n");
+        return 1;
+    }
+    printf("      ❌ Positions de layout divergentes\n");
+    return 0;
+}
+
+// Test enregistrements compacts 8 octets + table spatiale
+int test_compact_records() {
+    printf("   Test enregistrements compacts...\n");
+
+    uint8_t payload[100];
+    uint8_t dense_bytes[100], compact_bytes[100];
+    for (size_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = (uint8_t)(i * 131 + 7);
+    }
+
+    SpatialData marker;
+    marker.type = SPATIAL_NONE;
+
+    LUMGroup* dense = encode_array(payload, 1, sizeof(payload));
+    dense->lums[500].spatial_data = &marker;
+    LUMGroup* compact = encode_array(payload, 1, sizeof(payload));
+    compact->lums[500].spatial_data = &marker;
+    int ok = sizeof(LumCompact) == 8 && lum_group_compact(compact) == 0 &&
+             compact->storage == LUM_STORAGE_COMPACT && groups_match(dense, compact) &&
+             compact->compact->spatial_count == 1 && compact_get_spatial(compact, 500) == &marker;
+
+    ok = ok && decode_to_array(compact, compact_bytes, 1, sizeof(compact_bytes)) ==
+               decode_to_array(dense, dense_bytes, 1, sizeof(dense_bytes)) &&
+         memcmp(compact_bytes, payload, sizeof(payload)) == 0 &&
+         calculate_lum_entropy(compact) == calculate_lum_entropy(dense);
+
+    // Opérations VORAX: mêmes LUMs que le chemin dense
+    LUMGroup* dense_fused = lum_fusion(dense, dense);
+    LUMGroup* compact_fused = lum_fusion(compact, dense);
+    ok = ok && compact_fused->storage == LUM_STORAGE_COMPACT && groups_match(dense_fused, compact_fused) &&
+         compact_get_spatial(compact_fused, dense->count + 500) == &marker;
+
+    size_t dense_zones = 0, compact_zones = 0;
+    LUMGroup** dense_split = lum_split(dense_fused, 7, &dense_zones);
+    LUMGroup** compact_split = lum_split(compact_fused, 7, &compact_zones);
+    ok = ok && dense_zones == compact_zones;
+    for (size_t i = 0; ok && i < dense_zones; i++) {
+        ok = groups_match(dense_split[i], compact_split[i]);
+    }
+
+    LUMGroup* dense_cycle = lum_cycle(dense_fused, 1999);
+    LUMGroup* compact_cycle = lum_cycle(compact_fused, 1999);
+    LUMGroup* dense_flow = lum_flow(dense_cycle, "zone");
+    LUMGroup* compact_flow = lum_flow(compact_cycle, "zone");
+    ok = ok && groups_match(dense_cycle, compact_cycle) && groups_match(dense_flow, compact_flow);
+
+    // Décalage de fusion hors int16: repli sur un résultat dense
+    LUMGroup* dense_far = lum_fusion(dense_cycle, dense_fused);
+    LUMGroup* compact_far = lum_fusion(compact_cycle, compact_fused);
+    char* dense_far_bits = decode_group_to_binary_string(dense_far);
+    char* compact_far_bits = decode_group_to_binary_string(compact_far);
+    ok = ok && compact_far && compact_far->storage == LUM_STORAGE_DENSE &&
+         dense_far_bits && compact_far_bits && strcmp(dense_far_bits, compact_far_bits) == 0;
+    free(dense_far_bits);
+    free(compact_far_bits);
+
+    ok = ok && lum_group_uncompact(compact) == 0 && compact->lums[500].spatial_data == &marker;
+
+    free_split_result(dense_split, dense_zones);
+    free_split_result(compact_split, compact_zones);
+    free_lum_group(dense);
+    free_lum_group(compact);
+    free_lum_group(dense_fused);
+    free_lum_group(compact_fused);
+    free_lum_group(dense_cycle);
+    free_lum_group(compact_cycle);
+    free_lum_group(dense_flow);
+    free_lum_group(compact_flow);
+    free_lum_group(dense_far);
+    free_lum_group(compact_far);
+
+    if (ok) {
+        printf("      ✅ Records 8 octets conformes (%zu LUMs par ligne de cache)\n", 64 / sizeof(LumCompact));
+        return 1;
+    }
+    printf("      ❌ Divergence stockage compact\n");
+    return 0;
+}
+
+// Test stockage en colonnes (SoA) et noyaux vectorisés
+int test_soa_columns() {
+    printf("   Test colonnes SoA...\n");
+
+    uint8_t payload[300];
+    uint8_t dense_bytes[300], soa_bytes[300];
+    for (size_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = (uint8_t)(i * 97 + 3);
+    }
+
+    // Positions explicites: LUM 37 trop proche de son voisin
+    const size_t n = 1000;
+    LUM* lums = malloc(sizeof(LUM) * n);
+    if (!lums) return 0;
+    for (size_t i = 0; i < n; i++) {
+        lums[i].presence = (uint8_t)(i % 3 == 0);
+        lums[i].structure_type = (LumStructureType)(i % 4);
+        lums[i].position.x = (int)(i % 40) * 15 - 300;
+        lums[i].position.y = (int)(i / 40) * 12 - 150;
+        lums[i].spatial_data = NULL;
+    }
+    LUMGroup* explicit_dense = lum_group_copy(lums, n, GROUP_LINEAR);
+    LUMGroup* explicit_soa = lum_group_copy(lums, n, GROUP_LINEAR);
+    lums[37].position.x = lums[36].position.x + 3;
+    LUMGroup* close_dense = lum_group_copy(lums, n, GROUP_LINEAR);
+    LUMGroup* close_soa = lum_group_copy(lums, n, GROUP_LINEAR);
+    free(lums);
+
+    LUMGroup* dense = encode_array(payload, 1, sizeof(payload));
+    LUMGroup* soa = encode_array(payload, 1, sizeof(payload));
+    int ok = lum_group_to_soa(soa) == 0 && lum_group_to_soa(explicit_soa) == 0 &&
+             lum_group_to_soa(close_soa) == 0 && soa->storage == LUM_STORAGE_SOA &&
+             soa->soa->x == NULL && explicit_soa->soa->x != NULL &&
+             groups_match(dense, soa) && groups_match(explicit_dense, explicit_soa);
+
+    LUMGroup* dense_fused = lum_fusion(dense, dense);
+    LUMGroup* soa_fused = lum_fusion(soa, dense);
+    LUMGroup* dense_mixed = lum_fusion(explicit_dense, dense);
+    LUMGroup* soa_mixed = lum_fusion(explicit_soa, soa);
+
+    LumCodecLevel detected = lum_codec_level();
+    for (int level = LUM_CODEC_SCALAR; ok && level <= (int)detected; level++) {
+        lum_codec_force_level((LumCodecLevel)level);
+
+        ok = decode_to_array(soa, soa_bytes, 1, sizeof(soa_bytes)) ==
+             decode_to_array(dense, dense_bytes, 1, sizeof(dense_bytes)) &&
+             memcmp(soa_bytes, payload, sizeof(payload)) == 0 &&
+             calculate_lum_entropy(soa) == calculate_lum_entropy(dense) &&
+             calculate_lum_entropy(explicit_soa) == calculate_lum_entropy(explicit_dense);
+
+        ok = ok && validate_lum_group(explicit_soa) == 1 && validate_lum_group(explicit_dense) == 1 &&
+             validate_lum_group(close_soa) == 0 && validate_lum_group(close_dense) == 0 &&
+             validate_lum_group(soa) == validate_lum_group(dense) &&
+             validate_lum_group(soa_mixed) == validate_lum_group(dense_mixed);
+
+        size_t dense_types = 0, soa_types = 0;
+        LUMGroup** dense_ctx = lum_contextual_split(explicit_dense, &dense_types);
+        LUMGroup** soa_ctx = lum_contextual_split(explicit_soa, &soa_types);
+        ok = ok && dense_types == 4 && soa_types == 4;
+        for (size_t i = 0; ok && i < dense_types; i++) {
+            ok = soa_ctx[i]->storage == LUM_STORAGE_SOA && groups_match(dense_ctx[i], soa_ctx[i]);
+        }
+        free_split_result(dense_ctx, dense_types);
+        free_split_result(soa_ctx, soa_types);
+    }
+    lum_codec_force_level(detected);
+
+    // Opérations VORAX: mêmes LUMs que le chemin dense
+    ok = ok && soa_fused->storage == LUM_STORAGE_SOA && groups_match(dense_fused, soa_fused) &&
+         soa_mixed->storage == LUM_STORAGE_SOA && groups_match(dense_mixed, soa_mixed);
+
+    size_t dense_zones = 0, soa_zones = 0;
+    LUMGroup** dense_split = lum_split(dense_fused, 7, &dense_zones);
+    LUMGroup** soa_split = lum_split(soa_fused, 7, &soa_zones);
+    ok = ok && dense_zones == soa_zones;
+    for (size_t i = 0; ok && i < dense_zones; i++) {
+        ok = groups_match(dense_split[i], soa_split[i]);
+    }
+
+    LUMGroup* dense_cycle = lum_cycle(dense_mixed, 1999);
+    LUMGroup* soa_cycle = lum_cycle(soa_mixed, 1999);
+    LUMGroup* dense_flow = lum_flow(explicit_dense, "zone");
+    LUMGroup* soa_flow = lum_flow(explicit_soa, "zone");
+    ok = ok && groups_match(dense_cycle, soa_cycle) && groups_match(dense_flow, soa_flow);
+
+    // Aller-retour colonnes → LUMs → colonnes
+    ok = ok && lum_group_from_soa(explicit_soa) == 0 && explicit_soa->storage == LUM_STORAGE_DENSE &&
+         lum_group_to_soa(explicit_soa) == 0 && groups_match(explicit_dense, explicit_soa);
+
+    free_split_result(dense_split, dense_zones);
+    free_split_result(soa_split, soa_zones);
+    free_lum_group(dense);
+    free_lum_group(soa);
+    free_lum_group(explicit_dense);
+    free_lum_group(explicit_soa);
+    free_lum_group(close_dense);
+    free_lum_group(close_soa);
+    free_lum_group(dense_fused);
+    free_lum_group(soa_fused);
+    free_lum_group(dense_mixed);
+    free_lum_group(soa_mixed);
+    free_lum_group(dense_cycle);
+    free_lum_group(soa_cycle);
+    free_lum_group(dense_flow);
+    free_lum_group(soa_flow);
+
+    if (ok) {
+        printf("      ✅ Colonnes SoA conformes au stockage dense\n");
+        return 1;
+    }
+    printf("      ❌ Divergence stockage SoA\n");
+    return 0;
+}
+
+// Compare deux groupes bit à bit via leur décodage texte
+static int bits_match(LUMGroup* a, LUMGroup* b) {
+    char* a_bits = decode_group_to_binary_string(a);
+    char* b_bits = decode_group_to_binary_string(b);
+    int ok = a_bits && b_bits && strcmp(a_bits, b_bits) == 0;
+    free(a_bits);
+    free(b_bits);
+    return ok;
+}
+
+// Test conteneurs adaptatifs (liste d'indices / bitmap / runs)
+int test_hybrid_containers() {
+    printf("   Test conteneurs hybrides...\n");
+
+    // Conteneur 0 épars, 1 dense aléatoire, 2 en longues séquences, 3 vide, 4 partiel
+    const size_t n = 4 * LUM_CONTAINER_SIZE + 12345;
+    LUMGroup* hybrid = create_hybrid_lum_group(n, GROUP_LINEAR);
+    LUMGroup* packed = create_packed_lum_group(n, GROUP_LINEAR);
+    int ok = hybrid && packed;
+    for (size_t i = 0; ok && i < n; i++) {
+        size_t local = i % LUM_CONTAINER_SIZE;
+        int present;
+        switch (i / LUM_CONTAINER_SIZE) {
+            case 0: present = local % 997 == 0; break;
+            case 1: present = ((i * 2654435761u) >> 13) & 1; break;
+            case 2: present = local < 60000 ? (local / 1000) % 2 == 1 : local > LUM_CONTAINER_SIZE - 50; break;
+            case 3: present = 0; break;
+            default: present = local < 40 || local % 5 == 0; break;
+        }
+        if (present) {
+            ok = hybrid_set_presence(hybrid, i, 1) == 0;
+            packed->packed->words[i / 64] |= 1ULL << (i % 64);
+        }
+    }
+    ok = ok && hybrid_optimize(hybrid) == 0 &&
+         hybrid->hybrid->containers[0].kind == LUM_CONTAINER_ARRAY &&
+         hybrid->hybrid->containers[1].kind == LUM_CONTAINER_BITMAP &&
+         hybrid->hybrid->containers[2].kind == LUM_CONTAINER_RUN &&
+         hybrid->hybrid->containers[3].cardinality == 0 &&
+         hybrid_popcount(hybrid) == packed_popcount(packed) && bits_match(hybrid, packed);
+
+    // Séquence à cheval entre les conteneurs 2 et 3
+    ok = ok && hybrid_set_presence(hybrid, 3 * LUM_CONTAINER_SIZE, 1) == 0 &&
+         hybrid_get_presence(hybrid, 3 * LUM_CONTAINER_SIZE) == 1;
+    packed->packed->words[3 * LUM_CONTAINER_SIZE / 64] |= 1;
+    size_t run_start = 0, run_length = 0;
+    ok = ok && hybrid_next_run(hybrid, 3 * LUM_CONTAINER_SIZE - 100, &run_start, &run_length) == 0 &&
+         run_start == 3 * LUM_CONTAINER_SIZE - 49 && run_length == 50;
+
+    uint8_t hybrid_bytes[n / 8 + 1], packed_bytes[n / 8 + 1];
+    ok = ok && decode_to_array(hybrid, hybrid_bytes, 1, sizeof(hybrid_bytes)) ==
+               decode_to_array(packed, packed_bytes, 1, sizeof(packed_bytes)) &&
+         memcmp(hybrid_bytes, packed_bytes, sizeof(packed_bytes)) == 0 &&
+         calculate_lum_entropy(hybrid) == calculate_lum_entropy(packed);
+
+    // Conversions et opérations: mêmes bits / LUMs que le chemin packed
+    LUMGroup* round_trip = hybrid_to_packed(hybrid);
+    LUMGroup* from_packed = hybrid_from_packed(packed);
+    ok = ok && bits_match(round_trip, packed) && hybrid_equal(from_packed, hybrid);
+
+    LUMGroup* packed_cycle = lum_cycle(packed, 100003);
+    LUMGroup* hybrid_cycle = lum_cycle(hybrid, 100003);
+    LUMGroup* packed_fused = lum_fusion(packed_cycle, packed);
+    LUMGroup* hybrid_fused = lum_fusion(hybrid_cycle, hybrid);
+    ok = ok && hybrid_fused && hybrid_fused->storage == LUM_STORAGE_HYBRID &&
+         bits_match(packed_fused, hybrid_fused) && bits_match(packed_cycle, hybrid_cycle);
+    for (size_t i = 0; ok && i < packed_fused->count; i += 7919) {
+        LUM expected, got;
+        ok = packed_get_lum(packed_fused, i, &expected) == 0 && hybrid_get_lum(hybrid_fused, i, &got) == 0 &&
+             expected.presence == got.presence && expected.structure_type == got.structure_type &&
+             expected.position.x == got.position.x && expected.position.y == got.position.y;
+    }
+
+    size_t packed_zones = 0, hybrid_zones = 0;
+    LUMGroup** packed_split = lum_split(packed_fused, 3, &packed_zones);
+    LUMGroup** hybrid_split = lum_split(hybrid_fused, 3, &hybrid_zones);
+    ok = ok && packed_zones == hybrid_zones;
+    for (size_t i = 0; ok && i < packed_zones; i++) {
+        ok = bits_match(packed_split[i], hybrid_split[i]);
+    }
+
+    LUMGroup* hybrid_flow = lum_flow(hybrid_cycle, "zone");
+    LUMGroup* dense_flow = lum_flow(hybrid_cycle, "zone");
+    ok = ok && lum_group_from_hybrid(dense_flow) == 0 && lum_group_unpack(dense_flow) == 0 &&
+         groups_match(dense_flow, hybrid_flow);
+
+    free_lum_group(hybrid);
+    free_lum_group(packed);
+    free_lum_group(round_trip);
+    free_lum_group(from_packed);
+    free_lum_group(packed_cycle);
+    free_lum_group(hybrid_cycle);
+    free_lum_group(packed_fused);
+    free_lum_group(hybrid_fused);
+    free_split_result(packed_split, packed_zones);
+    free_split_result(hybrid_split, hybrid_zones);
+    free_lum_group(hybrid_flow);
+    free_lum_group(dense_flow);
+
+    if (ok) {
+        printf("      ✅ Conteneurs tableau/bitmap/runs conformes au stockage packed\n");
+        return 1;
+    }
+    printf("      ❌ Divergence stockage hybride\n");
+    return 0;
+}
+
+// Puits de test: recopie chaque bloc décodé en texte binaire
+typedef struct {
+    char* text;
+    size_t length;
+    size_t chunks;
+    size_t stop_after;
+} StreamCapture;
+
+static int capture_chunk(const uint64_t* words, size_t bit_count, void* context) {
+    StreamCapture* capture = context;
+    lum_words_to_ascii(words, bit_count, capture->text + capture->length);
+    capture->length += bit_count;
+    capture->chunks++;
+    return capture->chunks == capture->stop_after ? 42 : 0;
+}
+
+int test_streaming_decode() {
+    printf("   Test décodage en flux...\n");
+
+    const size_t n = 5000;
+    LUM* lums = malloc(sizeof(LUM) * n);
+    char* text = malloc(n + 1);
+    if (!lums || !text) {
+        free(lums);
+        free(text);
+        return 0;
+    }
+    for (size_t i = 0; i < n; i++) {
+        lums[i].presence = (uint8_t)((i * 2654435761u) >> 17 & 1);
+        lums[i].structure_type = LUM_LINEAR;
+        lums[i].position.x = (int)(i % 100) * 20;
+        lums[i].position.y = (int)(i / 100) * 20;
+        lums[i].spatial_data = NULL;
+    }
+    LUMGroup* dense = lum_group_copy(lums, n, GROUP_LINEAR);
+    LUMGroup* groups[5] = {dense, packed_from_dense(dense), compact_from_dense(dense),
+                           soa_from_dense(dense), hybrid_from_dense(dense)};
+    char* expected = decode_group_to_binary_string(dense);
+    int ok = expected != NULL;
+
+    // Chaque stockage, à travers un tampon de 3 mots
+    for (int g = 0; ok && g < 5; g++) {
+        uint64_t buffer[3];
+        StreamCapture capture = {text, 0, 0, 0};
+        ok = groups[g] && decode_group_stream(groups[g], buffer, 3, capture_chunk, &capture) == 0 &&
+             capture.length == n && capture.chunks == (n + 191) / 192 &&
+             memcmp(text, expected, n) == 0;
+
+        // Fenêtre décalée, non alignée sur un mot
+        uint64_t window[4];
+        ok = ok && decode_group_bits(groups[g], 1234, 200, window) == 0 &&
+             (window[3] >> 8) == 0;
+        lum_words_to_ascii(window, 200, text);
+        ok = ok && memcmp(text, expected + 1234, 200) == 0 &&
+             decode_group_bits(groups[g], n - 10, 11, window) == -1;
+    }
+
+    // Arrêt anticipé: le statut du puits est renvoyé
+    uint64_t buffer[2];
+    StreamCapture early = {text, 0, 0, 3};
+    ok = ok && decode_group_stream(groups[1], buffer, 2, capture_chunk, &early) == 42 &&
+         early.length == 3 * 128 && decode_lum_group(dense) == 0;
+
+    free(expected);
+    for (int g = 0; g < 5; g++) {
+        free_lum_group(groups[g]);
+    }
+    free(lums);
+    free(text);
+
+    if (ok) {
+        printf("      ✅ Flux identique au texte binaire pour tous les stockages\n");
+        return 1;
+    }
+    printf("      ❌ Divergence du décodage en flux\n");
+    return 0;
+}
+
+// Puits de test: chaque bloc doit reproduire la tranche correspondante du groupe complet
+typedef struct {
+    LUMGroup* reference;
+    size_t chunk_bytes;
+    size_t chunks;
+    size_t bits;
+    int ok;
+} ChunkCheck;
+
+static int check_chunk(const LUMGroup* chunk, size_t chunk_index, void* context) {
+    ChunkCheck* check = context;
+    size_t words = (chunk->count + 63) / 64;
+    uint64_t* expected = malloc(sizeof(uint64_t) * (words + 1));
+    check->ok = check->ok && expected && chunk_index == check->chunks &&
+                chunk->storage == LUM_STORAGE_PACKED && chunk->count <= check->chunk_bytes * 8 &&
+                decode_group_bits(check->reference, chunk_index * check->chunk_bytes * 8,
+                                  chunk->count, expected) == 0 &&
+                memcmp(expected, chunk->packed->words, sizeof(uint64_t) * words) == 0;
+    free(expected);
+    check->chunks++;
+    check->bits += chunk->count;
+    return 0;
+}
+
+int test_streaming_encode() {
+    printf("   Test encodage en flux...\n");
+
+    const size_t size = 10000 + 37;
+    uint8_t* data = malloc(size);
+    if (!data) return 0;
+    for (size_t i = 0; i < size; i++) {
+        data[i] = (uint8_t)((i * 2654435761u) >> 11);
+    }
+    LUMGroup* reference = encode_array_packed(data, 1, size);
+    int ok = reference != NULL;
+
+    // Mémoire, fichier régulier (mmap) et tube (read), blocs de 4096 puis 300 octets
+    ChunkCheck memory = {reference, 4096, 0, 0, 1};
+    ok = ok && encode_stream_memory(data, size, 4096, check_chunk, &memory) == 0 &&
+         memory.ok && memory.chunks == 3 && memory.bits == size * 8;
+
+    FILE* file = tmpfile();
+    ChunkCheck mapped = {reference, 4096, 0, 0, 1};
+    ok = ok && file && fwrite(data, 1, size, file) == size && fflush(file) == 0 &&
+         encode_stream_fd(fileno(file), 4096, check_chunk, &mapped) == 0 &&
+         mapped.ok && mapped.chunks == 3 && mapped.bits == size * 8;
+    if (file) fclose(file);
+
+    int fds[2];
+    ChunkCheck piped = {reference, 300, 0, 0, 1};
+    if (ok && pipe(fds) == 0) {
+        ok = write(fds[1], data, 1000) == 1000;
+        close(fds[1]);
+        LumEncodeStream* stream = lum_stream_open_fd(fds[0], 300);
+        ok = ok && stream && !stream->use_mmap;
+        const LUMGroup* chunk;
+        while (ok && (chunk = lum_stream_next(stream)) != NULL) {
+            check_chunk(chunk, stream->chunk_index - 1, &piped);
+        }
+        ok = ok && piped.ok && piped.chunks == 4 && piped.bits == 1000 * 8 && stream->error == 0;
+        lum_stream_close(stream);
+        close(fds[0]);
+    } else {
+        ok = 0;
+    }
+
+    free_lum_group(reference);
+    free(data);
+
+    if (ok) {
+        printf("      ✅ Blocs mémoire/mmap/tube identiques à encode_array_packed\n");
+        return 1;
+    }
+    printf("      ❌ Divergence de l'encodage en flux\n");
+    return 0;
+}
+
+static int borrowed_releases = 0;
+
+static void count_release(void* context) {
+    (void)context;
+    borrowed_releases++;
+}
+
+int test_zero_copy_views() {
+    printf("   Test vues sans copie...\n");
+
+    uint8_t data[1000];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)((i * 2654435761u) >> 9);
+    }
+    LUMGroup* source = encode_array(data, 1, sizeof(data));
+    char* bits = decode_group_to_binary_string(source);
+    int ok = source && bits;
+    LUM* base = ok ? source->lums : NULL;
+
+    // Sous-plages: positions de la grille conservées, copie seulement hors ligne entière
+    LUMGroup* rows = ok ? lum_group_view(source, 64, 640) : NULL;
+    LUMGroup* ragged = ok ? lum_group_view(source, 70, 100) : NULL;
+    ok = ok && rows && ragged && lum_group_is_view(rows) && rows->lums == base + 64 &&
+         !lum_group_is_view(ragged);
+    for (size_t i = 0; ok && i < 100; i += 7) {
+        int x, y, vx, vy, rx, ry;
+        ok = lum_group_position(source, 64 + i, &x, &y) == 0 &&
+             lum_group_position(rows, i, &vx, &vy) == 0 &&
+             lum_group_position(ragged, i, &rx, &ry) == 0 && x == vx && y == vy &&
+             lum_group_position(source, 70 + i, &x, &y) == 0 && x == rx && y == ry;
+    }
+
+    // Split: zones LUM_LINEAR empruntées à la source, qui peut être libérée avant elles
+    size_t zone_count = 0;
+    LUMGroup** zones = ok ? lum_split(source, 3, &zone_count) : NULL;
+    ok = ok && zones && zone_count == 3 && zones[0]->lums == base && zones[1]->lums == base + 2667 &&
+         zones[2]->lums == base + 5334 && zones[2]->layout.offset_y == 100;
+
+    // Écriture sur une vue: copie privée d'abord, la source reste intacte
+    ok = ok && lum_group_materialize_positions(rows) == 0 && rows->lums != base + 64 &&
+         !lum_group_is_view(rows) && rows->layout.kind == LUM_LAYOUT_EXPLICIT &&
+         source->layout.kind == LUM_LAYOUT_GRID;
+
+    free_lum_group(source);
+    size_t offset = 0;
+    for (size_t z = 0; ok && z < zone_count; z++) {
+        char* zone_bits = decode_group_to_binary_string(zones[z]);
+        ok = zone_bits && memcmp(zone_bits, bits + offset, zones[z]->count) == 0;
+        offset += zones[z]->count;
+        free(zone_bits);
+    }
+    ok = ok && offset == sizeof(data) * 8;
+    if (zones) free_split_result(zones, zone_count);
+
+    // Mémoire externe: libérée une seule fois, après la dernière vue
+    LUM external[16];
+    memset(external, 0, sizeof(external));
+    external[3].presence = 1;
+    LUMGroup* borrowed = lum_group_borrow(external, 16, GROUP_LINEAR, count_release, NULL);
+    LUMGroup* tail = borrowed ? lum_group_view(borrowed, 2, 4) : NULL;
+    free_lum_group(borrowed);
+    ok = ok && tail && borrowed_releases == 0 && tail->lums[1].presence == 1;
+    free_lum_group(tail);
+    ok = ok && borrowed_releases == 1;
+
+    free_lum_group(rows);
+    free_lum_group(ragged);
+    free(bits);
+
+    if (ok) {
+        printf("      ✅ Vues, split et mémoire externe sans copie\n");
+        return 1;
+    }
+    printf("      ❌ Divergence des vues\n");
+    return 0;
+}
+
+// Clones et libérations concurrentes du même groupe, le premier clone partage
+typedef struct {
+    LUMGroup* source;
+    LUMGroup* kept;
+} CloneChurn;
+
+static void* clone_churn(void* arg) {
+    CloneChurn* churn = arg;
+    churn->kept = lum_group_clone_cow(churn->source);
+    for (int i = 0; i < 2000; i++) {
+        free_lum_group(lum_group_clone_cow(churn->source));
+    }
+    return NULL;
+}
+
+int test_copy_on_write() {
+    printf("   Test stockage copie sur écriture...\n");
+
+    uint8_t data[20000];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)((i * 2654435761u) >> 7);
+    }
+
+    // Packed: clone en O(1), mêmes mots
+    LUMGroup* packed = encode_array_packed(data, 1, sizeof(data));
+    LUMGroup* packed_clone = packed ? lum_group_clone_cow(packed) : NULL;
+    int ok = packed_clone && packed_clone->packed == packed->packed &&
+             lum_group_is_view(packed) && lum_group_is_view(packed_clone);
+
+    // Hybride: la première écriture copie, l'original reste intact
+    LUMGroup* hybrid = ok ? hybrid_from_packed(packed) : NULL;
+    LUMGroup* hybrid_clone = hybrid ? lum_group_clone_cow(hybrid) : NULL;
+    size_t index = 0;
+    while (ok && hybrid_get_presence(hybrid, index)) index++;
+    ok = ok && hybrid_clone && hybrid_set_presence(hybrid_clone, index, 1) == 0 &&
+         hybrid_clone->hybrid != hybrid->hybrid && !hybrid_clone->owner &&
+         hybrid_get_presence(hybrid_clone, index) == 1 && hybrid_get_presence(hybrid, index) == 0;
+
+    // Dernier détenteur: reprise du stockage sans copie
+    LumHybridStorage* before = hybrid ? hybrid->hybrid : NULL;
+    ok = ok && hybrid_set_presence(hybrid, index, 1) == 0 && hybrid->hybrid == before &&
+         !hybrid->owner && hybrid_equal(hybrid, hybrid_clone);
+
+    // Dense: le clone survit à sa source
+    LUMGroup* dense = encode_array(data, 1, 64);
+    LUMGroup* dense_clone = dense ? lum_group_clone_cow(dense) : NULL;
+    char* expected = dense ? decode_group_to_binary_string(dense) : NULL;
+    // Écriture par lum_group_writable : copie privée, la source ne bouge pas
+    LUMGroup* written = dense ? lum_group_clone_cow(dense) : NULL;
+    LUM* writable = written ? lum_group_writable(written) : NULL;
+    if (writable) writable[0].presence ^= 1;
+    ok = ok && writable && !lum_group_is_view(written) && dense->lums[0].presence != writable[0].presence;
+    free_lum_group(written);
+    free_lum_group(dense);
+    char* bits = dense_clone ? decode_group_to_binary_string(dense_clone) : NULL;
+    ok = ok && expected && bits && strcmp(expected, bits) == 0;
+
+    // 4 threads clonent en parallèle des groupes neufs (inline, tas, packed) :
+    // un seul partage gagne, les clones gardent le contenu après la source
+    for (int round = 0; ok && round < 3; round++) {
+        LUMGroup* source = round == 0 ? encode_array(data, 1, 4) :
+                           round == 1 ? encode_array(data, 1, 512) : encode_array_packed(data, 1, 512);
+        char* before = source ? decode_group_to_binary_string(source) : NULL;
+        CloneChurn churn[4];
+        pthread_t threads[4];
+        int started = 0;
+        for (int t = 0; before && t < 4; t++) {
+            churn[t] = (CloneChurn){source, NULL};
+            if (pthread_create(&threads[t], NULL, clone_churn, &churn[t]) == 0) started++;
+        }
+        for (int t = 0; t < started; t++) {
+            pthread_join(threads[t], NULL);
+        }
+        ok = started == 4;
+        LUMGroup* last = ok ? lum_group_clone_cow(source) : NULL;
+        free_lum_group(source);
+        for (int t = 0; t < started; t++) {
+            char* after = churn[t].kept ? decode_group_to_binary_string(churn[t].kept) : NULL;
+            ok = ok && after && strcmp(after, before) == 0 && last &&
+                 churn[t].kept->lums == last->lums && churn[t].kept->packed == last->packed;
+            free(after);
+            free_lum_group(churn[t].kept);
+        }
+        free_lum_group(last);
+        free(before);
+    }
+
+    free_lum_group(packed);
+    ok = ok && packed_popcount(packed_clone) > 0;
+    free_lum_group(packed_clone);
+    free_lum_group(hybrid);
+    free_lum_group(hybrid_clone);
+    free_lum_group(dense_clone);
+    free(expected);
+    free(bits);
+
+    if (ok) {
+        printf("      ✅ Clones O(1), copie à la première écriture, compteur atomique\n");
+        return 1;
+    }
+    printf("      ❌ Divergence copie sur écriture\n");
+    return 0;
+}
+
+int test_group_constructors() {
+    printf("   Test constructeurs adopt/copy/borrow...\n");
+
+    const size_t n = 100;
+    LUM* lums = malloc(sizeof(LUM) * n);
+    if (!lums) return 0;
+    for (size_t i = 0; i < n; i++) {
+        lums[i].presence = (uint8_t)(i % 3 == 1);
+        lums[i].structure_type = LUM_LINEAR;
+        lums[i].position.x = (int)i * 20;
+        lums[i].position.y = 0;
+        lums[i].spatial_data = NULL;
+    }
+
+    // copy duplique, borrow référence, adopt reprend le tableau tel quel
+    LUMGroup* copied = lum_group_copy(lums, n, GROUP_LINEAR);
+    LUMGroup* borrowed = lum_group_borrow(lums, n, GROUP_LINEAR, NULL, NULL);
+    int ok = copied && borrowed && copied->lums != lums && borrowed->lums == lums &&
+             compare_lum_groups(copied, borrowed) == 0;
+    free_lum_group(borrowed);
+
+    LUMGroup* adopted = lum_group_adopt(lums, n, GROUP_LINEAR);
+    ok = ok && adopted && adopted->lums == lums;
+
+    // Les opérations construisent leur résultat sans tableau intermédiaire
+    LUMGroup* cycled = ok ? lum_cycle(adopted, 7) : NULL;
+    LUMGroup* flowed = ok ? lum_flow(adopted, "zone_b") : NULL;
+    LUMGroup* clone = ok ? clone_lum_group(flowed) : NULL;
+    ok = ok && cycled && cycled->count == n % 7 && flowed && clone &&
+         compare_lum_groups(flowed, clone) == 0 && compare_lum_groups(flowed, copied) == 0;
+
+    free_lum_group(copied);
+    free_lum_group(adopted);
+    free_lum_group(cycled);
+    free_lum_group(flowed);
+    free_lum_group(clone);
+
+    if (ok) {
+        printf("      ✅ Une allocation par construction, propriété explicite\n");
+        return 1;
+    }
+    printf("      ❌ Divergence des constructeurs\n");
+    return 0;
+}
+
+int test_small_groups() {
+    printf("   Test stockage intégré des petits groupes...\n");
+
+    // encode_uint32 : en-tête et LUMs dans une seule allocation
+    LUMGroup* group = encode_uint32(0xDEADBEEF);
+    int ok = group && group->lums_inline && group->count == 32 &&
+             decode_to_uint32(group) == 0xDEADBEEF;
+
+    // Un clone partagé lit une copie hors du bloc, les deux groupes restent valides
+    LUMGroup* clone = ok ? clone_lum_group(group) : NULL;
+    ok = ok && clone && group->lums_inline && clone->lums != group->lums &&
+         compare_lum_groups(group, clone) == 0;
+    free_lum_group(group);
+    ok = ok && decode_to_uint32(clone) == 0xDEADBEEF;
+
+    // Empaquetage d'un groupe intégré : le mot de présence reste dans la structure
+    LUMGroup* small = encode_uint16(0xA5A5);
+    ok = ok && small && small->lums_inline && lum_group_pack(small) == 0 &&
+         !small->lums_inline && small->packed->words == &small->packed->inline_word &&
+         decode_to_uint16(small) == 0xA5A5 && lum_group_unpack(small) == 0 &&
+         decode_to_uint16(small) == 0xA5A5;
+
+    // Au-delà de LUM_INLINE_CAPACITY le tableau reste séparé
+    LUMGroup* large = lum_group_copy(NULL, LUM_INLINE_CAPACITY + 1, GROUP_LINEAR);
+    LUMGroup* copied = clone ? lum_group_copy(clone->lums, clone->count, GROUP_LINEAR) : NULL;
+    ok = ok && large && !large->lums_inline && copied && copied->lums_inline &&
+         lum_group_create_small(LUM_INLINE_CAPACITY + 1, GROUP_LINEAR) == NULL;
+
+    free_lum_group(clone);
+    free_lum_group(small);
+    free_lum_group(large);
+    free_lum_group(copied);
+
+    if (ok) {
+        printf("      ✅ Petits groupes en une allocation\n");
+        return 1;
+    }
+    printf("      ❌ Stockage intégré incohérent\n");
+    return 0;
+}
+
+int test_arena_groups() {
+    printf("   Test arène de groupes par requête...\n");
+
+    LumArena* arena = lum_arena_create(0);
+    if (!arena) return 0;
+    int lazy = arena->chunks == NULL; // Premier chunk au premier bloc
+    LumArena* previous = lum_arena_use(arena);
+
+    // Constructeurs et opérations puisent dans l'arène courante
+    LUMGroup* value = encode_uint32(0xCAFEF00D);
+    LUMGroup* large = lum_group_copy(NULL, 1000, GROUP_LINEAR);
+    LUMGroup* fused = value && large ? lum_fusion(value, large) : NULL;
+    LUMGroup* flowed = fused ? lum_flow(fused, "zone_b") : NULL;
+    LUMGroup* cycled = fused ? lum_cycle(fused, 7) : NULL;
+    size_t split_count = 0;
+    LUMGroup** zones = fused ? lum_split(fused, 3, &split_count) : NULL;
+    int ok = value && value->arena == arena && large && large->arena == arena &&
+             fused && fused->arena == arena && fused->count == 1032 &&
+             flowed && flowed->arena == arena && strcmp((char*)flowed->spatial_data, "zone_b") == 0 &&
+             cycled && cycled->count == 1032 % 7 && zones && split_count == 3 &&
+             decode_to_uint32(value) == 0xCAFEF00D;
+
+    // Un bloc libéré est réutilisé par le groupe suivant de même taille
+    size_t used = arena->bytes_used;
+    free_lum_group(flowed);
+    flowed = fused ? lum_flow(fused, "zone_b") : NULL;
+    ok = ok && lazy && flowed && arena->bytes_used == used;
+
+    // Blocs de plus de 64 Kio rendus au tas un par un : l'arène ne grossit pas
+    for (int round = 0; ok && round < 20; round++) {
+        LUMGroup* big = lum_group_copy(NULL, 10000, GROUP_LINEAR);
+        ok = big && big->arena == arena && arena->oversized != NULL;
+        free_lum_group(big);
+        ok = ok && arena->oversized == NULL && arena->bytes_used == used;
+    }
+
+    // Partagé hors de l'arène, le clone lui survit ; les clones et vues faits
+    // dans l'arène en tirent leur en-tête
+    LumArena* scope = lum_arena_use(NULL);
+    LUMGroup* clone = ok ? clone_lum_group(value) : NULL;
+    lum_arena_use(scope);
+    LUMGroup* inner = clone ? clone_lum_group(value) : NULL;
+    LUMGroup* view = clone ? lum_group_view(clone, 0, 8) : NULL;
+    ok = ok && clone && clone->arena == NULL && inner && inner->arena == arena &&
+         view && view->arena == arena && lum_group_is_view(view) && decode_to_uint32(inner) == 0xCAFEF00D;
+    free_lum_group(inner);
+    free_lum_group(view);
+
+    free_lum_group(value);
+    free_lum_group(large);
+    free_lum_group(fused);
+    free_lum_group(flowed);
+    free_lum_group(cycled);
+    free_split_result(zones, split_count);
+    ok = ok && arena->bytes_used == 0;
+
+    lum_arena_use(previous);
+    lum_arena_reset(arena);
+    LUMGroup* heap = encode_uint8(0x5A);
+    ok = ok && heap && heap->arena == NULL && decode_to_uint32(clone) == 0xCAFEF00D;
+    free_lum_group(heap);
+    free_lum_group(clone);
+    lum_arena_destroy(arena);
+
+    if (ok) {
+        printf("      ✅ Groupes de la requête libérés en une fois, blocs réutilisés\n");
+        return 1;
+    }
+    printf("      ❌ Arène incohérente\n");
+    return 0;
+}
+
+static void* read_group_id(void* arg) {
+    lum_group_id((LUMGroup*)arg);
+    return NULL;
+}
+
+int test_lazy_group_ids() {
+    printf("   Test identifiants de groupe paresseux...\n");
+
+    // Aucun identifiant n'est produit à la création
+    LUMGroup* a = encode_uint8(0x11);
+    LUMGroup* b = encode_uint8(0x22);
+    LUMGroup* c = encode_uint8(0x33);
+    int ok = a && b && c && a->id == NULL && a->uid.hi == 0;
+
+    // Première lecture : UUID v4 mis en cache, distinct d'un groupe à l'autre
+    const char* id_a = ok ? lum_group_id(a) : NULL;
+    LumGroupId uid_a = ok ? lum_group_uid(a) : (LumGroupId){0, 0};
+    LumGroupId uid_b = ok ? lum_group_uid(b) : (LumGroupId){0, 0};
+    ok = ok && id_a && strlen(id_a) == 36 && id_a[8] == '-' && id_a[14] == '4' &&
+         lum_group_id(a) == id_a && b->id == NULL &&
+         (uid_a.hi != uid_b.hi || uid_a.lo != uid_b.lo);
+
+    // Un autre thread tire son propre préfixe
+    pthread_t thread;
+    ok = ok && pthread_create(&thread, NULL, read_group_id, c) == 0 && pthread_join(thread, NULL) == 0 &&
+         c->id && c->uid.hi != uid_a.hi;
+
+    free_lum_group(a);
+    free_lum_group(b);
+    free_lum_group(c);
+
+    if (ok) {
+        printf("      ✅ Identifiants créés à la lecture, sans appel système par groupe\n");
+        return 1;
+    }
+    printf("      ❌ Identifiants incohérents\n");
+    return 0;
+}
+
+static void* draw_thread_random(void* arg) {
+    *(uint64_t*)arg = lum_random_u64();
+    return NULL;
+}
+
+int test_rng_streams() {
+    printf("   Test générateur aléatoire par thread...\n");
+
+    // Même graine, même flux
+    LumRng a, b;
+    lum_rng_init(&a, 42);
+    lum_rng_init(&b, 42);
+    int ok = 1;
+    for (int i = 0; i < 100; i++) {
+        uint64_t bound = (uint64_t)i * 7 + 1;
+        ok = ok && lum_rng_next(&a) == lum_rng_next(&b) && lum_rng_below(&a, bound) < bound;
+        lum_rng_below(&b, bound);
+        double d = lum_rng_double(&a);
+        lum_rng_double(&b);
+        ok = ok && d >= 0.0 && d < 1.0;
+    }
+
+    // Remplissage en masse : mêmes octets en scalaire et en SIMD, bits équilibrés
+    const size_t size = 65536 + 13;
+    uint8_t* simd = malloc(size);
+    uint8_t* scalar = malloc(size);
+    if (!simd || !scalar) {
+        free(simd);
+        free(scalar);
+        return 0;
+    }
+    lum_rng_fill(&a, simd, size);
+    lum_codec_force_level(LUM_CODEC_SCALAR);
+    lum_rng_fill(&b, scalar, size);
+    lum_codec_force_level(LUM_CODEC_AVX2);
+    size_t ones = 0;
+    for (size_t i = 0; i < size; i++) {
+        ones += (size_t)__builtin_popcount(simd[i]);
+    }
+    ok = ok && memcmp(simd, scalar, size) == 0 && lum_rng_next(&a) == lum_rng_next(&b) &&
+         ones > size * 4 - size / 25 && ones < size * 4 + size / 25;
+    free(simd);
+    free(scalar);
+
+    // Chaque thread tire de son propre flux
+    uint64_t first = 0, second = 0;
+    pthread_t t1, t2;
+    ok = ok && pthread_create(&t1, NULL, draw_thread_random, &first) == 0 &&
+         pthread_create(&t2, NULL, draw_thread_random, &second) == 0 &&
+         pthread_join(t1, NULL) == 0 && pthread_join(t2, NULL) == 0 && first != second;
+
+    if (ok) {
+        printf("      ✅ Flux reproductibles, remplissage SIMD identique au scalaire\n");
+        return 1;
+    }
+    printf("      ❌ Générateur incohérent\n");
+    return 0;
+}
+
+int test_inplace_operations() {
+    printf("   Test opérations en place...\n");
+
+    uint8_t data[40];
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 37 + 5);
+
+    // Chaque variante en place donne le même groupe que l'opération qui copie
+    LUMGroup* source = encode_array(data, 1, sizeof(data));
+    LUMGroup* other = encode_uint16(0xF0F0);
+    LUMGroup* cycled = source ? lum_cycle(source, 97) : NULL;
+    LUMGroup* flowed = source ? lum_flow(source, "zone_b") : NULL;
+    LUMGroup* fused = source && other ? lum_fusion(source, other) : NULL;
+    LUMGroup* small_fused = other ? lum_fusion(other, other) : NULL;
+    int ok = cycled && flowed && fused && small_fused;
+
+    // Un clone partagé garde les LUMs d'origine pendant que l'autre groupe écrit
+    LUMGroup* shared = ok ? clone_lum_group(source) : NULL;
+    LUMGroup* target = ok ? clone_lum_group(source) : NULL;
+    ok = ok && shared && target && lum_cycle_inplace(target, 97) == 0 &&
+         compare_lum_groups(target, cycled) == 0 && target->group_type == cycled->group_type &&
+         compare_lum_groups(shared, source) == 0;
+    free_lum_group(target);
+
+    target = ok ? clone_lum_group(source) : NULL;
+    ok = ok && target && lum_flow_inplace(target, "zone_b") == 0 &&
+         compare_lum_groups(target, flowed) == 0 && strcmp((char*)target->spatial_data, "zone_b") == 0;
+    free_lum_group(target);
+
+    // Cycle après flow : la zone cible disparaît comme avec lum_cycle
+    target = ok ? clone_lum_group(source) : NULL;
+    LUMGroup* flow_cycled = ok ? lum_cycle(flowed, 97) : NULL;
+    ok = ok && target && flow_cycled && lum_flow_inplace(target, "zone_b") == 0 &&
+         lum_cycle_inplace(target, 97) == 0 && compare_lum_groups(target, flow_cycled) == 0 &&
+         target->spatial_data == NULL && flow_cycled->spatial_data == NULL &&
+         target->group_type == flow_cycled->group_type && target->layout.kind == flow_cycled->layout.kind;
+    free_lum_group(target);
+    free_lum_group(flow_cycled);
+
+    target = ok ? clone_lum_group(source) : NULL;
+    ok = ok && target && lum_fusion_append(target, other) == 0 &&
+         compare_lum_groups(target, fused) == 0 && target->group_type == GROUP_CLUSTER;
+    free_lum_group(target);
+
+    // Petit groupe intégré qui grandit, puis cycle à zéro sur un groupe vide
+    target = ok ? lum_group_copy(other->lums, other->count, GROUP_LINEAR) : NULL;
+    if (target) target->layout = other->layout;
+    ok = ok && target && target->lums_inline && lum_fusion_append(target, other) == 0 &&
+         !target->lums_inline && compare_lum_groups(target, small_fused) == 0 &&
+         lum_cycle_inplace(target, 32) == 0 && target->count == 1 && target->lums[0].presence == 1;
+    free_lum_group(target);
+
+    // Stockage packed : même résultat via l'opération du backend
+    target = ok ? encode_array_packed(data, 1, sizeof(data)) : NULL;
+    ok = ok && target && lum_cycle_inplace(target, 97) == 0 &&
+         target->storage == LUM_STORAGE_PACKED && compare_lum_groups(target, cycled) == 0 &&
+         lum_flow_inplace(target, "zone_c") == 0 && strcmp((char*)target->spatial_data, "zone_c") == 0 &&
+         lum_cycle_inplace(target, 5) == 0 && target->spatial_data == NULL;
+    free_lum_group(target);
+
+    free_lum_group(source);
+    free_lum_group(other);
+    free_lum_group(shared);
+    free_lum_group(cycled);
+    free_lum_group(flowed);
+    free_lum_group(fused);
+    free_lum_group(small_fused);
+
+    if (ok) {
+        printf("      ✅ Cycle, flow et fusion en place identiques aux copies\n");
+        return 1;
+    }
+    printf("      ❌ Opérations en place divergentes\n");
+    return 0;
+}
+
+// Fusion de k groupes, référence : lum_fusion répété de gauche à droite
+static LUMGroup* fold_fusion(LUMGroup** groups, size_t count) {
+    LUMGroup* acc = clone_lum_group(groups[0]);
+    for (size_t i = 1; acc && i < count; i++) {
+        LUMGroup* next = lum_fusion(acc, groups[i]);
+        free_lum_group(acc);
+        acc = next;
+    }
+    return acc;
+}
+
+static int fused_match(LUMGroup* dense, LUMGroup* expected) {
+    if (!dense || !expected || dense->storage != LUM_STORAGE_DENSE) {
+        return 0;
+    }
+    if (expected->storage != LUM_STORAGE_DENSE) {
+        return groups_match(dense, expected);
+    }
+    if (dense->count != expected->count) {
+        return 0;
+    }
+    for (size_t i = 0; i < dense->count; i++) {
+        int x, y, ex, ey;
+        if (lum_group_position(dense, i, &x, &y) != 0 ||
+            lum_group_position(expected, i, &ex, &ey) != 0 || x != ex || y != ey ||
+            dense->lums[i].presence != expected->lums[i].presence ||
+            dense->lums[i].structure_type != expected->lums[i].structure_type) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int test_fusion_many() {
+    printf("   Test fusion de k groupes...\n");
+
+    uint8_t data[40];
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 53 + 11);
+
+    // Layouts différents : le résultat passe en positions explicites
+    LUMGroup* array = encode_array(data, 1, sizeof(data));
+    LUMGroup* groups[5] = {
+        encode_uint16(0xA5C3),
+        encode_binary_string("1101"),
+        array,
+        array ? compact_from_dense(array) : NULL,
+        encode_array_packed(data, 1, 8),
+    };
+    int ok = 1;
+    for (size_t i = 0; i < 5; i++) ok = ok && groups[i];
+
+    LUMGroup* fused = ok ? lum_fusion_many(groups, 5) : NULL;
+    LUMGroup* expected = ok ? fold_fusion(groups, 5) : NULL;
+    ok = ok && fused_match(fused, expected) && fused->group_type == GROUP_CLUSTER;
+    free_lum_group(fused);
+    free_lum_group(expected);
+
+    // Layouts linéaires enchaînés : le descripteur reste implicite
+    fused = ok ? lum_fusion_many(groups, 2) : NULL;
+    expected = ok ? fold_fusion(groups, 2) : NULL;
+    ok = ok && fused_match(fused, expected) && fused->layout.kind == expected->layout.kind;
+    free_lum_group(fused);
+    free_lum_group(expected);
+
+    // Positions packed / hybrides hors layout : conservées, y compris après un groupe vide
+    LUMGroup* odd = lum_group_create_small(3, GROUP_LINEAR);
+    if (odd) {
+        int odd_x[3] = {0, 20, 999}, odd_y[3] = {0, 0, 999};
+        for (int i = 0; i < 3; i++) odd->lums[i] = (LUM){(uint8_t)(i & 1), LUM_LINEAR, NULL, {odd_x[i], odd_y[i]}};
+    }
+    LUMGroup* empty = lum_group_create_small(0, GROUP_LINEAR);
+    LUMGroup* with_overrides[4] = {
+        odd ? packed_from_dense(odd) : NULL,
+        odd ? packed_from_dense(odd) : NULL,
+        odd ? hybrid_from_dense(odd) : NULL,
+        empty,
+    };
+    ok = ok && with_overrides[0] && with_overrides[1] && with_overrides[2] && empty &&
+         !lum_group_layout_complete(with_overrides[0]) && lum_group_layout_complete(odd);
+    fused = ok ? lum_fusion_many(with_overrides, 3) : NULL;
+    expected = ok ? fold_fusion(with_overrides, 3) : NULL;
+    ok = ok && fused_match(fused, expected);
+    free_lum_group(fused);
+    free_lum_group(expected);
+    LUMGroup* after_empty[2] = {empty, with_overrides[2]};
+    fused = ok ? lum_fusion_many(after_empty, 2) : NULL;
+    expected = ok ? fold_fusion(after_empty, 2) : NULL;
+    ok = ok && fused_match(fused, expected);
+    free_lum_group(fused);
+    free_lum_group(expected);
+    for (size_t i = 0; i < 4; i++) free_lum_group(with_overrides[i]);
+    free_lum_group(odd);
+
+    // Assez de LUMs pour remplir la sortie sur plusieurs threads
+    size_t big_size = 40000;
+    uint8_t* big_data = (uint8_t*)malloc(big_size);
+    LUMGroup* big[4] = {NULL, NULL, NULL, NULL};
+    if (big_data) {
+        for (size_t i = 0; i < big_size; i++) big_data[i] = (uint8_t)(i * 7 + 3);
+        for (size_t i = 0; i < 4; i++) big[i] = encode_array(big_data, 1, big_size - i * 1000);
+    }
+    ok = ok && big[0] && big[1] && big[2] && big[3];
+    fused = ok ? lum_fusion_many(big, 4) : NULL;
+    expected = ok ? fold_fusion(big, 4) : NULL;
+    ok = ok && fused_match(fused, expected);
+    free_lum_group(fused);
+    free_lum_group(expected);
+
+    for (size_t i = 0; i < 4; i++) free_lum_group(big[i]);
+    for (size_t i = 0; i < 5; i++) free_lum_group(groups[i]);
+    free(big_data);
+
+    if (ok) {
+        printf("      ✅ Fusion de k groupes identique aux fusions successives\n");
+        return 1;
+    }
+    printf("      ❌ Fusion de k groupes divergente\n");
+    return 0;
+}
+
+int test_parallel_layouts() {
+    printf("   Test layouts cercle/spirale par blocs...\n");
+
+    enum { COUNT = 200000 };
+    LUM* lums = (LUM*)malloc(sizeof(LUM) * COUNT);
+    int* xs = (int*)malloc(sizeof(int) * COUNT);
+    int* ys = (int*)malloc(sizeof(int) * COUNT);
+    int ok = lums && xs && ys;
+
+    // Spirale de référence : parcours séquentiel historique
+    LumLayout spiral = lum_layout_spiral(0.37, 3);
+    int radius = 0;
+    double angle = 0;
+    for (size_t i = 0; ok && i < COUNT; i++) {
+        xs[i] = (int)(radius * cos(angle));
+        ys[i] = (int)(radius * sin(angle));
+        angle += 0.37;
+        if (angle > 2 * 3.14159265359) {
+            angle = fmod(angle, 2 * 3.14159265359);
+            radius += 3;
+        }
+    }
+    if (ok) lum_layout_fill(&spiral, 0, COUNT, lums);
+    for (size_t i = 0; ok && i < COUNT; i++) {
+        ok = lums[i].position.x == xs[i] && lums[i].position.y == ys[i];
+    }
+
+    // Accès isolés dans le désordre, puis une plage au milieu
+    size_t probes[] = {COUNT - 1, 12345, 12346, 7, 150000, 0, 99999};
+    for (size_t k = 0; ok && k < sizeof(probes) / sizeof(probes[0]); k++) {
+        int x, y;
+        lum_layout_position(&spiral, probes[k], &x, &y);
+        ok = x == xs[probes[k]] && y == ys[probes[k]];
+    }
+    if (ok) lum_layout_fill(&spiral, 70001, COUNT - 70001, lums);
+    for (size_t i = 70001; ok && i < COUNT; i++) {
+        ok = lums[i - 70001].position.x == xs[i] && lums[i - 70001].position.y == ys[i];
+    }
+
+    // Parcours à rebours et deux spirales alternées : chaque accès repart
+    // d'un état mémorisé proche, pas de l'index 0
+    LumLayout shifted = spiral;
+    shifted.offset_x = 5;
+    for (size_t i = COUNT; ok && i-- > 0;) {
+        int x, y, sx, sy;
+        lum_layout_position(&spiral, i, &x, &y);
+        lum_layout_position(&shifted, i, &sx, &sy);
+        ok = x == xs[i] && y == ys[i] && sx == xs[i] + 5 && sy == ys[i];
+    }
+
+    // Cercle : formule fermée par index
+    LumLayout circle = lum_layout_circle(50, 50, 30, 97);
+    double step = 2.0 * 3.14159265359 / 97;
+    if (ok) lum_layout_fill(&circle, 3, COUNT - 3, lums);
+    for (size_t i = 3; ok && i < COUNT; i++) {
+        ok = lums[i - 3].position.x == (int)(50 + 30 * cos(i * step)) &&
+             lums[i - 3].position.y == (int)(50 + 30 * sin(i * step));
+    }
+
+    free(lums);
+    free(xs);
+    free(ys);
+
+    if (ok) {
+        printf("      ✅ Positions identiques au parcours séquentiel\n");
+        return 1;
+    }
+    printf("      ❌ Positions cercle/spirale divergentes\n");
+    return 0;
+}
+
+// Chaque groupe du split contient, dans l'ordre, les LUMs de son type
+static int contextual_split_matches(LUMGroup* source, LUMGroup** parts, size_t part_count) {
+    size_t seen = 0;
+    for (size_t p = 0; p < part_count; p++) {
+        LumStructureType type = parts[p]->lums[0].structure_type;
+        size_t k = 0;
+        for (size_t i = 0; i < source->count; i++) {
+            const LUM* lum = &source->lums[i];
+            if (lum->structure_type != type) continue;
+            if (k >= parts[p]->count || parts[p]->lums[k].presence != lum->presence ||
+                parts[p]->lums[k].structure_type != type) {
+                return 0;
+            }
+            k++;
+        }
+        if (k != parts[p]->count || !lum_group_is_view(parts[p]) ||
+            parts[p]->layout.offset_y != (int)type * 40) {
+            return 0;
+        }
+        seen += k;
+    }
+    return seen == source->count;
+}
+
+int test_contextual_split() {
+    printf("   Test split contextuel en une passe...\n");
+
+    size_t sizes[2] = {1000, (1 << 20) + 123};
+    int ok = 1;
+
+    // Tous les types, LUM_CLUSTER compris, puis assez de LUMs pour les threads
+    for (size_t s = 0; ok && s < 2; s++) {
+        LUMGroup* source = lum_group_alloc(sizes[s], GROUP_LINEAR);
+        ok = source != NULL;
+        for (size_t i = 0; ok && i < source->count; i++) {
+            source->lums[i].presence = (uint8_t)((i * 2654435761u) >> 7 & 1);
+            source->lums[i].structure_type = (LumStructureType)((i * 7 + i / 3) % LUM_STRUCTURE_TYPES);
+            source->lums[i].spatial_data = NULL;
+        }
+        if (source) source->layout = lum_layout_linear(0, 0, 20);
+
+        size_t part_count = 0;
+        LUMGroup** parts = ok ? lum_contextual_split(source, &part_count) : NULL;
+        ok = ok && parts && part_count == LUM_STRUCTURE_TYPES &&
+             parts[LUM_CLUSTER]->group_type == GROUP_CLUSTER &&
+             contextual_split_matches(source, parts, part_count);
+        free_split_result(parts, part_count);
+
+        // Sources packed et hybrides : même partition que la forme dense
+        LUMGroup* backends[2] = {ok && s == 0 ? packed_from_dense(source) : NULL,
+                                 ok && s == 0 ? hybrid_from_dense(source) : NULL};
+        for (size_t b = 0; ok && s == 0 && b < 2; b++) {
+            parts = backends[b] ? lum_contextual_split(backends[b], &part_count) : NULL;
+            ok = parts && part_count == LUM_STRUCTURE_TYPES && contextual_split_matches(source, parts, part_count);
+            free_split_result(parts, part_count);
+        }
+        free_lum_group(backends[0]);
+        free_lum_group(backends[1]);
+        free_lum_group(source);
+    }
+
+    // Un seul type : copie si la source n'est pas partagée (elle reste intacte),
+    // vue directe sinon
+    LUMGroup* single = encode_binary_string("1100101");
+    size_t single_count = 0;
+    LUM* single_lums = single ? single->lums : NULL;
+    LUMGroup** single_parts = single ? lum_contextual_split(single, &single_count) : NULL;
+    ok = ok && single_parts && single_count == 1 && single->lums == single_lums &&
+         !lum_group_is_view(single) && single_parts[0]->lums != single->lums &&
+         contextual_split_matches(single, single_parts, single_count);
+    free_split_result(single_parts, single_count);
+    LUMGroup* single_clone = single ? lum_group_clone_cow(single) : NULL;
+    single_parts = single_clone ? lum_contextual_split(single, &single_count) : NULL;
+    ok = ok && single_parts && single_count == 1 && single_parts[0]->lums == single_clone->lums &&
+         contextual_split_matches(single, single_parts, single_count);
+    free_split_result(single_parts, single_count);
+    free_lum_group(single_clone);
+    free_lum_group(single);
+
+    if (ok) {
+        printf("      ✅ Partition stable par type dans un tampon partagé\n");
+        return 1;
+    }
+    printf("      ❌ Split contextuel divergent\n");
+    return 0;
+}
+
+// Opérations de base sur un groupe, comparées entre deux configurations
+typedef struct {
+    LUMGroup* fused;
+    LUMGroup* mixed;    // Fusion en positions explicites
+    LUMGroup* flowed;
+    LUMGroup* cycled;
+    LUMGroup** zones;
+    size_t zone_count;
+    LUMGroup** types;
+    size_t type_count;
+    LUMGroup* organic;
+} PoolResults;
+
+static void run_pool_operations(LUMGroup* source, LUMGroup* circle, PoolResults* r) {
+    r->fused = lum_fusion(source, source);
+    r->mixed = lum_fusion(circle, source);
+    r->flowed = lum_flow(source, "zone_p");
+    r->cycled = lum_cycle(source, 100003);
+    r->zones = lum_split(source, 7, &r->zone_count);
+    r->types = lum_contextual_split(source, &r->type_count);
+    LUMGroup* parts[3] = {source, circle, source};
+    r->organic = lum_fusion_many(parts, 3);
+}
+
+static void free_pool_results(PoolResults* r) {
+    free_lum_group(r->fused);
+    free_lum_group(r->mixed);
+    free_lum_group(r->flowed);
+    free_lum_group(r->cycled);
+    free_split_result(r->zones, r->zone_count);
+    free_split_result(r->types, r->type_count);
+    free_lum_group(r->organic);
+}
+
+int test_parallel_pool() {
+    printf("   Test pool de threads...\n");
+
+    enum { COUNT = 60000 };
+    LUMGroup* source = lum_group_alloc(COUNT, GROUP_LINEAR);
+    int ok = source != NULL;
+    for (size_t i = 0; ok && i < COUNT; i++) {
+        source->lums[i].presence = (uint8_t)(i % 3 == 1);
+        // Zones 0 et 1 restent linéaires : vues, les autres sont copiées
+        source->lums[i].structure_type = i < COUNT / 3 ? LUM_LINEAR : (LumStructureType)(i % 4);
+        source->lums[i].spatial_data = NULL;
+    }
+    if (source) source->layout = lum_layout_linear(0, 0, 20);
+    LUMGroup* circle = ok ? lum_cycle(source, 5003) : NULL;
+    ok = ok && circle;
+
+    // Série, puis pool à 4 threads avec un seuil bas
+    // Source non partagée : lue seulement, zones copiées ; partagée : vues
+    PoolResults serial = {0}, parallel = {0};
+    LUM* before = source ? source->lums : NULL;
+    lum_parallel_configure(0, 1);
+    if (ok) run_pool_operations(source, circle, &serial);
+    ok = ok && source->lums == before && !lum_group_is_view(source);
+    for (size_t i = 0; ok && i < serial.zone_count; i++) {
+        ok = !lum_group_is_view(serial.zones[i]);
+    }
+    ok = ok && lum_group_share(source) == 0;
+    lum_parallel_configure(1000, 4);
+    if (ok) run_pool_operations(source, circle, &parallel);
+    // Tâches emboîtées : exécutées en série sans bloquer le pool
+    LUMGroup* nested = ok ? lum_fusion(parallel.mixed, parallel.mixed) : NULL;
+    lum_parallel_configure(0, 0);
+
+    ok = ok && fused_match(parallel.fused, serial.fused) && fused_match(parallel.mixed, serial.mixed) &&
+         fused_match(parallel.flowed, serial.flowed) && fused_match(parallel.cycled, serial.cycled) &&
+         fused_match(parallel.organic, serial.organic) && nested && nested->count == 2 * serial.mixed->count &&
+         parallel.zone_count == serial.zone_count && parallel.type_count == serial.type_count;
+    for (size_t i = 0; ok && i < serial.zone_count; i++) {
+        ok = fused_match(parallel.zones[i], serial.zones[i]) &&
+             lum_group_is_view(parallel.zones[i]) == (i < 2);
+    }
+    for (size_t i = 0; ok && i < serial.type_count; i++) {
+        ok = fused_match(parallel.types[i], serial.types[i]);
+    }
+
+    free_pool_results(&serial);
+    free_pool_results(&parallel);
+    free_lum_group(nested);
+    free_lum_group(circle);
+    free_lum_group(source);
+    lum_parallel_shutdown();
+
+    if (ok) {
+        printf("      ✅ Résultats du pool identiques au chemin série\n");
+        return 1;
+    }
+    printf("      ❌ Résultats du pool divergents\n");
+    return 0;
+}
+
+// Les quatre réductions d'un groupe, pour comparer deux configurations
+typedef struct {
+    size_t ones;
+    uint64_t hash;
+    size_t types[LUM_STRUCTURE_TYPES + 1];
+    LumBounds bounds;
+} GroupReductions;
+
+static int reduce_group(LUMGroup* group, GroupReductions* out) {
+    out->ones = lum_group_popcount(group);
+    out->hash = lum_group_hash(group);
+    return lum_group_type_histogram(group, out->types) == 0 && lum_group_bounds(group, &out->bounds) == 0;
+}
+
+static int same_reductions(const GroupReductions* a, const GroupReductions* b) {
+    return a->ones == b->ones && a->hash == b->hash &&
+           memcmp(a->types, b->types, sizeof(a->types)) == 0 &&
+           a->bounds.min_x == b->bounds.min_x && a->bounds.min_y == b->bounds.min_y &&
+           a->bounds.max_x == b->bounds.max_x && a->bounds.max_y == b->bounds.max_y;
+}
+
+int test_group_reductions() {
+    printf("   Test réductions sur groupes...\n");
+
+    // Plus d'un million de LUMs : plusieurs blocs, dernier bloc partiel
+    size_t count = (1 << 20) + 4321;
+    LUMGroup* dense = lum_group_alloc(count, GROUP_LINEAR);
+    int ok = dense != NULL;
+    size_t ones = 0, types[LUM_STRUCTURE_TYPES + 1] = {0};
+    for (size_t i = 0; ok && i < count; i++) {
+        dense->lums[i].presence = (uint8_t)((i * 2654435761u) >> 11 & 1);
+        dense->lums[i].structure_type = (LumStructureType)(i / 1000 % 7); // 5 et 6 : inattendus
+        dense->lums[i].spatial_data = NULL;
+        ones += dense->lums[i].presence;
+        types[i / 1000 % 7 < LUM_STRUCTURE_TYPES ? i / 1000 % 7 : LUM_STRUCTURE_TYPES]++;
+    }
+    if (dense) dense->layout = lum_layout_grid(-40, 10, 20, 1000, 30);
+
+    GroupReductions serial, parallel, level;
+    lum_parallel_configure(0, 1);
+    ok = ok && reduce_group(dense, &serial) && serial.ones == ones &&
+         memcmp(serial.types, types, sizeof(types)) == 0 &&
+         serial.bounds.min_x == -40 && serial.bounds.max_x == -40 + 999 * 20 &&
+         serial.bounds.min_y == 10 && serial.bounds.max_y == 10 + (int)((count - 1) / 1000) * 30;
+
+    // Pool et noyaux scalaires : mêmes valeurs
+    lum_parallel_configure(1000, 4);
+    ok = ok && reduce_group(dense, &parallel) && same_reductions(&serial, &parallel);
+    LumCodecLevel detected = lum_codec_level();
+    lum_codec_force_level(LUM_CODEC_SCALAR);
+    ok = ok && reduce_group(dense, &level) && same_reductions(&serial, &level);
+    lum_codec_force_level(detected);
+    lum_parallel_configure(0, 0);
+
+    // Popcount, hash et distance indépendants du stockage
+    LUMGroup* others[4] = {
+        ok ? packed_from_dense(dense) : NULL,
+        ok ? compact_from_dense(dense) : NULL,
+        ok ? soa_from_dense(dense) : NULL,
+        ok ? hybrid_from_dense(dense) : NULL,
+    };
+    for (int k = 0; ok && k < 4; k++) {
+        ok = others[k] && lum_group_popcount(others[k]) == ones &&
+             lum_group_hash(others[k]) == serial.hash && lum_group_hamming(dense, others[k]) == 0 &&
+             compare_lum_groups(dense, others[k]) == 0;
+    }
+
+    // Deux bits changés : distance 2, hash différent
+    LUMGroup* flipped = ok ? clone_lum_group(dense) : NULL;
+    if (flipped) {
+        flipped->lums[7].presence ^= 1;
+        flipped->lums[count - 1].presence ^= 1;
+    }
+    ok = ok && flipped && lum_group_hamming(flipped, others[3]) == 2 &&
+         lum_group_hash(flipped) != serial.hash && compare_lum_groups(flipped, others[0]) != 0;
+    LUMGroup* shorter = ok ? encode_binary_string("101") : NULL;
+    ok = ok && shorter && lum_group_hamming(dense, shorter) == SIZE_MAX;
+
+    for (int k = 0; k < 4; k++) free_lum_group(others[k]);
+    free_lum_group(flipped);
+    free_lum_group(shorter);
+    free_lum_group(dense);
+    lum_parallel_shutdown();
+
+    if (ok) {
+        printf("      ✅ Réductions déterministes, identiques entre stockages\n");
+        return 1;
+    }
+    printf("      ❌ Réductions divergentes\n");
+    return 0;
+}
+
+// Lit un noeud du pipeline et le compare au résultat eager (libéré ici)
+static int pipeline_matches(LumPipeline* pipeline, int node, LUMGroup* expected) {
+    LUMGroup* lazy = node >= 0 ? lum_pipeline_read(pipeline, node) : NULL;
+    int ok = lazy && fused_match(lazy, expected) &&
+             lum_pipeline_count(pipeline, node) == expected->count;
+    free_lum_group(lazy);
+    free_lum_group(expected);
+    return ok;
+}
+
+int test_lazy_pipeline() {
+    printf("   Test pipeline d'opérations paresseux...\n");
+
+    enum { COUNT_A = 5000, COUNT_B = 3001, COUNT_C = 700 };
+    LUMGroup* a = lum_group_alloc(COUNT_A, GROUP_LINEAR);
+    LUMGroup* b = lum_group_alloc(COUNT_B, GROUP_LINEAR);
+    LUMGroup* c = lum_group_alloc(COUNT_C, GROUP_LINEAR); // Positions explicites
+    int ok = a && b && c;
+    for (size_t i = 0; ok && i < COUNT_A; i++) {
+        a->lums[i] = (LUM){(uint8_t)(i % 3 == 0), (LumStructureType)(i % 4), NULL, {0, 0}};
+        if (i < COUNT_B) b->lums[i] = (LUM){(uint8_t)(i % 5 < 2), LUM_NODE, NULL, {0, 0}};
+        if (i < COUNT_C) c->lums[i] = (LUM){(uint8_t)(i & 1), LUM_LINEAR, NULL, {(int)(i * 7 % 101), -(int)i}};
+    }
+    if (ok) {
+        a->layout = lum_layout_linear(0, 0, 20);
+        b->layout = lum_layout_grid(5, 5, 20, 64, 40);
+    }
+    LUMGroup* packed_a = ok ? packed_from_dense(a) : NULL;
+    LumPipeline* pipeline = lum_pipeline_create();
+    ok = ok && packed_a && pipeline;
+
+    int na = ok ? lum_pipeline_input(pipeline, a) : -1;
+    int nb = ok ? lum_pipeline_input(pipeline, b) : -1;
+    int nc = ok ? lum_pipeline_input(pipeline, c) : -1;
+    int np = ok ? lum_pipeline_input(pipeline, packed_a) : -1;
+
+    // fusion -> cycle -> flow, en une passe sur les 7999 % 13 premiers LUMs
+    int fused = lum_pipeline_fusion(pipeline, na, nb);
+    int cycled = lum_pipeline_cycle(pipeline, fused, 13);
+    int flowed = lum_pipeline_flow(pipeline, cycled, "zone_b");
+    LUMGroup* eager_fused = ok ? lum_fusion(a, b) : NULL;
+    LUMGroup* eager_cycled = eager_fused ? lum_cycle(eager_fused, 13) : NULL;
+    LUMGroup* eager_flowed = eager_cycled ? lum_flow(eager_cycled, "zone_b") : NULL;
+    LUMGroup* lazy_flowed = ok ? lum_pipeline_read(pipeline, flowed) : NULL;
+    ok = ok && eager_flowed && lazy_flowed && lazy_flowed->spatial_data &&
+         strcmp((const char*)lazy_flowed->spatial_data, "zone_b") == 0;
+    free_lum_group(lazy_flowed);
+
+    // Écrire dans un résultat ne touche ni le noeud en cache ni l'entrée
+    LUMGroup* first_read = ok ? lum_pipeline_read(pipeline, cycled) : NULL;
+    LUMGroup* input_read = ok ? lum_pipeline_read(pipeline, na) : NULL;
+    ok = ok && first_read && first_read->count > 0 && input_read && !lum_group_is_view(first_read) &&
+         !lum_group_is_view(input_read) && !lum_group_is_view(a);
+    if (ok) {
+        first_read->lums[0].presence ^= 1;
+        input_read->lums[0].presence ^= 1;
+        ok = input_read->lums[0].presence != a->lums[0].presence;
+    }
+    free_lum_group(first_read);
+    free_lum_group(input_read);
+    ok = ok && pipeline_matches(pipeline, flowed, eager_flowed);
+    ok = ok && pipeline_matches(pipeline, cycled, eager_cycled);
+
+    // Positions explicites à travers flow et fusion, entrée packed
+    int mixed = lum_pipeline_fusion(pipeline, lum_pipeline_flow(pipeline, nc, "z"), np);
+    LUMGroup* flowed_c = ok ? lum_flow(c, "z") : NULL;
+    ok = ok && flowed_c && pipeline_matches(pipeline, mixed, lum_fusion(flowed_c, a));
+
+    // Entrées packed / hybrides à positions hors layout : jamais déduites du seul layout
+    LUMGroup* odd = lum_group_alloc(300, GROUP_LINEAR);
+    for (size_t i = 0; odd && i < 300; i++) {
+        int off = i % 50 == 2;
+        odd->lums[i] = (LUM){(uint8_t)(i % 3 != 0), LUM_LINEAR, NULL,
+                             {off ? 999 : (int)i * 20, off ? 999 : 0}};
+    }
+    LUMGroup* odd_packed = odd ? packed_from_dense(odd) : NULL;
+    LUMGroup* odd_hybrid = odd ? hybrid_from_dense(odd) : NULL;
+    ok = ok && odd_packed && odd_hybrid && !lum_group_layout_complete(odd_packed) &&
+         !lum_group_layout_complete(odd_hybrid);
+    int nop = ok ? lum_pipeline_input(pipeline, odd_packed) : -1;
+    int noh = ok ? lum_pipeline_input(pipeline, odd_hybrid) : -1;
+    ok = ok && pipeline_matches(pipeline, lum_pipeline_flow(pipeline, nop, "z"), lum_flow(odd_packed, "z"));
+    ok = ok && pipeline_matches(pipeline, lum_pipeline_flow(pipeline, noh, "z"), lum_flow(odd_hybrid, "z"));
+    LUMGroup* odd_flowed = ok ? lum_flow(odd_hybrid, "z") : NULL;
+    ok = ok && odd_flowed &&
+         pipeline_matches(pipeline, lum_pipeline_fusion(pipeline, nop, lum_pipeline_flow(pipeline, noh, "z")),
+                          lum_fusion(odd_packed, odd_flowed));
+    ok = ok && pipeline_matches(pipeline, lum_pipeline_fusion(pipeline, na, nop), lum_fusion(a, odd_packed));
+    size_t odd_zone_count = 0;
+    int odd_zones = ok ? lum_pipeline_split(pipeline, lum_pipeline_flow(pipeline, noh, "z"), 3) : -1;
+    LUMGroup** odd_eager_zones = odd_flowed ? lum_split(odd_flowed, 3, &odd_zone_count) : NULL;
+    ok = ok && odd_zones >= 0 && odd_eager_zones && odd_zone_count == 3;
+    for (size_t i = 0; ok && i < odd_zone_count; i++) {
+        ok = pipeline_matches(pipeline, odd_zones + (int)i, clone_lum_group(odd_eager_zones[i]));
+    }
+    free_split_result(odd_eager_zones, odd_zone_count);
+
+    // Zones du split, cycle sans reste
+    int zones = lum_pipeline_split(pipeline, mixed, 4);
+    LUMGroup* eager_mixed = ok ? lum_fusion(flowed_c, a) : NULL;
+    size_t zone_count = 0;
+    LUMGroup** eager_zones = eager_mixed ? lum_split(eager_mixed, 4, &zone_count) : NULL;
+    ok = ok && eager_zones && zone_count == 4 && zones >= 0;
+    for (size_t i = 0; ok && i < zone_count; i++) {
+        ok = pipeline_matches(pipeline, zones + (int)i, clone_lum_group(eager_zones[i]));
+    }
+    ok = ok && pipeline_matches(pipeline, lum_pipeline_cycle(pipeline, nb, 3001), lum_cycle(b, 3001));
+
+    // Pool : mêmes LUMs, après lecture du noeud fusionné (relu depuis le cache)
+    lum_parallel_configure(1000, 4);
+    LumPipeline* fresh = ok ? lum_pipeline_create() : NULL;
+    int deep = fresh ? lum_pipeline_fusion(fresh, lum_pipeline_input(fresh, b),
+                                           lum_pipeline_flow(fresh, lum_pipeline_input(fresh, c), "z")) : -1;
+    LUMGroup* eager_deep = fresh ? lum_fusion(b, flowed_c) : NULL;
+    ok = ok && eager_deep && pipeline_matches(fresh, deep, clone_lum_group(eager_deep));
+    ok = ok && pipeline_matches(fresh, lum_pipeline_cycle(fresh, deep, 1234), lum_cycle(eager_deep, 1234));
+    lum_parallel_configure(0, 0);
+
+    // Arguments invalides
+    ok = ok && lum_pipeline_cycle(pipeline, na, 0) == -1 && lum_pipeline_fusion(pipeline, na, 999) == -1 &&
+         lum_pipeline_flow(pipeline, na, NULL) == -1 && lum_pipeline_split(pipeline, na, 0) == -1;
+
+    free_split_result(eager_zones, zone_count);
+    free_lum_group(eager_mixed);
+    free_lum_group(eager_deep);
+    free_lum_group(flowed_c);
+    free_lum_group(eager_fused);
+    lum_pipeline_free(fresh);
+    lum_pipeline_free(pipeline);
+    free_lum_group(packed_a);
+    free_lum_group(odd_flowed);
+    free_lum_group(odd_packed);
+    free_lum_group(odd_hybrid);
+    free_lum_group(odd);
+    free_lum_group(a);
+    free_lum_group(b);
+    free_lum_group(c);
+    lum_parallel_shutdown();
+
+    if (ok) {
+        printf("      ✅ Chaînes paresseuses identiques aux opérations successives\n");
+        return 1;
+    }
+    printf("      ❌ Pipeline divergent des opérations successives\n");
+    return 0;
+}
+
+int test_batch_operations() {
+    printf("   Test opérations par lots...\n");
+
+    enum { OPS = 2000 };
+    LUMGroup** left = (LUMGroup**)calloc(OPS, sizeof(LUMGroup*));
+    LUMGroup** right = (LUMGroup**)calloc(OPS, sizeof(LUMGroup*));
+    int* params = (int*)malloc(sizeof(int) * OPS);
+    int ok = left && right && params;
+    for (size_t i = 0; ok && i < OPS; i++) {
+        left[i] = encode_uint8((uint8_t)i);
+        right[i] = encode_uint32((uint32_t)(i * 2654435761u));
+        params[i] = (int)(i % 5); // 0 : argument invalide
+        ok = left[i] && right[i];
+    }
+    // Un opérande packed, une paire incomplète
+    if (ok) {
+        LUMGroup* packed = packed_from_dense(right[1]);
+        ok = packed != NULL;
+        free_lum_group(right[1]);
+        right[1] = packed;
+        free_lum_group(left[2]);
+        left[2] = NULL;
+    }
+
+    LumBatch* fused = ok ? lum_fusion_batch(left, right, OPS, NULL) : NULL;
+    ok = ok && fused && fused->op_count == OPS && fused->failed == 1 && fused->first[3] - fused->first[2] == 0;
+    for (size_t i = 0; ok && i < OPS; i++) {
+        if (i == 2) continue;
+        LUMGroup* got = fused->groups[fused->first[i]];
+        LUMGroup* expected = lum_fusion(left[i], right[i]);
+        ok = fused->first[i + 1] - fused->first[i] == 1 && (i == 1 || got->arena == fused->arena) &&
+             (got->storage == LUM_STORAGE_DENSE ? fused_match(got, expected) :
+              expected && got->count == expected->count && lum_group_hamming(got, expected) == 0);
+        free_lum_group(expected);
+    }
+
+    LumBatch* cycled = ok ? lum_cycle_batch(right, params, OPS, NULL) : NULL;
+    ok = ok && cycled && cycled->failed == OPS / 5;
+    for (size_t i = 0; ok && i < OPS; i += 7) {
+        size_t produced = cycled->first[i + 1] - cycled->first[i];
+        LUMGroup* expected = params[i] > 0 ? lum_cycle(right[i], params[i]) : NULL;
+        ok = produced == (params[i] > 0) &&
+             (!expected || (right[i]->storage != LUM_STORAGE_DENSE ?
+                            lum_group_hamming(cycled->groups[cycled->first[i]], expected) == 0 :
+                            fused_match(cycled->groups[cycled->first[i]], expected)));
+        free_lum_group(expected);
+    }
+
+    // Arène de l'appelant : zones de tailles variables, vues des sources
+    // partagées comprises, tout est rendu à l'arène
+    for (size_t i = 0; ok && i < 50; i += 2) {
+        ok = !left[i] || lum_group_share(left[i]) == 0;
+    }
+    LumArena* arena = lum_arena_create(0);
+    LumBatch* split = ok && arena ? lum_split_batch(left, params, 50, arena) : NULL;
+    ok = ok && split && split->arena == arena && !split->owns_arena && split->failed == 11;
+    size_t views = 0;
+    for (size_t i = 0; ok && i < 50; i++) {
+        size_t zone_count = 0;
+        LUMGroup** expected = left[i] && params[i] > 0 ? lum_split(left[i], params[i], &zone_count) : NULL;
+        ok = split->first[i + 1] - split->first[i] == zone_count;
+        for (size_t z = 0; ok && z < zone_count; z++) {
+            LUMGroup* zone = split->groups[split->first[i] + z];
+            ok = fused_match(zone, expected[z]) && zone->arena == arena;
+            views += lum_group_is_view(zone);
+        }
+        free_split_result(expected, zone_count);
+    }
+    lum_batch_free(split);
+    ok = ok && views > 0 && arena->bytes_used == 0;
+    lum_arena_destroy(arena);
+    // Arène propre au lot : vues libérées avec elle
+    split = ok ? lum_split_batch(left, params, 50, NULL) : NULL;
+    ok = ok && split && split->failed == 11;
+    lum_batch_free(split);
+
+    lum_batch_free(fused);
+    lum_batch_free(cycled);
+    for (size_t i = 0; left && right && i < OPS; i++) {
+        free_lum_group(left[i]);
+        free_lum_group(right[i]);
+    }
+    free(left);
+    free(right);
+    free(params);
+
+    if (ok) {
+        printf("      ✅ Lots identiques aux appels unitaires, résultats dans une arène\n");
+        return 1;
+    }
+    printf("      ❌ Résultats par lots divergents\n");
+    return 0;
+}
+
+// Le hash en cache correspond-il au contenu actuel ?
+static int hash_current(LUMGroup* group) {
+    return group && group->hash_cached && lum_group_content_hash(group) == lum_group_hash(group);
+}
+
+int test_content_hash() {
+    printf("   Test hash de contenu en cache...\n");
+
+    enum { COUNT = 100003 };
+    LUMGroup* dense = lum_group_alloc(COUNT, GROUP_LINEAR);
+    LUMGroup* tail = lum_group_alloc(777, GROUP_LINEAR);
+    int ok = dense && tail;
+    for (size_t i = 0; ok && i < COUNT; i++) {
+        dense->lums[i] = (LUM){(uint8_t)((i * 2654435761u) >> 13 & 1), LUM_LINEAR, NULL, {0, 0}};
+        if (i < 777) tail->lums[i] = (LUM){(uint8_t)(i % 3 == 0), LUM_LINEAR, NULL, {0, 0}};
+    }
+    if (ok) {
+        dense->layout = lum_layout_linear(0, 0, 20);
+        tail->layout = lum_layout_linear(0, 0, 20);
+    }
+
+    // Même hash pour chaque stockage, conservé par les clones
+    LUMGroup* packed = ok ? packed_from_dense(dense) : NULL;
+    LUMGroup* hybrid = ok ? hybrid_from_dense(dense) : NULL;
+    ok = ok && packed && hybrid && !dense->hash_cached &&
+         lum_group_content_hash(dense) == lum_group_hash(dense) &&
+         lum_group_content_hash(packed) == lum_group_content_hash(dense) &&
+         lum_group_content_hash(hybrid) == lum_group_content_hash(dense);
+    LUMGroup* clone = ok ? clone_lum_group(dense) : NULL;
+    ok = ok && hash_current(clone) && lum_groups_identical(clone, dense) && lum_groups_identical(packed, dense);
+
+    // Mises à jour incrémentales des opérations en place
+    ok = ok && lum_fusion_append(clone, tail) == 0 && hash_current(clone) && clone->count == COUNT + 777;
+    ok = ok && lum_fusion_append(clone, packed) == 0 && hash_current(clone);
+    for (size_t i = 0; ok && i < 200; i++) {
+        size_t index = i * 499 % COUNT;
+        ok = hybrid_set_presence(hybrid, index, (uint8_t)!hybrid_get_presence(hybrid, index)) == 0 &&
+             hash_current(hybrid);
+    }
+    ok = ok && lum_flow_inplace(packed, "zone_b") == 0 && hash_current(packed);
+    ok = ok && lum_cycle_inplace(clone, 65537) == 0 && hash_current(clone);
+    ok = ok && lum_cycle_inplace(packed, 4099) == 0 && hash_current(packed);
+
+    // Hashes différents : rejet immédiat ; après écriture directe, lum_group_touch
+    LUMGroup* other = ok ? clone_lum_group(dense) : NULL;
+    ok = ok && other && lum_group_detach(other) == 0;
+    if (ok) {
+        other->lums[COUNT / 2].presence ^= 1;
+        lum_group_touch(other);
+    }
+    ok = ok && lum_group_content_hash(other) != lum_group_content_hash(dense) &&
+         compare_lum_groups(other, dense) == 1;
+    if (ok) {
+        other->lums[COUNT / 2].presence ^= 1;
+        other->lums[7].structure_type = LUM_NODE;
+        lum_group_touch(other);
+    }
+    ok = ok && compare_lum_groups(other, dense) == 0 && !lum_groups_identical(other, dense);
+
+    // Écritures via lum_group_writable / lum_group_detach : cache abandonné,
+    // le rejet rapide sur hash ne voit jamais de valeur périmée
+    ok = ok && lum_group_content_hash(other) != 0;
+    LUMGroup* twin = ok ? clone_lum_group(other) : NULL;
+    LUM* other_lums = twin && hash_current(twin) ? lum_group_writable(other) : NULL;
+    ok = ok && other_lums && !other->hash_cached && lum_group_detach(twin) == 0 && !twin->hash_cached;
+    if (ok) {
+        other_lums[11].presence ^= 1;
+        twin->lums[11].presence ^= 1;
+    }
+    ok = ok && lum_group_content_hash(other) == lum_group_hash(other) &&
+         lum_group_content_hash(twin) == lum_group_hash(twin) && lum_group_content_hash(dense) != 0 &&
+         compare_lum_groups(other, twin) == 0 && lum_groups_identical(other, twin) &&
+         compare_lum_groups(other, dense) == 1;
+
+    free_lum_group(twin);
+    free_lum_group(other);
+    free_lum_group(clone);
+    free_lum_group(hybrid);
+    free_lum_group(packed);
+    free_lum_group(tail);
+    free_lum_group(dense);
+
+    if (ok) {
+        printf("      ✅ Hash maintenu par les opérations en place, comparaison rapide\n");
+        return 1;
+    }
+    printf("      ❌ Hash de contenu incohérent\n");
+    return 0;
+}
+
+int test_organic_fusion_storages() {
+    printf("   Test fusion organique tous stockages...\n");
+
+    uint8_t data[24];
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 37 + 11);
+    LUMGroup* dense = encode_array(data, 1, sizeof(data));
+    LUMGroup* parts[5] = {
+        dense,
+        dense ? packed_from_dense(dense) : NULL,
+        dense ? compact_from_dense(dense) : NULL,
+        dense ? soa_from_dense(dense) : NULL,
+        dense ? hybrid_from_dense(dense) : NULL,
+    };
+    int ok = parts[0] && parts[1] && parts[2] && parts[3] && parts[4];
+
+    // Chaque entrée compte, dans l'ordre, marquée LUM_GROUP
+    LUMGroup* organic = ok ? lum_organic_fusion(parts, 5) : NULL;
+    ok = ok && organic && organic->count == 5 * dense->count && organic->layout.kind == LUM_LAYOUT_SPIRAL;
+    for (size_t i = 0; ok && i < organic->count; i++) {
+        ok = organic->lums[i].presence == dense->lums[i % dense->count].presence &&
+             organic->lums[i].structure_type == LUM_GROUP;
+    }
+
+    free_lum_group(organic);
+    for (int k = 0; k < 5; k++) free_lum_group(parts[k]);
+
+    if (ok) {
+        printf("      ✅ Aucune entrée ignorée, quel que soit le stockage\n");
+        return 1;
+    }
+    printf("      ❌ Entrées perdues par la fusion organique\n");
+    return 0;
+}
+
+static void* read_codec_levels(void* arg) {
+    int* bad = (int*)arg;
+    for (int i = 0; i < 20000; i++) {
+        LumCodecLevel level = lum_codec_level();
+        if (level < LUM_CODEC_SCALAR || level > LUM_CODEC_AVX2) (*bad)++;
+    }
+    return NULL;
+}
+
+int test_codec_level_threads() {
+    printf("   Test niveau SIMD lu par plusieurs threads...\n");
+
+    // Lectures concurrentes pendant que le niveau change : jamais -1
+    LumCodecLevel detected = lum_codec_level();
+    pthread_t threads[3];
+    int bad[3] = {0, 0, 0};
+    int started = 0;
+    for (int t = 0; t < 3; t++) {
+        started += pthread_create(&threads[t], NULL, read_codec_levels, &bad[t]) == 0;
+    }
+    for (int i = 0; i < 2000; i++) {
+        lum_codec_force_level((LumCodecLevel)(i % 3));
+    }
+    for (int t = 0; t < started; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    lum_codec_force_level(LUM_CODEC_SCALAR);
+    int ok = started == 3 && bad[0] + bad[1] + bad[2] == 0 && lum_codec_level() == LUM_CODEC_SCALAR;
+    lum_codec_force_level(detected);
+    ok = ok && lum_codec_level() == detected;
+
+    if (ok) {
+        printf("      ✅ Détection et forçage sans état transitoire\n");
+        return 1;
+    }
+    printf("      ❌ Niveau SIMD incohérent entre threads\n");
+    return 0;
+}
+
+int test_content_dedup() {
+    printf("   Test index de déduplication par contenu...\n");
+
+    uint8_t data[40];
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 73 + 5);
+    LUMGroup* dense = encode_array(data, 1, sizeof(data));
+    LUMGroup* packed = dense ? packed_from_dense(dense) : NULL;
+    LUMGroup* hybrid = dense ? hybrid_from_dense(dense) : NULL;
+    LUMGroup* flowed = dense ? lum_flow(dense, "zone_b") : NULL;
+    LUMGroup* retyped = dense ? clone_lum_group(dense) : NULL;
+    LUMGroup* written = dense ? clone_lum_group(dense) : NULL;
+    LumDedup* dedup = lum_dedup_create();
+    int ok = dense && packed && hybrid && flowed && retyped && written && dedup &&
+             lum_group_detach(retyped) == 0;
+    // Hash mis en cache puis écriture : le clone stocké n'hérite d'aucun cache périmé
+    LUM* written_lums = ok && lum_group_content_hash(written) ? lum_group_writable(written) : NULL;
+    ok = ok && written_lums;
+    if (ok) {
+        retyped->lums[9].structure_type = LUM_NODE;
+        written_lums[5].presence ^= 1;
+    }
+
+    LUMGroup* stored = ok ? clone_lum_group(dense) : NULL;
+    LUMGroup* stored_written = ok ? clone_lum_group(written) : NULL;
+    ok = ok && stored && stored_written && lum_dedup_find(dedup, dense) == NULL &&
+         lum_dedup_add(dedup, stored) == 0 && lum_dedup_add(dedup, stored_written) == 0;
+
+    // Même contenu quel que soit le stockage ; positions, types ou présence différents : absent
+    ok = ok && lum_dedup_find(dedup, dense) == stored && lum_dedup_find(dedup, packed) == stored &&
+         lum_dedup_find(dedup, hybrid) == stored && lum_dedup_find(dedup, flowed) == NULL &&
+         lum_dedup_find(dedup, retyped) == NULL && lum_dedup_find(dedup, written) == stored_written;
+    ok = ok && lum_groups_identical(packed, hybrid) && !lum_groups_identical(flowed, packed) &&
+         !lum_groups_identical(retyped, hybrid);
+
+    lum_dedup_remove(dedup, stored);
+    ok = ok && lum_dedup_find(dedup, packed) == NULL && lum_dedup_find(dedup, written) == stored_written;
+
+    // Assez d'entrées pour agrandir la table : chacune reste trouvée
+    enum { MANY = 300 };
+    LUMGroup* many[MANY] = {NULL};
+    for (size_t k = 0; ok && k < MANY; k++) {
+        many[k] = lum_group_alloc(64, GROUP_LINEAR);
+        ok = many[k] != NULL;
+        for (size_t i = 0; ok && i < 64; i++) {
+            many[k]->lums[i] = (LUM){(uint8_t)(i < 10 && (k >> i & 1)), LUM_LINEAR, NULL, {(int)i, 0}};
+        }
+        ok = ok && lum_dedup_add(dedup, many[k]) == 0;
+    }
+    for (size_t k = 0; ok && k < MANY; k++) {
+        LUMGroup* probe = packed_from_dense(many[k]);
+        ok = probe && lum_dedup_find(dedup, probe) == many[k];
+        free_lum_group(probe);
+    }
+
+    lum_dedup_free(dedup);
+    for (size_t k = 0; k < MANY; k++) free_lum_group(many[k]);
+    free_lum_group(stored_written);
+    free_lum_group(stored);
+    free_lum_group(written);
+    free_lum_group(retyped);
+    free_lum_group(flowed);
+    free_lum_group(hybrid);
+    free_lum_group(packed);
+    free_lum_group(dense);
+
+    if (ok) {
+        printf("      ✅ Groupes retrouvés par hash puis comparaison complète\n");
+        return 1;
+    }
+    printf("      ❌ Index de déduplication incohérent\n");
+    return 0;
+}
+
+// ===== FONCTION PRINCIPALE =====
+int main() {
+    printf("=== VALIDATION STOCKAGE LUMGROUP ===\n\n");
+
+    int tests_passed = 0;
+    int total_tests = 29;
+
+    tests_passed += test_packed_encoding();
+    tests_passed += test_packed_operations();
+    tests_passed += test_simd_text_codec();
+    tests_passed += test_array_codec();
+    tests_passed += test_layout_descriptors();
+    tests_passed += test_compact_records();
+    tests_passed += test_soa_columns();
+    tests_passed += test_hybrid_containers();
+    tests_passed += test_streaming_decode();
+    tests_passed += test_streaming_encode();
+    tests_passed += test_zero_copy_views();
+    tests_passed += test_copy_on_write();
+    tests_passed += test_group_constructors();
+    tests_passed += test_small_groups();
+    tests_passed += test_arena_groups();
+    tests_passed += test_lazy_group_ids();
+    tests_passed += test_rng_streams();
+    tests_passed += test_inplace_operations();
+    tests_passed += test_fusion_many();
+    tests_passed += test_parallel_layouts();
+    tests_passed += test_contextual_split();
+    tests_passed += test_parallel_pool();
+    tests_passed += test_group_reductions();
+    tests_passed += test_lazy_pipeline();
+    tests_passed += test_batch_operations();
+    tests_passed += test_content_hash();
+    tests_passed += test_organic_fusion_storages();
+    tests_passed += test_codec_level_threads();
+    tests_passed += test_content_dedup();
+
+    printf("\n=== RÉSULTATS STOCKAGE ===\n");
+    printf("Tests réussis: %d/%d\n", tests_passed, total_tests);
+
+    return tests_passed == total_tests ? 0 : 1;
+}